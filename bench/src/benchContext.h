@@ -0,0 +1,73 @@
+#pragma once
+
+#include "data/tileSource.h"
+#include "gl.h"
+#include "log.h"
+#include "map.h"
+#include "mockPlatform.h"
+#include "scene/importer.h"
+#include "scene/scene.h"
+#include "scene/sceneLoader.h"
+#include "text/fontContext.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Scene and raw tile data shared by the tile benchmarks */
+struct BenchContext {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+
+    std::shared_ptr<Scene> scene;
+    std::shared_ptr<TileSource> source;
+    std::unique_ptr<TileBuilder> tileBuilder;
+
+    std::shared_ptr<std::vector<char>> rawTileData;
+
+    bool loadScene(const char* _sceneFile) {
+        Importer sceneImporter;
+        scene = std::make_shared<Scene>(platform, _sceneFile);
+
+        try {
+            scene->config() = sceneImporter.applySceneImports(platform, scene);
+        }
+        catch (YAML::ParserException e) {
+            LOGE("Parsing scene config '%s'", e.what());
+            return false;
+        }
+        SceneLoader::applyConfig(platform, scene);
+
+        scene->fontContext()->loadFonts();
+
+        source = *scene->tileSources().begin();
+        tileBuilder = std::make_unique<TileBuilder>(scene);
+        return true;
+    }
+
+    bool loadTile(const char* _path) {
+        std::ifstream resource(_path, std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read file at path: %s", _path);
+            return false;
+        }
+
+        rawTileData = std::make_shared<std::vector<char>>(resource.tellg());
+        resource.seekg(std::ifstream::beg);
+        resource.read(rawTileData->data(), rawTileData->size());
+        return true;
+    }
+
+    // Task of tile @_tileId of the source with the loaded tile data
+    std::shared_ptr<TileTask> createTask(TileID _tileId) {
+        auto task = source->createTask(_tileId);
+        static_cast<BinaryTileTask&>(*task).rawTileData = rawTileData;
+        return task;
+    }
+};
+
+}
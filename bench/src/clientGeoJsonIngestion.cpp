@@ -0,0 +1,97 @@
+#include "data/clientGeoJsonSource.h"
+#include "data/properties.h"
+#include "mockPlatform.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Building footprints of a large client-side data set
+#define NUM_FEATURES 20000
+#define RING_SIZE 16
+
+class ClientGeoJsonIngestionFixture : public benchmark::Fixture {
+public:
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+
+    // The same features as GeoJSON and as columns
+    std::string json;
+    std::vector<double> coordinates;
+    std::vector<uint32_t> lineEnds;
+    std::vector<uint32_t> featureEnds;
+    std::vector<double> heights;
+    std::vector<const char*> kinds;
+
+    void SetUp() override {
+        std::mt19937 random(0);
+        std::uniform_real_distribution<double> coordinate(-0.001, 0.001);
+
+        json = R"({"type":"FeatureCollection","features":[)";
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            double height = random() % 100;
+            heights.push_back(height);
+            kinds.push_back("building");
+
+            if (i > 0) { json += ","; }
+            json += R"({"type":"Feature","properties":{"kind":"building","height":)";
+            json += std::to_string(int(height));
+            json += R"(},"geometry":{"type":"Polygon","coordinates":[[)";
+            double x = -74.0 + i * 0.0001, y = 40.7;
+            for (int j = 0; j < RING_SIZE; j++) {
+                double lon = x + coordinate(random), lat = y + coordinate(random);
+                coordinates.push_back(lon);
+                coordinates.push_back(lat);
+
+                if (j > 0) { json += ","; }
+                json += "[" + std::to_string(lon) + "," + std::to_string(lat) + "]";
+            }
+            json += "]]}}";
+
+            lineEnds.push_back(coordinates.size() / 2);
+            featureEnds.push_back(i + 1);
+        }
+        json += "]}";
+    }
+    void TearDown() override {
+        json.clear();
+        coordinates.clear();
+        lineEnds.clear();
+        featureEnds.clear();
+        heights.clear();
+        kinds.clear();
+    }
+};
+
+BENCHMARK_DEFINE_F(ClientGeoJsonIngestionFixture, AddGeoJson)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        ClientGeoJsonSource source(platform, "bench", "");
+        source.addData(json);
+    }
+}
+BENCHMARK_REGISTER_F(ClientGeoJsonIngestionFixture, AddGeoJson);
+
+BENCHMARK_DEFINE_F(ClientGeoJsonIngestionFixture, AddColumns)(benchmark::State& st) {
+    ClientGeoJsonSource::FeatureColumns columns;
+    columns.type = ClientGeoJsonSource::FeatureColumns::Type::polygons;
+    columns.featureCount = NUM_FEATURES;
+    columns.coordinates = coordinates.data();
+    columns.lineEnds = lineEnds.data();
+    // One ring per polygon and one polygon per feature
+    columns.polygonEnds = featureEnds.data();
+    columns.featureEnds = featureEnds.data();
+    columns.numbers.push_back({ "height", heights.data() });
+    columns.strings.push_back({ "kind", kinds.data() });
+
+    while (st.KeepRunning()) {
+        ClientGeoJsonSource source(platform, "bench", "");
+        source.addFeatures(columns);
+    }
+}
+BENCHMARK_REGISTER_F(ClientGeoJsonIngestionFixture, AddColumns);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,80 @@
+#include "data/formats/geoJson.h"
+#include "util/json.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Building footprints of a large client-side data set
+#define NUM_FEATURES 20000
+#define RING_SIZE 16
+
+class GeoJsonParsingFixture : public benchmark::Fixture {
+public:
+    std::string json;
+
+    void SetUp() override {
+        std::mt19937 random(0);
+        std::uniform_real_distribution<double> coordinate(-0.001, 0.001);
+
+        json = R"({"type":"FeatureCollection","features":[)";
+        for (int i = 0; i < NUM_FEATURES; i++) {
+            if (i > 0) { json += ","; }
+            json += R"({"type":"Feature","properties":{"kind":"building","height":)";
+            json += std::to_string(random() % 100);
+            json += R"(},"geometry":{"type":"Polygon","coordinates":[[)";
+            double x = -74.0 + i * 0.0001, y = 40.7;
+            for (int j = 0; j < RING_SIZE; j++) {
+                if (j > 0) { json += ","; }
+                json += "[" + std::to_string(x + coordinate(random)) + "," +
+                    std::to_string(y + coordinate(random)) + "]";
+            }
+            json += "]]}}";
+        }
+        json += "]}";
+    }
+    void TearDown() override {
+        json.clear();
+    }
+};
+
+// Building the JSON document before reading features, as GeoJSON sources did
+BENCHMARK_DEFINE_F(GeoJsonParsingFixture, ParseDocument)(benchmark::State& st) {
+    size_t capacity = 0;
+    while (st.KeepRunning()) {
+        const char* error;
+        size_t offset;
+        auto document = JsonParseBytes(json.data(), json.size(), &error, &offset);
+        capacity = document.GetAllocator().Capacity();
+        benchmark::DoNotOptimize(document);
+    }
+    st.SetLabel("document bytes:" + std::to_string(capacity));
+}
+BENCHMARK_REGISTER_F(GeoJsonParsingFixture, ParseDocument);
+
+// Reading features while parsing, keeping only the current one
+BENCHMARK_DEFINE_F(GeoJsonParsingFixture, ReadFeatures)(benchmark::State& st) {
+    size_t peak = 0;
+    while (st.KeepRunning()) {
+        const char* error;
+        size_t offset;
+        size_t points = 0;
+        GeoJson::read(json.data(), json.size(), [](const std::string&) {},
+                      [&](GeoJson::FeatureData& _feature) {
+                          points += _feature.coordinates.size();
+                          peak = std::max(peak, _feature.coordinates.capacity() * sizeof(glm::dvec2));
+                          return true;
+                      },
+                      &error, &offset);
+        benchmark::DoNotOptimize(points);
+    }
+    st.SetLabel("feature bytes:" + std::to_string(peak));
+}
+BENCHMARK_REGISTER_F(GeoJsonParsingFixture, ReadFeatures);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+#include "benchContext.h"
+#include "data/formats/mvt.h"
+#include "tile/tile.h"
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+struct MvtContext : BenchContext {
+
+    std::shared_ptr<TileTask> task;
+
+    bool loadTile(const char* _path) {
+        if (!BenchContext::loadTile(_path)) { return false; }
+
+        task = createTask(TileID(0, 0, 10));
+        return true;
+    }
+
+    std::shared_ptr<TileData> parse(bool _lazyGeometry) {
+        return Mvt::parseTile(*task, *scene->mapProjection(), source->id(), _lazyGeometry);
+    }
+};
+
+class MvtDecodingFixture : public benchmark::Fixture {
+public:
+    MvtContext ctx;
+    bool ready = false;
+
+    std::shared_ptr<TileData> data;
+    std::shared_ptr<Tile> result;
+
+    void SetUp() override {
+        ready = ctx.loadScene("scene.yaml") && ctx.loadTile("tile.mvt");
+    }
+    void TearDown() override {
+        data.reset();
+        result.reset();
+    }
+};
+
+BENCHMARK_DEFINE_F(MvtDecodingFixture, ParseEager)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        data = ctx.parse(false);
+    }
+}
+BENCHMARK_REGISTER_F(MvtDecodingFixture, ParseEager);
+
+BENCHMARK_DEFINE_F(MvtDecodingFixture, ParseLazy)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        data = ctx.parse(true);
+    }
+}
+BENCHMARK_REGISTER_F(MvtDecodingFixture, ParseLazy);
+
+// Lazy parsing pays off when the geometry of features dropped by filters is never decoded
+BENCHMARK_DEFINE_F(MvtDecodingFixture, ParseAndBuildEager)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        data = ctx.parse(false);
+        result = ctx.tileBuilder->build(ctx.task->tileId(), *data, *ctx.source);
+    }
+}
+BENCHMARK_REGISTER_F(MvtDecodingFixture, ParseAndBuildEager);
+
+BENCHMARK_DEFINE_F(MvtDecodingFixture, ParseAndBuildLazy)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        data = ctx.parse(true);
+        result = ctx.tileBuilder->build(ctx.task->tileId(), *data, *ctx.source);
+    }
+}
+BENCHMARK_REGISTER_F(MvtDecodingFixture, ParseAndBuildLazy);
+
+BENCHMARK_MAIN();
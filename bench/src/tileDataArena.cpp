@@ -0,0 +1,95 @@
+#include "benchContext.h"
+#include "data/formats/mvt.h"
+#include "tile/tile.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Count heap allocations of the benchmark process
+static std::atomic<size_t> s_allocations{0};
+
+void* operator new(size_t _size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(_size ? _size : 1)) { return p; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* _p) noexcept { std::free(_p); }
+
+void operator delete(void* _p, size_t) noexcept { std::free(_p); }
+
+struct ArenaContext : BenchContext {
+
+    std::shared_ptr<TileTask> task;
+
+    bool loadTile(const char* _path) {
+        if (!BenchContext::loadTile(_path)) { return false; }
+
+        task = createTask(TileID(0, 0, 10));
+        return true;
+    }
+
+    std::shared_ptr<TileData> parse(bool _lazyGeometry, bool _useArena) {
+        return Mvt::parseTile(*task, *scene->mapProjection(), source->id(), _lazyGeometry, _useArena);
+    }
+};
+
+class TileDataArenaFixture : public benchmark::Fixture {
+public:
+    ArenaContext ctx;
+    bool ready = false;
+
+    void SetUp() override {
+        ready = ctx.loadScene("scene.yaml") && ctx.loadTile("tile.mvt");
+    }
+    void TearDown() override {}
+
+    // Parse, optionally build, and release the data of the tile like a TileTask does
+    void run(benchmark::State& _st, bool _lazyGeometry, bool _useArena, bool _build) {
+        size_t allocations = 0;
+
+        while (ready && _st.KeepRunning()) {
+            size_t start = s_allocations.load(std::memory_order_relaxed);
+
+            auto data = ctx.parse(_lazyGeometry, _useArena);
+            if (_build) {
+                auto tile = ctx.tileBuilder->build(ctx.task->tileId(), *data, *ctx.source);
+            }
+            data.reset();
+
+            allocations += s_allocations.load(std::memory_order_relaxed) - start;
+        }
+        if (_st.iterations() > 0) {
+            _st.SetLabel("allocations:" + std::to_string(allocations / _st.iterations()));
+        }
+    }
+};
+
+BENCHMARK_DEFINE_F(TileDataArenaFixture, ParseEagerHeap)(benchmark::State& st) {
+    run(st, false, false, false);
+}
+BENCHMARK_REGISTER_F(TileDataArenaFixture, ParseEagerHeap);
+
+BENCHMARK_DEFINE_F(TileDataArenaFixture, ParseEagerArena)(benchmark::State& st) {
+    run(st, false, true, false);
+}
+BENCHMARK_REGISTER_F(TileDataArenaFixture, ParseEagerArena);
+
+BENCHMARK_DEFINE_F(TileDataArenaFixture, ParseAndBuildLazyHeap)(benchmark::State& st) {
+    run(st, true, false, true);
+}
+BENCHMARK_REGISTER_F(TileDataArenaFixture, ParseAndBuildLazyHeap);
+
+BENCHMARK_DEFINE_F(TileDataArenaFixture, ParseAndBuildLazyArena)(benchmark::State& st) {
+    run(st, true, true, true);
+}
+BENCHMARK_REGISTER_F(TileDataArenaFixture, ParseAndBuildLazyArena);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+#include "benchContext.h"
+#include "tile/tileDiskCache.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Tiles of the first view, all built from the same data
+#define NUM_TILES 16
+
+// Any value: The benchmark only uses one scene
+#define SCENE_HASH 1
+
+struct StartupContext : BenchContext {
+
+    std::shared_ptr<TileDiskCache> diskCache;
+
+    void createDiskCache() {
+        char path[] = "/tmp/tangramBenchXXXXXX";
+        if (!mkdtemp(path)) {
+            LOGE("Failed to create cache directory");
+            return;
+        }
+        diskCache = std::make_shared<TileDiskCache>(path, 256 * 1024 * 1024);
+    }
+
+    // Process the tasks of the first view as a TileWorker does
+    void buildTiles(bool _useDiskCache) {
+        for (int i = 0; i < NUM_TILES; i++) {
+            TileID tileId(i % 4, i / 4, 10);
+            auto task = createTask(tileId);
+
+            if (_useDiskCache && task->restore(diskCache, *scene, SCENE_HASH)) {
+                continue;
+            }
+
+            if (task->parse(*scene->mapProjection())) {
+                task->build(*tileBuilder);
+            }
+
+            if (!task->tile()) { LOGE("Failed to build tile %s", tileId.toString().c_str()); }
+        }
+    }
+};
+
+class TileDiskCacheFixture : public benchmark::Fixture {
+public:
+    StartupContext ctx;
+    bool ready = false;
+
+    void SetUp() override {
+        ready = ctx.loadScene("scene.yaml") && ctx.loadTile("tile.mvt");
+        if (ready) { ctx.createDiskCache(); }
+        ready &= ctx.diskCache && ctx.diskCache->isValid();
+    }
+    void TearDown() override {
+        if (ctx.diskCache) {
+            ctx.diskCache->clear();
+            ctx.diskCache->flush();
+        }
+    }
+};
+
+// Baseline without disk cache
+BENCHMARK_DEFINE_F(TileDiskCacheFixture, NoCache)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        ctx.buildTiles(false);
+    }
+}
+BENCHMARK_REGISTER_F(TileDiskCacheFixture, NoCache);
+
+// First start: All tiles miss and are written to the cache
+BENCHMARK_DEFINE_F(TileDiskCacheFixture, ColdStart)(benchmark::State& st) {
+    while (ready && st.KeepRunning()) {
+        st.PauseTiming();
+        ctx.diskCache->clear();
+        ctx.diskCache->flush();
+        st.ResumeTiming();
+
+        ctx.buildTiles(true);
+
+        // Entries are written on the background thread
+        st.PauseTiming();
+        ctx.diskCache->flush();
+        st.ResumeTiming();
+    }
+}
+BENCHMARK_REGISTER_F(TileDiskCacheFixture, ColdStart);
+
+// Next start: All tiles are restored, only labels are built again
+BENCHMARK_DEFINE_F(TileDiskCacheFixture, WarmStart)(benchmark::State& st) {
+    if (ready) {
+        ctx.buildTiles(true);
+        ctx.diskCache->flush();
+    }
+    while (ready && st.KeepRunning()) {
+        ctx.buildTiles(true);
+    }
+
+    // Hits of tiles with labels are parsed again
+    if (ready) {
+        auto stats = ctx.diskCache->stats();
+        st.SetLabel("hits:" + std::to_string(stats.hits) +
+                    " label hits:" + std::to_string(stats.labelHits));
+    }
+}
+BENCHMARK_REGISTER_F(TileDiskCacheFixture, WarmStart);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "tile/tile.h"
+#include "tile/tileManager.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+MercatorProjection s_projection;
+
+// Builds tiles immediately, so that only the TileManager bookkeeping is measured
+struct BenchTileWorker : TileTaskQueue {
+    void enqueue(std::shared_ptr<TileTask> _task) override {
+        _task->tile() = std::make_shared<Tile>(_task->tileId(), s_projection, &_task->source());
+    }
+};
+
+struct BenchTileSource : TileSource {
+    class Task : public TileTask {
+    public:
+        Task(TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask)
+            : TileTask(_tileId, _source, _subTask) {}
+
+        bool hasData() const override { return true; }
+    };
+
+    BenchTileSource(const std::string& _name) : TileSource(_name, nullptr) {
+        m_generateGeometry = true;
+    }
+
+    void loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        _task->startedLoading();
+        _cb.func(std::move(_task));
+    }
+
+    void cancelLoadingTile(const TileID& _tile) override {}
+
+    void clearData() override {}
+
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
+        return std::make_shared<Task>(_tileId, shared_from_this(), _subTask);
+    }
+};
+
+// range(0): Number of TileSources, range(1): Pan the view on each frame
+static void BM_Tangram_UpdateTileSets(benchmark::State& st) {
+
+    const int numSources = st.range(0);
+    const bool pan = st.range(1);
+
+    BenchTileWorker worker;
+    TileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    std::vector<std::shared_ptr<TileSource>> sources;
+    for (int i = 0; i < numSources; i++) {
+        sources.push_back(std::make_shared<BenchTileSource>("source" + std::to_string(i)));
+    }
+    tileManager.setTileSources(sources);
+
+    // About 70 visible tiles per source
+    View view(2048, 2048);
+    view.setZoom(16);
+    view.update();
+
+    // Load all visible tiles before measuring
+    for (int i = 0; i < 4; i++) {
+        tileManager.updateTileSets(view);
+    }
+
+    double step = 2 * MapProjection::HALF_CIRCUMFERENCE * exp2(-16) / 8;
+
+    size_t tracked = 0;
+
+    while (st.KeepRunning()) {
+        if (pan) {
+            view.translate(step, step / 2);
+        }
+        view.update();
+
+        tileManager.updateTileSets(view);
+
+        tracked = 0;
+        for (auto& tileSet : tileManager.getTileSets()) {
+            tracked += tileSet.tiles.size();
+        }
+    }
+
+    st.SetLabel("tracked tiles:" + std::to_string(tracked));
+}
+BENCHMARK(BM_Tangram_UpdateTileSets)
+    ->Args({1, 1})->Args({8, 0})->Args({8, 1})->Args({32, 0})->Args({32, 1});
+
+BENCHMARK_MAIN();
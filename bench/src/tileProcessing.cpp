@@ -0,0 +1,84 @@
+#include "benchContext.h"
+#include "tile/tile.h"
+
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+class TileProcessingFixture : public benchmark::Fixture {
+public:
+    BenchContext ctx;
+    bool ready = false;
+
+    void SetUp() override {
+        ready = ctx.loadScene("scene.yaml") && ctx.loadTile("tile.mvt");
+    }
+    void TearDown() override {}
+
+    // Parse and build the tile like a TileTask does, clipped with a buffer of
+    // @_clipBuffer and simplified with a tolerance of @_pixels
+    void run(benchmark::State& _st, float _clipBuffer, float _pixels) {
+        size_t points = 0;
+        size_t meshBytes = 0;
+
+        // A low zoom tile, below the maximum zoom of the source
+        TileID tileId(0, 0, 10);
+        ctx.source->setClipBuffer(_clipBuffer);
+        ctx.source->setSimplification(_pixels);
+
+        while (ready && _st.KeepRunning()) {
+            auto task = ctx.createTask(tileId);
+
+            if (task->parse(*ctx.scene->mapProjection())) {
+                task->build(*ctx.tileBuilder);
+            }
+
+            if (task->tile()) { meshBytes = task->tile()->getMemoryUsage(); }
+        }
+
+        // Points of the geometry after clipping and simplification
+        if (ready) {
+            auto task = ctx.createTask(tileId);
+            auto data = ctx.source->parse(*task, *ctx.scene->mapProjection());
+            ctx.source->processTileData(*task, *data);
+
+            for (auto& layer : data->layers) {
+                for (auto& feature : layer.features) {
+                    feature.decodeGeometry();
+                    points += feature.points.size();
+                }
+            }
+        }
+        _st.SetLabel("points:" + std::to_string(points) + " tile bytes:" + std::to_string(meshBytes));
+    }
+};
+
+BENCHMARK_DEFINE_F(TileProcessingFixture, BuildFullDetail)(benchmark::State& st) {
+    run(st, -1.f, 0.f);
+}
+BENCHMARK_REGISTER_F(TileProcessingFixture, BuildFullDetail);
+
+BENCHMARK_DEFINE_F(TileProcessingFixture, BuildSimplifiedHalfPixel)(benchmark::State& st) {
+    run(st, -1.f, 0.5f);
+}
+BENCHMARK_REGISTER_F(TileProcessingFixture, BuildSimplifiedHalfPixel);
+
+BENCHMARK_DEFINE_F(TileProcessingFixture, BuildSimplifiedOnePixel)(benchmark::State& st) {
+    run(st, -1.f, 1.f);
+}
+BENCHMARK_REGISTER_F(TileProcessingFixture, BuildSimplifiedOnePixel);
+
+BENCHMARK_DEFINE_F(TileProcessingFixture, BuildClipped)(benchmark::State& st) {
+    run(st, 16.f, 0.f);
+}
+BENCHMARK_REGISTER_F(TileProcessingFixture, BuildClipped);
+
+BENCHMARK_DEFINE_F(TileProcessingFixture, BuildClippedSimplified)(benchmark::State& st) {
+    run(st, 16.f, 0.5f);
+}
+BENCHMARK_REGISTER_F(TileProcessingFixture, BuildClippedSimplified);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+#include "tile/tileTaskScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+using Clock = std::chrono::steady_clock;
+
+// Number of tasks queued per iteration, roughly what a fast pan produces
+const int TASKS_PER_BATCH = 512;
+
+struct BenchTask : public TileTask {
+    BenchTask(TileID& _tileId, std::shared_ptr<TileSource> _source)
+        : TileTask(_tileId, _source, -1) {}
+
+    Clock::time_point queued;
+};
+
+static void BM_Tangram_TileTaskScheduler(benchmark::State& st) {
+
+    const size_t numWorkers = st.range(0);
+
+    auto source = std::make_shared<TileSource>("bench", nullptr);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> priority(0.f, 1000.f);
+
+    std::vector<std::shared_ptr<BenchTask>> tasks;
+    for (int i = 0; i < TASKS_PER_BATCH; i++) {
+        TileID id(i % 64, i / 64, 16);
+        tasks.push_back(std::make_shared<BenchTask>(id, source));
+        tasks.back()->setPriority(priority(rng));
+    }
+
+    TileTaskScheduler scheduler(numWorkers);
+
+    std::atomic<int> processed(0);
+    std::vector<std::vector<float>> latencies(numWorkers);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < numWorkers; i++) {
+        workers.emplace_back([&, i]() {
+            while (auto task = scheduler.pop(i)) {
+                auto& t = static_cast<BenchTask&>(*task);
+                auto wait = std::chrono::duration<float, std::micro>(Clock::now() - t.queued);
+                latencies[i].push_back(wait.count());
+                processed++;
+            }
+        });
+    }
+
+    while (st.KeepRunning()) {
+        processed = 0;
+
+        for (auto& task : tasks) {
+            task->queued = Clock::now();
+            scheduler.push(task);
+        }
+
+        while (processed < TASKS_PER_BATCH) {
+            std::this_thread::yield();
+        }
+    }
+
+    scheduler.stop();
+    for (auto& worker : workers) { worker.join(); }
+
+    std::vector<float> all;
+    for (auto& l : latencies) { all.insert(all.end(), l.begin(), l.end()); }
+    std::sort(all.begin(), all.end());
+
+    if (!all.empty()) {
+        auto p50 = all[all.size() / 2];
+        auto p99 = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+        st.SetLabel("latency p50:" + std::to_string(int(p50)) +
+                    "us p99:" + std::to_string(int(p99)) + "us");
+    }
+
+    st.SetItemsProcessed(st.iterations() * TASKS_PER_BATCH);
+}
+BENCHMARK(BM_Tangram_TileTaskScheduler)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+BENCHMARK_MAIN();
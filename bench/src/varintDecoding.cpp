@@ -0,0 +1,90 @@
+#include "data/formats/mvt.h"
+#include "util/varint.h"
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Rings of building and landuse polygons
+#define NUM_RINGS 1000
+#define RING_SIZE 64
+
+static void putVarint(std::vector<char>& _data, uint32_t _value) {
+    while (_value >= 0x80) {
+        _data.push_back(char((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _data.push_back(char(_value));
+}
+
+static uint32_t zigzag(int32_t _value) { return (_value << 1) ^ (_value >> 31); }
+
+class VarintDecodingFixture : public benchmark::Fixture {
+public:
+    std::vector<char> geometry;
+    std::vector<uint32_t> values;
+    Mvt::ParserContext ctx{0};
+    Mvt::Geometry result;
+
+    void SetUp() override {
+        std::mt19937 random(0);
+        ctx.tileExtent = 4096;
+
+        // Mostly single byte deltas, as in detailed geometry at high zoom
+        auto delta = [&]() {
+            return zigzag(random() % 8 == 0 ? int32_t(random() % 512) - 256 : int32_t(random() % 64) - 32);
+        };
+
+        for (int i = 0; i < NUM_RINGS; i++) {
+            putVarint(geometry, 1 | (1 << 3));
+            putVarint(geometry, delta());
+            putVarint(geometry, delta());
+            putVarint(geometry, 2 | ((RING_SIZE - 1) << 3));
+            for (int j = 0; j < 2 * (RING_SIZE - 1); j++) { putVarint(geometry, delta()); }
+            putVarint(geometry, 7 | (1 << 3));
+        }
+    }
+    void TearDown() override {
+        geometry.clear();
+        values.clear();
+    }
+
+    const uint8_t* begin() { return reinterpret_cast<const uint8_t*>(geometry.data()); }
+    const uint8_t* end() { return begin() + geometry.size(); }
+};
+
+BENCHMARK_DEFINE_F(VarintDecodingFixture, DecodeScalar)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        values.clear();
+        Varint::decodeScalar(begin(), end(), values);
+    }
+}
+BENCHMARK_REGISTER_F(VarintDecodingFixture, DecodeScalar);
+
+BENCHMARK_DEFINE_F(VarintDecodingFixture, DecodeBulk)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        values.clear();
+        Varint::decode(begin(), end(), values);
+    }
+}
+BENCHMARK_REGISTER_F(VarintDecodingFixture, DecodeBulk);
+
+BENCHMARK_DEFINE_F(VarintDecodingFixture, GeometryScalar)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        result = Mvt::getGeometryScalar(ctx, protobuf::message(geometry.data(), geometry.size()));
+    }
+}
+BENCHMARK_REGISTER_F(VarintDecodingFixture, GeometryScalar);
+
+BENCHMARK_DEFINE_F(VarintDecodingFixture, GeometryBulk)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        result = Mvt::getGeometry(ctx, protobuf::message(geometry.data(), geometry.size()));
+    }
+}
+BENCHMARK_REGISTER_F(VarintDecodingFixture, GeometryBulk);
+
+BENCHMARK_MAIN();
@@ -3,11 +3,14 @@
 #include "data/tileSource.h"
 #include "util/types.h"
 
+#include <atomic>
+#include <functional>
 #include <mutex>
 
 
 namespace Tangram {
 
+class AsyncWorker;
 class Platform;
 
 struct Properties;
@@ -28,10 +31,76 @@ public:
 
     // Add geometry from a GeoJSON string
     void addData(const std::string& _data);
-    void addPoint(const Properties& _tags, LngLat _point);
-    void addLine(const Properties& _tags, const Coordinates& _line);
-    void addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly);
-    void generateLabelCentroidFeature();
+
+    // Add geometry from a GeoJSON string like addData(). A feature with a numeric
+    // "id" replaces the feature of a previous call with that "id", or removes it
+    // when its geometry is empty. These "id"s are not the IDs of the functions below.
+    void upsertData(const std::string& _data);
+
+    using AddDataCallback = std::function<void(bool _success, int64_t _generation)>;
+
+    // Add geometry from a GeoJSON string like addData(), reading and indexing
+    // it on a background thread. Tiles are built from the current data until
+    // all features are added at once. @_callback is called from that thread
+    // with the source generation that includes the features
+    void addDataAsync(std::string _data, AddDataCallback _callback = nullptr);
+
+    // Like addDataAsync(), replacing features by their "id" like upsertData()
+    void upsertDataAsync(std::string _data, AddDataCallback _callback = nullptr);
+
+    // Add a feature with a new ID and return the ID
+    uint64_t addPoint(const Properties& _tags, LngLat _point);
+    uint64_t addLine(const Properties& _tags, const Coordinates& _line);
+    uint64_t addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly);
+
+    // Add the feature @_id or replace its geometry and properties
+    void upsertPoint(uint64_t _id, const Properties& _tags, LngLat _point);
+    void upsertLine(uint64_t _id, const Properties& _tags, const Coordinates& _line);
+    void upsertPoly(uint64_t _id, const Properties& _tags, const std::vector<Coordinates>& _poly);
+
+    /* Features of one geometry type in flat arrays, as they are stored by
+     * columnar data sources. Ranges are given by the end of each element,
+     * the begin being the end of the previous one. */
+    struct FeatureColumns {
+
+        enum class Type { points, lines, polygons };
+
+        struct NumberColumn {
+            std::string name;
+            // One value per feature, NaN for none
+            const double* values;
+        };
+        struct StringColumn {
+            std::string name;
+            // One value per feature, nullptr for none
+            const char* const* values;
+        };
+
+        Type type = Type::points;
+        size_t featureCount = 0;
+
+        // Longitude and latitude of each point
+        const double* coordinates = nullptr;
+        // End of each feature in points, lines or polygons, depending on type
+        const uint32_t* featureEnds = nullptr;
+        // End of each line or polygon ring in points
+        const uint32_t* lineEnds = nullptr;
+        // End of each polygon in rings
+        const uint32_t* polygonEnds = nullptr;
+
+        // Properties of the features, with distinct names
+        std::vector<NumberColumn> numbers;
+        std::vector<StringColumn> strings;
+    };
+
+    // Add the features of @_columns with consecutive new IDs and return the first ID
+    uint64_t addFeatures(const FeatureColumns& _columns);
+
+    // Add or replace the features of @_columns with the IDs in @_ids
+    void upsertFeatures(const uint64_t* _ids, const FeatureColumns& _columns);
+
+    // Remove the feature @_id. Returns false when there is no such feature
+    bool removeFeature(uint64_t _id);
 
     virtual void loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override;
     std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override;
@@ -39,19 +108,32 @@ public:
     virtual void cancelLoadingTile(const TileID& _tile) override {};
     virtual void clearData() override;
 
+    // Only tiles that intersect updated features get a new generation
+    virtual int64_t generation(const TileID& _tile) const override;
+    using TileSource::generation;
+
+    virtual void pruneChanges(int64_t _generation) override;
+
 protected:
 
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
+    // Add the features of GeoJSON @_data, replacing features by their "id" with @_upsert
+    void applyData(const std::string& _data, bool _upsert);
+    void applyDataAsync(std::string _data, AddDataCallback _callback, bool _upsert);
+
     std::unique_ptr<ClientGeoJsonData> m_store;
 
     mutable std::mutex m_mutexStore;
-    bool m_hasPendingData = false;
+    std::atomic<bool> m_hasPendingData{false};
     bool m_generateCentroids = false;
 
     std::shared_ptr<Platform> m_platform;
 
+    // Reads and indexes data of addDataAsync()
+    std::unique_ptr<AsyncWorker> m_worker;
+
 };
 
 }
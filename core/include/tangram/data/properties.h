@@ -7,6 +7,7 @@ namespace Tangram {
 
 class Value;
 struct PropertyItem;
+class PropertyKey;
 
 // Helper to cleanup double string values from trailing 0s
 std::string doubleToString(double _doubleValue);
@@ -25,12 +26,17 @@ struct Properties {
 
     const Value& get(const std::string& key) const;
 
+    // Finds the item by comparing interned keys
+    const Value& get(const PropertyKey& key) const;
+
     void sort();
 
     void clear();
 
     bool contains(const std::string& key) const;
 
+    bool contains(const PropertyKey& key) const;
+
     bool getNumber(const std::string& key, double& value) const;
 
     double getNumber(const std::string& key) const;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+namespace Tangram {
+
+/* Interned name of a feature property
+ *
+ * Each distinct name is stored once in a global table that is never shrunk, so
+ * PropertyKeys are copied as a pointer and compared by identity instead of by
+ * comparing strings. Keys of filters are interned when a scene is loaded and
+ * keys of MVT layers once per layer, so matching a filter against the properties
+ * of a feature does not compare any strings.
+ *
+ * The table holds each name that was ever used, so its size is bounded by the
+ * number of distinct names rather than by the amount of data. Data with
+ * generated property names grows it for the lifetime of the process, see
+ * internedCount(). Parsers intern through a PropertyKeyCache, which locks the
+ * table once per distinct name and parse.
+ */
+class PropertyKey {
+public:
+    PropertyKey();
+    explicit PropertyKey(const std::string& _name);
+    explicit PropertyKey(const char* _name) : PropertyKey(std::string(_name)) {}
+
+    const std::string& str() const { return *m_name; }
+    const char* c_str() const { return m_name->c_str(); }
+    size_t size() const { return m_name->size(); }
+    bool empty() const { return m_name->empty(); }
+
+    operator const std::string&() const { return *m_name; }
+
+    bool operator==(const PropertyKey& _rhs) const { return m_name == _rhs.m_name; }
+    bool operator!=(const PropertyKey& _rhs) const { return m_name != _rhs.m_name; }
+    bool operator==(const std::string& _rhs) const { return *m_name == _rhs; }
+    bool operator!=(const std::string& _rhs) const { return *m_name != _rhs; }
+
+    /* Number of distinct keys interned so far */
+    static size_t internedCount();
+
+private:
+    const std::string* m_name;
+};
+
+/* Keys interned by one parser: Names are looked up in the global table once,
+ * instead of once per property of each feature. Not thread-safe. */
+class PropertyKeyCache {
+public:
+    PropertyKey get(const std::string& _name);
+
+private:
+    std::unordered_map<std::string, PropertyKey> m_keys;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "tile/tileTask.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -16,6 +17,7 @@ struct Raster;
 class Tile;
 class TileManager;
 struct RawCache;
+struct TileDataCache;
 class Texture;
 
 class TileSource : public std::enable_shared_from_this<TileSource> {
@@ -51,6 +53,24 @@ public:
      */
     static int32_t zoomBiasFromTileSize(int32_t tileSize);
 
+    /* Counters of the in-memory caches of raw tile data */
+    struct RawCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+        // Bytes held by the cached data, and their size when inflated. The latter
+        // is estimated for data that was delivered compressed.
+        size_t usage = 0;
+        size_t inflatedUsage = 0;
+
+        float hitRate() const {
+            return hits + misses > 0 ? float(hits) / (hits + misses) : 0.f;
+        }
+        float entriesPerMB() const {
+            return usage > 0 ? entries / (float(usage) / (1024 * 1024)) : 0.f;
+        }
+    };
+
     struct DataSource {
         virtual ~DataSource() {}
 
@@ -63,6 +83,15 @@ public:
 
         virtual void clear() { if (next) next->clear(); }
 
+        /* Drops cached data that is loaded again on demand.
+         * Returns the number of bytes released */
+        virtual size_t releaseCache() { return next ? next->releaseCache() : 0; }
+
+        /* Adds the counters of the caches in this chain to @_stats */
+        virtual void cacheStats(RawCacheStats& _stats) const {
+            if (next) { next->cacheStats(_stats); }
+        }
+
         void setNext(std::unique_ptr<DataSource> _next) {
             next = std::move(_next);
             next->level = level + 1;
@@ -109,6 +138,48 @@ public:
     /* Clears all data associated with this TileSource */
     virtual void clearData();
 
+    /* Keep the parsed data of the @_maxTiles most recently parsed tiles.
+     * Overzoomed tiles are then built from the data of their data tile without
+     * loading and parsing it again. Tiles of which an ancestor within three
+     * zoom levels is kept are built provisionally from the ancestor's data,
+     * sliced on a worker, while their own data is loaded.
+     * 0 disables slicing (default).
+     */
+    void setTileDataSlicing(size_t _maxTiles);
+
+    /* running on worker thread: Keeps @_data parsed for @_task when slicing is enabled */
+    void cacheTileData(const TileTask& _task, std::shared_ptr<TileData> _data);
+
+    /* Clip the geometry of parsed tiles to the tile plus a buffer of @_pixels
+     * at the tile size of the source, so that geometry outside of it is not
+     * built. Negative values disable clipping (default).
+     */
+    void setClipBuffer(float _pixels);
+    float clipBuffer() const { return m_clipBuffer; }
+
+    /* Simplify the lines and polygons of parsed tiles, removing detail smaller
+     * than @_pixels at the zoom the tiles are drawn. Tiles at the maximum zoom
+     * of the source keep all detail, as their data is drawn at higher zooms as
+     * well. 0 disables simplification (default).
+     */
+    void setSimplification(float _pixels);
+    float simplification() const { return m_simplification; }
+
+    /* running on worker thread: Clips and simplifies @_data parsed for @_task when enabled */
+    void processTileData(const TileTask& _task, TileData& _data) const;
+
+    /* Release memory of data that is loaded, parsed or decoded again on demand.
+     * Unlike clearData() these keep the generation, so that current tiles stay
+     * valid. Each returns the number of bytes released, including those of
+     * attached raster sources.
+     */
+    size_t releaseRawData();
+    size_t releaseTileData();
+    virtual size_t releaseRasters();
+
+    /* Counters of the raw data caches of this source */
+    RawCacheStats rawCacheStats() const;
+
     const std::string& name() const { return m_name; }
 
     virtual void clearRasters();
@@ -122,6 +193,16 @@ public:
     /* Generation ID of TileSource state (incremented for each update, e.g. on clearData()) */
     int64_t generation() const { return m_generation; }
 
+    /* Generation of the last update that changed the data of @_tile. Tiles
+     * built from an older generation are reloaded. Sources that track their
+     * changes return less than generation() for tiles that were not affected */
+    virtual int64_t generation(const TileID& _tile) const { return m_generation; }
+
+    /* Called with the oldest generation of the tiles of this source that are
+     * loaded, cached or being built: Sources that track their changes can
+     * forget the changes up to it */
+    virtual void pruneChanges(int64_t _generation) {}
+
     const ZoomOptions& zoomOptions() { return m_zoomOptions; }
     int32_t minDisplayZoom() const { return m_zoomOptions.minDisplayZoom; }
     int32_t maxDisplayZoom() const { return m_zoomOptions.maxDisplayZoom; }
@@ -150,6 +231,10 @@ protected:
 
     void createSubTasks(std::shared_ptr<TileTask> _task);
 
+    /* Sets the kept data of the tile of @_task or of its closest ancestor as
+     * parent data of @_task. Returns false when no such data is kept. */
+    bool loadSlicedTileData(TileTask& _task);
+
     // This datasource is used to generate actual tile geometry
     bool m_generateGeometry = false;
 
@@ -162,8 +247,9 @@ protected:
     // Unique id for TileSource
     int32_t m_id;
 
-    // Generation of dynamic TileSource state (incremented for each update)
-    int64_t m_generation = 1;
+    // Generation of dynamic TileSource state (incremented for each update).
+    // Atomic since updates may be applied on a worker thread
+    std::atomic<int64_t> m_generation{1};
 
     Format m_format = Format::GeoJson;
 
@@ -171,6 +257,15 @@ protected:
     std::vector<std::shared_ptr<TileSource>> m_rasterSources;
 
     std::unique_ptr<DataSource> m_sources;
+
+    /* Clip buffer in pixels, see setClipBuffer(). Read by worker threads */
+    std::atomic<float> m_clipBuffer{-1.f};
+
+    /* Simplification tolerance in pixels, see setSimplification(). Read by worker threads */
+    std::atomic<float> m_simplification{0.f};
+
+    /* Parsed data of recent tiles, for slicing */
+    std::unique_ptr<TileDataCache> m_tileDataCache;
 };
 
 }
@@ -78,6 +78,59 @@ struct SceneError {
     Error error;
 };
 
+struct CameraKeyframe {
+    LngLat position;
+    float zoom = 0;
+    // Seconds from now until the camera reaches this keyframe
+    float time = 0;
+};
+
+struct TileCacheStats {
+    // Data source name, empty for the totals of all sources
+    std::string source;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t memoryUsage = 0;
+    size_t tiles = 0;
+};
+
+struct RawCacheStats {
+    // Data source name
+    std::string source;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t entries = 0;
+    // Bytes held by the cached tile data, and its size when inflated
+    // (estimated for data that was delivered compressed)
+    size_t memoryUsage = 0;
+    size_t inflatedUsage = 0;
+    float hitRate = 0;
+    float entriesPerMB = 0;
+};
+
+enum class MemoryWarningLevel : char {
+    // Release cached data that is built or decoded again from data in memory
+    moderate = 0,
+    // Also release data that has to be loaded again, e.g. from the network
+    critical,
+};
+
+struct MemoryReleaseStats {
+    // Name of the subsystem that released memory
+    std::string subsystem;
+    size_t bytes = 0;
+};
+
+// Number of threads of the two stages that load tiles
+struct TileWorkerOptions {
+    // Threads that decode the data of tiles, 0 for one thread per CPU core
+    // that is not taken by the build workers
+    int parseWorkers = 0;
+    // Threads that style the decoded data and build the tile meshes, at least one
+    int buildWorkers = 2;
+};
+
 using SceneID = int32_t;
 
 // Function type for a sceneReady callback
@@ -96,6 +149,10 @@ public:
 
     // Create an empty map object. To display a map, call either loadScene() or loadSceneAsync().
     Map(std::shared_ptr<Platform> _platform);
+
+    // Create an empty map object that loads tiles with the threads set by _tileWorkers
+    Map(std::shared_ptr<Platform> _platform, TileWorkerOptions _tileWorkers);
+
     ~Map();
 
     // Load the scene at the given absolute file path asynchronously.
@@ -185,6 +242,20 @@ public:
     // Get the fractional zoom level of the view
     float getZoom();
 
+    // Ease position and zoom of the view to the given values over the duration (in seconds)
+    // and load the tiles along the way ahead of time, as with prefetchCameraPath()
+    void flyTo(double _lon, double _lat, float _zoom, float _duration, EaseType _e = EaseType::quint);
+
+    // Load the tiles visible along the path of a scripted camera animation ahead of time;
+    // tiles are requested in the order in which the keyframes reach them. The prefetch is
+    // dropped when the path ends, when it is replaced by another path and when the camera
+    // is moved otherwise: by any of the position, zoom, rotation and tilt setters, eased
+    // or not, or by a gesture
+    void prefetchCameraPath(const std::vector<CameraKeyframe>& _keyframes);
+
+    // Drop the tiles of the current camera path that were not loaded yet
+    void cancelCameraPathPrefetch();
+
     // Set the counter-clockwise rotation of the view in radians; 0 corresponds to
     // North pointing up; if duration (in seconds) is provided, rotation eases to the
     // the set value over the duration; calling either version of the setter overrides
@@ -320,6 +391,30 @@ public:
     // Set the radius in logical pixels to use when picking features on the map (default is 0.5).
     void setPickRadius(float _radius);
 
+    // Set the number of additional threads per tile worker used to style the data layers of large
+    // tiles in parallel; uses more memory and one JavaScript context per thread (0 by default)
+    void setTileStyleWorkers(int _workers);
+
+    // Load tiles ahead that are predicted to become visible within _seconds from the current pan
+    // and zoom velocity, with at most _budget prefetched tiles loading per source (disabled by default)
+    void setTilePrefetch(float _seconds, int _budget);
+
+    // Limit the memory used by cached tiles of the data source with name _source to _bytes,
+    // 0 for no limit. Tiles of a source over its limit are evicted before tiles of other sources.
+    void setTileCacheQuota(const std::string& _source, size_t _bytes);
+
+    // Get the tile cache counters: The first entry holds the totals of all sources,
+    // followed by one entry for each source that has used the cache
+    std::vector<TileCacheStats> getTileCacheStats();
+
+    // Get the counters of the in-memory caches of raw tile data, with one entry
+    // for each data source of the scene
+    std::vector<RawCacheStats> getRawCacheStats();
+
+    // Keep built tiles in the directory _path, using at most _maxBytes, so that tiles loaded again
+    // with the same data and scene are not parsed and styled again; an empty _path disables it
+    void setTileDiskCache(const std::string& _path, size_t _maxBytes);
+
     // Create a query to select a feature marked as 'interactive'. The query runs on the next frame.
     // Calls _onFeaturePickCallback once the query has completed, and returns the FeaturePickResult
     // with its associated properties or null if no feature was found.
@@ -339,8 +434,10 @@ public:
     // Run this task asynchronously to Tangram's main update loop.
     void runAsyncTask(std::function<void()> _task);
 
-    // Send a signal to Tangram that the platform received a memory warning
-    void onMemoryWarning();
+    // Send a signal to Tangram that the platform received a memory warning. Caches are released
+    // in order of their cost to rebuild, up to _level, while tiles and labels in view are kept.
+    // Returns the bytes released by each subsystem, in the order they were released.
+    std::vector<MemoryReleaseStats> onMemoryWarning(MemoryWarningLevel _level = MemoryWarningLevel::critical);
 
     // Sets an opaque default background color used as default color when a scene is being loaded
     // r, g, b must be between 0.0 and 1.0
@@ -11,14 +11,19 @@ namespace Tangram {
 
 class TileManager;
 class TileBuilder;
+class TileBundle;
+class TileDiskCache;
 class TileSource;
 class Tile;
 class MapProjection;
+class Scene;
 struct TileData;
 
 
 class TileTask {
 
+    friend class TileTaskHeap;
+
 public:
 
     TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask);
@@ -40,6 +45,7 @@ public:
     std::shared_ptr<Tile>& tile() { return m_tile; }
 
     TileSource& source() { return *m_source; }
+    const TileSource& source() const { return *m_source; }
     int64_t sourceGeneration() const { return m_sourceGeneration; }
 
     TileID tileId() const { return m_tileId; }
@@ -47,6 +53,9 @@ public:
     void cancel() { m_canceled = true; }
     bool isCanceled() const { return m_canceled; }
 
+    // Polled by parse and build stages to stop work on canceled tasks early
+    const std::atomic<bool>& canceledFlag() const { return m_canceled; }
+
     double getPriority() const {
         return m_priority.load();
     }
@@ -62,8 +71,18 @@ public:
     int subTaskId() const { return m_subTaskId; }
     bool isSubTask() const { return m_subTaskId >= 0; }
 
-    // running on worker thread
-    virtual void process(TileBuilder& _tileBuilder);
+    // running on worker thread: Looks up the tile in @_cache before parse().
+    // Returns true when the tile was restored without parse and build,
+    // otherwise the tile is stored in @_cache once it is built.
+    bool restore(std::shared_ptr<TileDiskCache> _cache, const Scene& _scene, uint64_t _sceneHash);
+
+    // running on worker thread: Decodes the task's data in the parse stage.
+    // Returns false when there is nothing left to build.
+    virtual bool parse(const MapProjection& _projection);
+
+    // running on worker thread: Styles and builds the tile from the parsed
+    // data in the build stage
+    virtual void build(TileBuilder& _tileBuilder);
 
     // running on main thread when the tile is added to
     virtual void complete();
@@ -82,8 +101,25 @@ public:
 
     void startedLoading() { m_needsLoading = false; }
 
+    // Build the tile from the parsed data of tile @_parentId, which is this
+    // tile's data tile or an ancestor. The data is sliced in the parse stage.
+    void setParentData(std::shared_ptr<TileData> _data, TileID _parentId);
+
+    bool hasParentData() const { return m_parentId != NOT_A_TILE; }
+
+    // Whether the tile may be built from parent data instead of its own
+    bool isSliceable() const { return m_sliceable; }
+    void setSliceable(bool _sliceable) { m_sliceable = _sliceable; }
+
 protected:
 
+    // Key of the tile in a TileDiskCache, 0 when the tile cannot be cached
+    virtual uint64_t diskCacheKey(uint64_t _sceneHash) const { return 0; }
+
+    // running on worker thread: Prepares the task's data for diskCacheKey()
+    // and parse(). Returns false when the data is invalid.
+    virtual bool decodeData() { return true; }
+
     const TileID m_tileId;
 
     const int m_subTaskId;
@@ -96,14 +132,36 @@ protected:
 
     const int64_t m_sourceGeneration;
 
+    // Output of parse(), consumed by build()
+    std::shared_ptr<TileData> m_tileData;
+
+    // Input of parse() when the tile is built from the data of a parent
+    std::shared_ptr<TileData> m_parentData;
+    TileID m_parentId = NOT_A_TILE;
+
     // Tile result, set when tile was  sucessfully created
     std::shared_ptr<Tile> m_tile;
 
-    bool m_canceled = false;
+    // Cache for the built tile and its key
+    std::shared_ptr<TileDiskCache> m_diskCache;
+    uint64_t m_diskCacheKey = 0;
+
+    // Cached meshes of a tile with labels, added to the tile when its
+    // labels are built
+    std::shared_ptr<TileBundle> m_diskCacheEntry;
+
+    std::atomic<bool> m_canceled{false};
     bool m_needsLoading = true;
+    bool m_sliceable = true;
 
     std::atomic<float> m_priority;
-    bool m_proxyState = false;
+    std::atomic<bool> m_proxyState{false};
+
+private:
+
+    // Position of this task in a TileTaskHeap, managed by the heap
+    std::atomic<int> m_queueOwner{-1};
+    size_t m_queueIndex = 0;
 };
 
 class BinaryTileTask : public TileTask {
@@ -112,16 +170,31 @@ public:
         : TileTask(_tileId, _source, _subTask) {}
 
     virtual bool hasData() const override {
-        return rawTileData && !rawTileData->empty();
+        return hasParentData() || (rawTileData && !rawTileData->empty());
     }
     // Raw tile data that will be processed by TileSource.
     std::shared_ptr<std::vector<char>> rawTileData;
 
     bool dataFromCache = false;
+
+    // Whether rawTileData is gzip compressed, it is then inflated before
+    // the disk cache lookup or parse()
+    bool compressed = false;
+
+    bool parse(const MapProjection& _projection) override;
+
+protected:
+
+    uint64_t diskCacheKey(uint64_t _sceneHash) const override;
+
+    bool decodeData() override;
 };
 
 struct TileTaskQueue {
     virtual void enqueue(std::shared_ptr<TileTask> task) = 0;
+
+    // Apply a changed priority or proxy state of a queued task
+    virtual void reprioritize(TileTask& task) {}
 };
 
 struct TileTaskCb {
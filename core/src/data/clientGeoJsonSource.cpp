@@ -1,8 +1,12 @@
 #include "data/clientGeoJsonSource.h"
 
+#include "log.h"
 #include "platform.h"
+#include "tile/tileHash.h"
 #include "tile/tileTask.h"
+#include "util/asyncWorker.h"
 #include "util/geom.h"
+#include "data/formats/geoJson.h"
 #include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "tile/tile.h"
@@ -10,12 +14,24 @@
 
 #include "mapbox/geojsonvt.hpp"
 
-// RapidJson parser
-#include "mapbox/geojson.hpp"
-#include <mapbox/geojson_impl.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <regex>
+#include <unordered_map>
 
+// Zoom level of the grid cells that are indexed separately: An update
+// rebuilds only the index of the cells of changed features
+#define BUCKET_ZOOM 6
+// Maximum number of tiles per zoom level that are invalidated by a change
+#define MAX_CHANGED_TILES 16
 
-#include <regex>
+// Attempts to commit a batch or to install the index of a bucket built
+// without locking the store, the last one indexes while locked
+#define MAX_COMMIT_ATTEMPTS 4
 
 namespace Tangram {
 
@@ -33,50 +49,154 @@ geojsonvt::Options options() {
     return opt;
 }
 
-struct ClientGeoJsonData {
-    std::unique_ptr<geojsonvt::GeoJSONVT> tiles;
-    mapbox::geometry::feature_collection<double> features;
-    std::vector<Properties> properties;
-};
+static BoundingBox emptyBounds() {
+    double inf = std::numeric_limits<double>::infinity();
+    return { { inf, inf }, { -inf, -inf } };
+}
 
-std::shared_ptr<TileTask> ClientGeoJsonSource::createTask(TileID _tileId, int _subTask) {
-    return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+static bool intersects(const BoundingBox& _a, const BoundingBox& _b) {
+    return _a.min.x <= _b.max.x && _b.min.x <= _a.max.x &&
+        _a.min.y <= _b.max.y && _b.min.y <= _a.max.y;
 }
 
+// Position in the unit square of the mercator projection, y pointing south like TileIDs
+static glm::dvec2 worldPosition(double _lon, double _lat) {
+    double sinLat = glm::clamp(std::sin(_lat * PI / 180.0), -0.9999, 0.9999);
+    return { (_lon + 180.0) / 360.0, 0.5 - std::log((1 + sinLat) / (1 - sinLat)) / FOUR_PI };
+}
 
-// TODO: pass scene's resourcePath to constructor to be used with `stringFromFile`
-ClientGeoJsonSource::ClientGeoJsonSource(std::shared_ptr<Platform> _platform,
-                                         const std::string& _name, const std::string& _url,
-                                         bool _generateCentroids,
-                                         TileSource::ZoomOptions _zoomOptions)
+struct add_bounds {
 
-    : TileSource(_name, nullptr, _zoomOptions),
-      m_generateCentroids(_generateCentroids),
-      m_platform(_platform) {
+    BoundingBox& bounds;
 
-    // TODO: handle network url for client datasource data
-    // TODO: generic uri handling
-    m_generateGeometry = true;
-    m_store = std::make_unique<ClientGeoJsonData>();
+    void operator()(const geometry::point<double>& p) {
+        auto pos = worldPosition(p.x, p.y);
+        bounds.expand(pos.x, pos.y);
+    }
+    void operator()(const geometry::geometry<double>& geom) {
+        geometry::geometry<double>::visit(geom, *this);
+    }
+    // Lines, rings, polygons and multi geometries
+    template <typename T>
+    void operator()(const T& geom) {
+        for (auto& g : geom) { (*this)(g); }
+    }
+};
 
-    if (!_url.empty()) {
-        std::regex r("^(http|https):/");
-        std::smatch match;
-        if (std::regex_search(_url, match, r)) {
-            m_platform->startUrlRequest(_url,
-                    [&, this](std::vector<char>&& rawData) {
-                        addData(std::string(rawData.begin(), rawData.end()));
-                        m_hasPendingData = false;
-                    });
-            m_hasPendingData = true;
-        } else {
-            // Load from file
-            addData(m_platform->stringFromFile(_url.c_str()));
+/* Generations of the changes in each tile. A change is recorded for the tiles
+ * that intersect the changed bounds at each zoom level, until these are more
+ * than MAX_CHANGED_TILES. From there on it applies to the subtrees of the
+ * tiles of the last level. Changes that no tile is older than are pruned. */
+struct TileChanges {
+
+    std::unordered_map<TileID, int64_t> tiles;
+    std::unordered_map<TileID, int64_t> subtrees;
+    // Generation of tiles without recorded changes
+    int64_t base = 0;
+    int32_t maxZoom = 18;
+
+    struct Range {
+        int32_t x0, y0, x1, y1;
+        int64_t count() const { return int64_t(x1 - x0 + 1) * (y1 - y0 + 1); }
+    };
+
+    static Range range(const BoundingBox& _bounds, int32_t _z) {
+        int32_t n = 1 << _z;
+        auto index = [&](double _v) { return glm::clamp(int32_t(std::floor(_v * n)), 0, n - 1); };
+        return { index(_bounds.min.x), index(_bounds.min.y), index(_bounds.max.x), index(_bounds.max.y) };
+    }
+
+    static void mark(std::unordered_map<TileID, int64_t>& _map, const Range& _range,
+                     int32_t _z, int64_t _generation) {
+        for (int32_t x = _range.x0; x <= _range.x1; x++) {
+            for (int32_t y = _range.y0; y <= _range.y1; y++) {
+                _map[TileID(x, y, _z)] = _generation;
+            }
         }
     }
-}
 
-ClientGeoJsonSource::~ClientGeoJsonSource() {}
+    void add(const BoundingBox& _bounds, int64_t _generation) {
+        Range current = range(_bounds, 0);
+        int32_t z = 0;
+        while (z < maxZoom) {
+            Range next = range(_bounds, z + 1);
+            if (next.count() > MAX_CHANGED_TILES) { break; }
+            mark(tiles, current, z, _generation);
+            current = next;
+            z++;
+        }
+        mark(subtrees, current, z, _generation);
+    }
+
+    int64_t get(const TileID& _tile) const {
+        int64_t generation = base;
+
+        auto it = tiles.find(TileID(_tile.x, _tile.y, _tile.z));
+        if (it != tiles.end()) { generation = std::max(generation, it->second); }
+
+        for (int32_t z = _tile.z; z >= 0; z--) {
+            int32_t shift = _tile.z - z;
+            auto it = subtrees.find(TileID(_tile.x >> shift, _tile.y >> shift, z));
+            if (it != subtrees.end()) { generation = std::max(generation, it->second); }
+        }
+        return generation;
+    }
+
+    void reset(int64_t _generation) {
+        tiles.clear();
+        subtrees.clear();
+        base = _generation;
+    }
+
+    // Forget the changes up to @_generation: Tiles of that generation or
+    // later are not older than these changes
+    void prune(int64_t _generation) {
+        for (auto* map : { &tiles, &subtrees }) {
+            for (auto it = map->begin(); it != map->end(); ) {
+                if (it->second <= _generation) {
+                    it = map->erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+};
+
+struct ClientGeoJsonFeature {
+    geometry::geometry<double> geometry;
+    Properties properties;
+    // Bounds in world coordinates, see worldPosition()
+    BoundingBox bounds;
+    // Grid cell the feature is indexed in
+    TileID bucket = NOT_A_TILE;
+};
+
+struct ClientGeoJsonBucket {
+    // IDs of the features in this cell, in the order they were added
+    std::vector<uint64_t> features;
+    // Bounds of the features, including removed ones until the index is rebuilt
+    BoundingBox bounds = emptyBounds();
+    // Index of the features, built on demand after changes
+    std::unique_ptr<geojsonvt::GeoJSONVT> tiles;
+    // Store version at the last change of the features
+    uint64_t version = 0;
+    // Whether a parse builds the index without holding the store lock
+    bool indexing = false;
+};
+
+// A feature read from GeoJSON or columns, with its grid cell or NOT_A_TILE when it is empty
+struct ClientGeoJsonUpdate {
+    // Whether the feature replaces the feature of upsertData() with GeoJSON "id" @dataId
+    bool hasId;
+    uint64_t dataId;
+    // ID in the store, assigned when the update is applied
+    uint64_t id;
+    geometry::geometry<double> geometry;
+    Properties properties;
+    BoundingBox bounds;
+    TileID bucket;
+};
 
 struct add_centroid {
 
@@ -115,76 +235,645 @@ struct add_centroid {
     }
 };
 
-struct prop_visitor {
-    Properties& props;
-    std::string& key;
-    void operator()(std::string v) {
-        props.set(key, v);
+static BoundingBox boundsOf(const geometry::geometry<double>& _geometry) {
+    BoundingBox bounds = emptyBounds();
+    geometry::geometry<double>::visit(_geometry, add_bounds{ bounds });
+    return bounds;
+}
+
+// Grid cell of a feature, NOT_A_TILE for empty geometry
+static TileID bucketOf(const BoundingBox& _bounds) {
+    if (_bounds.min.x > _bounds.max.x) { return NOT_A_TILE; }
+
+    auto center = _bounds.center();
+    auto cell = TileChanges::range({ center, center }, BUCKET_ZOOM);
+    return TileID(cell.x0, cell.y0, BUCKET_ZOOM);
+}
+
+// Features of an index have their position in the bucket as ID, shifted
+// left by one bit which is set for label centroids
+static void addToIndex(geometry::feature_collection<double>& _collection,
+                       const geometry::geometry<double>& _geometry,
+                       size_t _position, bool _generateCentroids) {
+
+    _collection.emplace_back(_geometry, uint64_t(_position << 1));
+
+    geometry::point<double> centroid;
+    if (_generateCentroids &&
+        geometry::geometry<double>::visit(_geometry, add_centroid{ centroid })) {
+        _collection.emplace_back(centroid, uint64_t((_position << 1) | 1));
+    }
+}
+
+/* Index of buckets changed by a batch of updates, built without locking
+ * the store: prepare() copies the geometry that the index needs, build()
+ * builds it, and commit() applies the updates and installs the index when
+ * the store did not change in the meantime. Otherwise prepare() is called
+ * again and keeps the index of buckets that did not change. */
+struct ClientGeoJsonBatch {
+
+    struct Bucket {
+        std::vector<uint64_t> features;
+        std::unique_ptr<geojsonvt::GeoJSONVT> tiles;
+        BoundingBox bounds = emptyBounds();
+        // Version of the bucket in the store at prepare(), 0 when it did not exist
+        uint64_t version = 0;
+    };
+
+    std::vector<ClientGeoJsonUpdate> updates;
+    std::map<TileID, Bucket> buckets;
+
+    // Geometry and bounds of the features in changed buckets that are not updated
+    std::unordered_map<uint64_t, ClientGeoJsonFeature> kept;
+    // Index in updates of the last update of each feature
+    std::unordered_map<uint64_t, size_t> updated;
+    // IDs of the GeoJSON "id"s that are new to the store
+    std::unordered_map<uint64_t, uint64_t> dataIds;
+
+    // Store version and next feature ID after prepare()
+    uint64_t version = 0;
+    uint64_t nextId = 0;
+};
+
+struct ClientGeoJsonData {
+
+    std::unordered_map<uint64_t, ClientGeoJsonFeature> features;
+    std::map<TileID, ClientGeoJsonBucket> buckets;
+    // ID of the next feature added without an ID
+    uint64_t nextId = 0;
+    // IDs of the features of upsertData() by their GeoJSON "id": These are
+    // not used as IDs in the store, so that they cannot replace other features
+    std::unordered_map<uint64_t, uint64_t> dataIds;
+    // Incremented for each change of features
+    uint64_t version = 0;
+
+    // Read by the TileManager while the store may be locked by a parse
+    mutable std::mutex changesMutex;
+    TileChanges changes;
+
+    // Notified when a parse installed or dropped the index of a bucket
+    std::condition_variable indexed;
+
+    void changed(const BoundingBox& _bounds, int64_t _generation) {
+        std::lock_guard<std::mutex> lock(changesMutex);
+        changes.add(_bounds, _generation);
+    }
+
+    void removeFromBucket(uint64_t _id, const TileID& _bucket) {
+        auto it = buckets.find(_bucket);
+        auto& ids = it->second.features;
+        ids.erase(std::find(ids.begin(), ids.end(), _id));
+
+        if (ids.empty()) {
+            buckets.erase(it);
+        } else {
+            it->second.tiles.reset();
+            it->second.version = version;
+        }
+    }
+
+    void upsert(uint64_t _id, geometry::geometry<double>&& _geometry,
+                Properties&& _properties, int64_t _generation) {
+
+        BoundingBox bounds = boundsOf(_geometry);
+        upsert(_id, std::move(_geometry), std::move(_properties), bounds, bucketOf(bounds), _generation);
     }
-    void operator()(bool v) {
-        props.set(key, double(v));
+
+    void upsert(uint64_t _id, geometry::geometry<double>&& _geometry, Properties&& _properties,
+                const BoundingBox& _bounds, const TileID& _bucket, int64_t _generation) {
+
+        if (_bucket == NOT_A_TILE) {
+            // Nothing to draw
+            remove(_id, _generation);
+            return;
+        }
+        version++;
+
+        auto it = features.find(_id);
+        if (it == features.end()) {
+            it = features.emplace(_id, ClientGeoJsonFeature{}).first;
+            nextId = std::max(nextId, _id + 1);
+        } else {
+            // Tiles that contained the old geometry change as well
+            changed(it->second.bounds, _generation);
+            if (it->second.bucket != _bucket) {
+                removeFromBucket(_id, it->second.bucket);
+                it->second.bucket = NOT_A_TILE;
+            }
+        }
+
+        auto& feature = it->second;
+        auto& bucket = buckets[_bucket];
+        if (feature.bucket != _bucket) {
+            bucket.features.push_back(_id);
+        }
+        bucket.bounds.expand(_bounds.min.x, _bounds.min.y);
+        bucket.bounds.expand(_bounds.max.x, _bounds.max.y);
+        bucket.tiles.reset();
+        bucket.version = version;
+
+        feature.geometry = std::move(_geometry);
+        feature.properties = std::move(_properties);
+        feature.bounds = _bounds;
+        feature.bucket = _bucket;
+
+        changed(_bounds, _generation);
     }
-    void operator()(uint64_t v) {
-        props.set(key, double(v));
+
+    // ID of the feature with GeoJSON "id" @_dataId, a new one when there is none
+    uint64_t idOfData(uint64_t _dataId) {
+        auto it = dataIds.find(_dataId);
+        if (it != dataIds.end()) { return it->second; }
+
+        dataIds.emplace(_dataId, nextId);
+        return nextId++;
     }
-    void operator()(int64_t v) {
-        props.set(key, double(v));
+
+    bool remove(uint64_t _id, int64_t _generation) {
+        auto it = features.find(_id);
+        if (it == features.end()) { return false; }
+
+        version++;
+        changed(it->second.bounds, _generation);
+        removeFromBucket(_id, it->second.bucket);
+        features.erase(it);
+        return true;
     }
-    void operator()(double v) {
-        props.set(key, v);
+
+    void clear(int64_t _generation) {
+        version++;
+        features.clear();
+        buckets.clear();
+        dataIds.clear();
+
+        std::lock_guard<std::mutex> lock(changesMutex);
+        changes.reset(_generation);
     }
 
-    template <typename T>
-    void operator()(T) {
-        // Ignore all other basic value types
+    // Copy the geometry of the features of @_bucket for its index
+    void collect(const ClientGeoJsonBucket& _bucket, bool _generateCentroids,
+                 geometry::feature_collection<double>& _collection, BoundingBox& _bounds) const {
+        _bounds = emptyBounds();
+
+        for (size_t i = 0; i < _bucket.features.size(); i++) {
+            auto& feature = features.at(_bucket.features[i]);
+            addToIndex(_collection, feature.geometry, i, _generateCentroids);
+
+            _bounds.expand(feature.bounds.min.x, feature.bounds.min.y);
+            _bounds.expand(feature.bounds.max.x, feature.bounds.max.y);
+        }
+    }
+
+    void build(ClientGeoJsonBucket& _bucket, bool _generateCentroids) {
+        geometry::feature_collection<double> collection;
+        collect(_bucket, _generateCentroids, collection, _bucket.bounds);
+        _bucket.tiles = std::make_unique<geojsonvt::GeoJSONVT>(collection, options());
+    }
+
+    // Determine the buckets after applying the updates of @_batch, the same
+    // way upsert() does, and copy the geometry of their other features.
+    // Buckets indexed by a previous prepare() keep their index when neither
+    // they nor their features changed.
+    void prepare(ClientGeoJsonBatch& _batch) {
+        _batch.version = version;
+
+        auto previous = std::move(_batch.buckets);
+        _batch.buckets.clear();
+        _batch.kept.clear();
+        _batch.updated.clear();
+        _batch.dataIds.clear();
+
+        uint64_t id = nextId;
+        for (auto& update : _batch.updates) {
+            if (!update.hasId) {
+                update.id = id++;
+                continue;
+            }
+            auto it = dataIds.find(update.dataId);
+            if (it != dataIds.end()) {
+                update.id = it->second;
+            } else {
+                auto added = _batch.dataIds.emplace(update.dataId, id);
+                if (added.second) { id++; }
+                update.id = added.first->second;
+            }
+        }
+        _batch.nextId = id;
+
+        auto bucketFeatures = [&](const TileID& _bucket) -> std::vector<uint64_t>& {
+            auto it = _batch.buckets.find(_bucket);
+            if (it == _batch.buckets.end()) {
+                it = _batch.buckets.emplace(_bucket, ClientGeoJsonBatch::Bucket{}).first;
+                auto current = buckets.find(_bucket);
+                if (current != buckets.end()) {
+                    it->second.features = current->second.features;
+                    it->second.version = current->second.version;
+                }
+            }
+            return it->second.features;
+        };
+
+        std::unordered_map<uint64_t, TileID> moved;
+        for (size_t i = 0; i < _batch.updates.size(); i++) {
+            auto& update = _batch.updates[i];
+
+            TileID from = NOT_A_TILE;
+            auto movedIt = moved.find(update.id);
+            if (movedIt != moved.end()) {
+                from = movedIt->second;
+            } else {
+                auto it = features.find(update.id);
+                if (it != features.end()) { from = it->second.bucket; }
+            }
+
+            if (from != update.bucket) {
+                if (from != NOT_A_TILE) {
+                    auto& ids = bucketFeatures(from);
+                    ids.erase(std::find(ids.begin(), ids.end(), update.id));
+                }
+                if (update.bucket != NOT_A_TILE) {
+                    bucketFeatures(update.bucket).push_back(update.id);
+                }
+            }
+            auto result = moved.emplace(update.id, update.bucket);
+            if (!result.second) { result.first->second = update.bucket; }
+            _batch.updated[update.id] = i;
+        }
+
+        for (auto& entry : _batch.buckets) {
+            auto it = previous.find(entry.first);
+            if (it != previous.end() && it->second.tiles &&
+                it->second.version == entry.second.version &&
+                it->second.features == entry.second.features) {
+                entry.second = std::move(it->second);
+                continue;
+            }
+            for (uint64_t id : entry.second.features) {
+                if (_batch.updated.count(id)) { continue; }
+                auto& feature = features.at(id);
+                auto& copy = _batch.kept[id];
+                copy.geometry = feature.geometry;
+                copy.bounds = feature.bounds;
+            }
+        }
+    }
+
+    // Returns false without applying @_batch when the store changed since prepare()
+    bool commit(ClientGeoJsonBatch& _batch, int64_t _generation) {
+        if (_batch.version != version) { return false; }
+
+        dataIds.insert(_batch.dataIds.begin(), _batch.dataIds.end());
+        nextId = std::max(nextId, _batch.nextId);
+
+        for (auto& update : _batch.updates) {
+            upsert(update.id, std::move(update.geometry), std::move(update.properties),
+                   update.bounds, update.bucket, _generation);
+        }
+
+        for (auto& entry : _batch.buckets) {
+            auto it = buckets.find(entry.first);
+            if (it == buckets.end()) { continue; }
+
+            auto& bucket = it->second;
+            assert(bucket.features == entry.second.features);
+            bucket.tiles = std::move(entry.second.tiles);
+            bucket.bounds = entry.second.bounds;
+        }
+        return true;
     }
 };
 
-void ClientGeoJsonSource::generateLabelCentroidFeature() {
-    for (const auto &feat : m_store->features) {
-        geometry::point<double> centroid;
-        const auto& properties = m_store->properties[feat.id.get<uint64_t>()];
-        if (geometry::geometry<double>::visit(feat.geometry, add_centroid{ centroid })) {
-            uint64_t id = m_store->features.size();
-            m_store->features.emplace_back(centroid, id);
-            m_store->properties.push_back(properties);
-            auto& props = m_store->properties.back();
-            props.set("label_placement", 1.0);
+static void buildIndex(ClientGeoJsonBatch& _batch, bool _generateCentroids) {
+
+    for (auto& entry : _batch.buckets) {
+        auto& bucket = entry.second;
+        if (bucket.features.empty() || bucket.tiles) { continue; }
+
+        geometry::feature_collection<double> collection;
+        for (size_t i = 0; i < bucket.features.size(); i++) {
+            uint64_t id = bucket.features[i];
+
+            auto updated = _batch.updated.find(id);
+            auto& geometry = (updated != _batch.updated.end()) ?
+                _batch.updates[updated->second].geometry : _batch.kept.at(id).geometry;
+            auto& bounds = (updated != _batch.updated.end()) ?
+                _batch.updates[updated->second].bounds : _batch.kept.at(id).bounds;
+
+            addToIndex(collection, geometry, i, _generateCentroids);
+            bucket.bounds.expand(bounds.min.x, bounds.min.y);
+            bucket.bounds.expand(bounds.max.x, bounds.max.y);
         }
+        bucket.tiles = std::make_unique<geojsonvt::GeoJSONVT>(collection, options());
     }
 }
 
-void ClientGeoJsonSource::addData(const std::string& _data) {
+// Convert the geometry read by GeoJson::read() to the input of geojson-vt
+geometry::geometry<double> toGeometry(const GeoJson::FeatureData& _data) {
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
+    using Type = GeoJson::FeatureData::Type;
 
-    const auto json = geojson::parse(_data);
-    auto features = geojsonvt::geojson::visit(json, geojsonvt::ToFeatureCollection{});
+    auto point = [&](uint32_t i) {
+        auto& c = _data.coordinates[i];
+        return geometry::point<double>{ c.x, c.y };
+    };
+    auto line = [&](uint32_t l, auto& _out) {
+        uint32_t begin = l == 0 ? 0 : _data.lineEnds[l-1];
+        for (uint32_t i = begin; i < _data.lineEnds[l]; i++) {
+            _out.push_back(point(i));
+        }
+    };
+    auto polygon = [&](uint32_t p) {
+        geometry::polygon<double> out;
+        uint32_t begin = p == 0 ? 0 : _data.polygonEnds[p-1];
+        for (uint32_t l = begin; l < _data.polygonEnds[p]; l++) {
+            out.emplace_back();
+            line(l, out.back());
+        }
+        return out;
+    };
+
+    switch (_data.type) {
+    case Type::point:
+        if (!_data.coordinates.empty()) { return point(0); }
+        break;
+    case Type::multiPoint: {
+        geometry::multi_point<double> out;
+        for (uint32_t i = 0; i < _data.coordinates.size(); i++) { out.push_back(point(i)); }
+        return out;
+    }
+    case Type::lineString:
+        if (!_data.lineEnds.empty()) {
+            geometry::line_string<double> out;
+            line(0, out);
+            return out;
+        }
+        break;
+    case Type::multiLineString: {
+        geometry::multi_line_string<double> out;
+        for (uint32_t l = 0; l < _data.lineEnds.size(); l++) {
+            out.emplace_back();
+            line(l, out.back());
+        }
+        return out;
+    }
+    case Type::polygon:
+        if (!_data.polygonEnds.empty()) { return polygon(0); }
+        break;
+    case Type::multiPolygon: {
+        geometry::multi_polygon<double> out;
+        for (uint32_t p = 0; p < _data.polygonEnds.size(); p++) { out.push_back(polygon(p)); }
+        return out;
+    }
+    default:
+        break;
+    }
+    return geometry::geometry_collection<double>{};
+}
 
-    for (auto& feature : features) {
+// Read the features of GeoJSON @_data, with their bounds and grid cells. The
+// GeoJSON "id"s of the features are used with @_useIds.
+static bool readUpdates(const std::string& _data, int32_t _sourceId, const std::string& _sourceName,
+                        bool _useIds, std::vector<ClientGeoJsonUpdate>& _updates) {
 
-        feature.id = uint64_t(m_store->properties.size());
-        m_store->properties.emplace_back();
-        Properties& props = m_store->properties.back();
+    auto onLayer = [](const std::string& _name) {};
 
-        for (const auto& prop : feature.properties) {
-            auto key = prop.first;
-            prop_visitor visitor = {props, key};
-            mapbox::util::apply_visitor(visitor, prop.second);
+    auto onFeature = [&](GeoJson::FeatureData& _feature) {
+        auto geometry = toGeometry(_feature);
+        auto bounds = boundsOf(geometry);
+        _updates.push_back({ _useIds && _feature.hasId, _feature.id, 0, std::move(geometry),
+                             GeoJson::getProperties(std::move(_feature.properties), _sourceId),
+                             bounds, bucketOf(bounds) });
+        return true;
+    };
+
+    const char* error;
+    size_t offset;
+    if (!GeoJson::read(_data.data(), _data.size(), onLayer, onFeature, &error, &offset)) {
+        LOGE("Json parsing failed for source '%s': %s (%u)", _sourceName.c_str(), error, offset);
+        return false;
+    }
+    return true;
+}
+
+// Read the features of @_columns into geometry for geojson-vt, with their bounds and grid cells
+static void readColumns(const ClientGeoJsonSource::FeatureColumns& _columns, int32_t _sourceId,
+                        std::vector<ClientGeoJsonUpdate>& _updates) {
+
+    using Type = ClientGeoJsonSource::FeatureColumns::Type;
+
+    // Intern the names once and order the columns like sorted Properties
+    struct Column {
+        PropertyKey key;
+        const double* numbers;
+        const char* const* strings;
+    };
+    std::vector<Column> columns;
+    columns.reserve(_columns.numbers.size() + _columns.strings.size());
+    for (auto& c : _columns.numbers) { columns.push_back({ PropertyKey(c.name), c.values, nullptr }); }
+    for (auto& c : _columns.strings) { columns.push_back({ PropertyKey(c.name), nullptr, c.values }); }
+    std::sort(columns.begin(), columns.end(), [](auto& _a, auto& _b) {
+        return Properties::keyComparator(_a.key.str(), _b.key.str());
+    });
+
+    BoundingBox bounds;
+    auto point = [&](uint32_t i) {
+        geometry::point<double> p{ _columns.coordinates[2*i], _columns.coordinates[2*i+1] };
+        auto pos = worldPosition(p.x, p.y);
+        bounds.expand(pos.x, pos.y);
+        return p;
+    };
+    auto line = [&](uint32_t l, auto& _out) {
+        uint32_t begin = l == 0 ? 0 : _columns.lineEnds[l-1];
+        _out.reserve(_columns.lineEnds[l] - begin);
+        for (uint32_t i = begin; i < _columns.lineEnds[l]; i++) { _out.push_back(point(i)); }
+    };
+    auto polygon = [&](uint32_t p, geometry::polygon<double>& _out) {
+        uint32_t begin = p == 0 ? 0 : _columns.polygonEnds[p-1];
+        _out.resize(_columns.polygonEnds[p] - begin);
+        for (uint32_t l = begin; l < _columns.polygonEnds[p]; l++) { line(l, _out[l - begin]); }
+    };
+
+    _updates.reserve(_updates.size() + _columns.featureCount);
+
+    uint32_t begin = 0;
+    for (size_t f = 0; f < _columns.featureCount; f++) {
+        uint32_t end = _columns.featureEnds[f];
+        bounds = emptyBounds();
+
+        // Single geometries for features with one element
+        geometry::geometry<double> geom = geometry::geometry_collection<double>{};
+        switch (_columns.type) {
+        case Type::points:
+            if (end - begin == 1) {
+                geom = point(begin);
+            } else if (end > begin) {
+                geometry::multi_point<double> out;
+                out.reserve(end - begin);
+                for (uint32_t i = begin; i < end; i++) { out.push_back(point(i)); }
+                geom = std::move(out);
+            }
+            break;
+        case Type::lines:
+            if (end - begin == 1) {
+                geometry::line_string<double> out;
+                line(begin, out);
+                geom = std::move(out);
+            } else if (end > begin) {
+                geometry::multi_line_string<double> out;
+                out.resize(end - begin);
+                for (uint32_t l = begin; l < end; l++) { line(l, out[l - begin]); }
+                geom = std::move(out);
+            }
+            break;
+        case Type::polygons:
+            if (end - begin == 1) {
+                geometry::polygon<double> out;
+                polygon(begin, out);
+                geom = std::move(out);
+            } else if (end > begin) {
+                geometry::multi_polygon<double> out;
+                out.resize(end - begin);
+                for (uint32_t p = begin; p < end; p++) { polygon(p, out[p - begin]); }
+                geom = std::move(out);
+            }
+            break;
+        }
+        begin = end;
+
+        std::vector<PropertyItem> items;
+        items.reserve(columns.size());
+        for (auto& c : columns) {
+            if (c.numbers) {
+                if (!std::isnan(c.numbers[f])) { items.emplace_back(c.key, c.numbers[f]); }
+            } else if (c.strings[f]) {
+                items.emplace_back(c.key, std::string(c.strings[f]));
+            }
         }
-        feature.properties.clear();
+        Properties properties;
+        properties.sourceId = _sourceId;
+        properties.setSorted(std::move(items));
+
+        _updates.push_back({ false, 0, 0, std::move(geom), std::move(properties), bounds, bucketOf(bounds) });
     }
+}
+
+std::shared_ptr<TileTask> ClientGeoJsonSource::createTask(TileID _tileId, int _subTask) {
+    return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+}
+
+
+// TODO: pass scene's resourcePath to constructor to be used with `stringFromFile`
+ClientGeoJsonSource::ClientGeoJsonSource(std::shared_ptr<Platform> _platform,
+                                         const std::string& _name, const std::string& _url,
+                                         bool _generateCentroids,
+                                         TileSource::ZoomOptions _zoomOptions)
 
-    m_store->features.insert(m_store->features.end(),
-                             std::make_move_iterator(features.begin()),
-                             std::make_move_iterator(features.end()));
+    : TileSource(_name, nullptr, _zoomOptions),
+      m_generateCentroids(_generateCentroids),
+      m_platform(_platform) {
 
-    if (m_generateCentroids) {
-        generateLabelCentroidFeature();
+    // TODO: handle network url for client datasource data
+    // TODO: generic uri handling
+    m_generateGeometry = true;
+    m_store = std::make_unique<ClientGeoJsonData>();
+    m_store->changes.maxZoom = m_zoomOptions.maxZoom;
+    m_worker = std::make_unique<AsyncWorker>();
+
+    if (!_url.empty()) {
+        auto loaded = [this](bool _success, int64_t _generation) { m_hasPendingData = false; };
+
+        std::regex r("^(http|https):/");
+        std::smatch match;
+        m_hasPendingData = true;
+        if (std::regex_search(_url, match, r)) {
+            m_platform->startUrlRequest(_url,
+                    [this, loaded](std::vector<char>&& rawData) {
+                        addDataAsync(std::string(rawData.begin(), rawData.end()), loaded);
+                    });
+        } else {
+            // Load from file
+            addDataAsync(m_platform->stringFromFile(_url.c_str()), loaded);
+        }
     }
+}
+
+ClientGeoJsonSource::~ClientGeoJsonSource() {
+    // Finish the running ingestion before the store is released
+    m_worker.reset();
+}
+
+void ClientGeoJsonSource::addData(const std::string& _data) {
+    applyData(_data, false);
+}
+
+void ClientGeoJsonSource::upsertData(const std::string& _data) {
+    applyData(_data, true);
+}
+
+void ClientGeoJsonSource::applyData(const std::string& _data, bool _upsert) {
+
+    // Read all features before applying them
+    std::vector<ClientGeoJsonUpdate> updates;
+    if (!readUpdates(_data, m_id, m_name, _upsert, updates)) { return; }
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
 
-    m_store->tiles = std::make_unique<geojsonvt::GeoJSONVT>(m_store->features, options());
     m_generation++;
+    for (auto& update : updates) {
+        uint64_t id = update.hasId ? m_store->idOfData(update.dataId) : m_store->nextId;
+        m_store->upsert(id, std::move(update.geometry), std::move(update.properties),
+                        update.bounds, update.bucket, m_generation);
+    }
+}
+
+void ClientGeoJsonSource::addDataAsync(std::string _data, AddDataCallback _callback) {
+    applyDataAsync(std::move(_data), std::move(_callback), false);
+}
+
+void ClientGeoJsonSource::upsertDataAsync(std::string _data, AddDataCallback _callback) {
+    applyDataAsync(std::move(_data), std::move(_callback), true);
+}
+
+void ClientGeoJsonSource::applyDataAsync(std::string _data, AddDataCallback _callback, bool _upsert) {
+
+    m_worker->enqueue([this, data = std::move(_data), _callback, _upsert]() {
+
+        ClientGeoJsonBatch batch;
+        if (!readUpdates(data, m_id, m_name, _upsert, batch.updates)) {
+            if (_callback) { _callback(false, generation()); }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutexStore);
+            m_store->prepare(batch);
+        }
+
+        int64_t generation;
+        for (int attempt = 1; ; attempt++) {
+            // Tiles are parsed from the current indexes in the meantime
+            buildIndex(batch, m_generateCentroids);
+
+            std::lock_guard<std::mutex> lock(m_mutexStore);
+            generation = m_generation + 1;
+            if (m_store->commit(batch, generation)) {
+                m_generation = generation;
+                break;
+            }
+
+            // Changed in the meantime: Only the buckets changed since are indexed
+            // again. Under the lock at last, so that constant updates cannot starve it
+            m_store->prepare(batch);
+            if (attempt == MAX_COMMIT_ATTEMPTS) {
+                buildIndex(batch, m_generateCentroids);
+                m_store->commit(batch, generation);
+                m_generation = generation;
+                break;
+            }
+        }
+
+        if (_callback) { _callback(true, generation); }
+    });
 }
 
 void ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
@@ -207,52 +896,37 @@ void ClientGeoJsonSource::clearData() {
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
 
-    m_store->features.clear();
-    m_store->properties.clear();
-    m_store->tiles.reset();
-
     m_generation++;
+    m_store->clear(m_generation);
 }
 
-void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
+int64_t ClientGeoJsonSource::generation(const TileID& _tile) const {
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
+    std::lock_guard<std::mutex> lock(m_store->changesMutex);
 
-    geometry::point<double> geom { _point.longitude, _point.latitude };
+    return m_store->changes.get(_tile);
+}
 
-    uint64_t id = m_store->features.size();
+void ClientGeoJsonSource::pruneChanges(int64_t _generation) {
 
-    m_store->features.emplace_back(geom, id);
-    m_store->properties.emplace_back(_tags);
+    std::lock_guard<std::mutex> lock(m_store->changesMutex);
 
-    m_store->tiles = std::make_unique<geojsonvt::GeoJSONVT>(m_store->features, options());
-    m_generation++;
+    m_store->changes.prune(_generation);
 }
 
-void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _line) {
-
-
-    std::lock_guard<std::mutex> lock(m_mutexStore);
+static geometry::point<double> toPoint(LngLat _point) {
+    return { _point.longitude, _point.latitude };
+}
 
+static geometry::line_string<double> toLine(const Coordinates& _line) {
     geometry::line_string<double> geom;
     for (auto& p : _line) {
         geom.emplace_back(p.longitude, p.latitude);
     }
-
-    uint64_t id = m_store->features.size();
-
-    m_store->features.emplace_back(geom, id);
-    m_store->properties.emplace_back(_tags);
-
-    m_store->tiles = std::make_unique<geojsonvt::GeoJSONVT>(m_store->features, options());
-    m_generation++;
+    return geom;
 }
 
-void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly) {
-
-
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-
+static geometry::polygon<double> toPolygon(const std::vector<Coordinates>& _poly) {
     geometry::polygon<double> geom;
     for (auto& ring : _poly) {
         geom.emplace_back();
@@ -261,18 +935,100 @@ void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coo
             line.emplace_back(p.longitude, p.latitude);
         }
     }
+    return geom;
+}
+
+uint64_t ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    uint64_t id = m_store->nextId;
+    m_store->upsert(id, toPoint(_point), Properties(_tags), ++m_generation);
+    return id;
+}
+
+uint64_t ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _line) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
 
-    uint64_t id = m_store->features.size();
+    uint64_t id = m_store->nextId;
+    m_store->upsert(id, toLine(_line), Properties(_tags), ++m_generation);
+    return id;
+}
+
+uint64_t ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    uint64_t id = m_store->nextId;
+    m_store->upsert(id, toPolygon(_poly), Properties(_tags), ++m_generation);
+    return id;
+}
+
+void ClientGeoJsonSource::upsertPoint(uint64_t _id, const Properties& _tags, LngLat _point) {
 
-    m_store->features.emplace_back(geom, id);
-    m_store->properties.emplace_back(_tags);
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    m_store->upsert(_id, toPoint(_point), Properties(_tags), ++m_generation);
+}
 
-    if (m_generateCentroids) {
-        generateLabelCentroidFeature();
+void ClientGeoJsonSource::upsertLine(uint64_t _id, const Properties& _tags, const Coordinates& _line) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    m_store->upsert(_id, toLine(_line), Properties(_tags), ++m_generation);
+}
+
+void ClientGeoJsonSource::upsertPoly(uint64_t _id, const Properties& _tags,
+                                     const std::vector<Coordinates>& _poly) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    m_store->upsert(_id, toPolygon(_poly), Properties(_tags), ++m_generation);
+}
+
+uint64_t ClientGeoJsonSource::addFeatures(const FeatureColumns& _columns) {
+
+    std::vector<ClientGeoJsonUpdate> updates;
+    readColumns(_columns, m_id, updates);
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    // IDs of empty features are skipped as well
+    uint64_t first = m_store->nextId;
+    m_store->nextId += updates.size();
+
+    m_generation++;
+    for (size_t i = 0; i < updates.size(); i++) {
+        auto& update = updates[i];
+        m_store->upsert(first + i, std::move(update.geometry), std::move(update.properties),
+                        update.bounds, update.bucket, m_generation);
     }
+    return first;
+}
+
+void ClientGeoJsonSource::upsertFeatures(const uint64_t* _ids, const FeatureColumns& _columns) {
+
+    std::vector<ClientGeoJsonUpdate> updates;
+    readColumns(_columns, m_id, updates);
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
 
-    m_store->tiles = std::make_unique<geojsonvt::GeoJSONVT>(m_store->features, options());
     m_generation++;
+    for (size_t i = 0; i < updates.size(); i++) {
+        auto& update = updates[i];
+        m_store->upsert(_ids[i], std::move(update.geometry), std::move(update.properties),
+                        update.bounds, update.bucket, m_generation);
+    }
+}
+
+bool ClientGeoJsonSource::removeFeature(uint64_t _id) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    if (!m_store->features.count(_id)) { return false; }
+
+    return m_store->remove(_id, ++m_generation);
 }
 
 struct add_geometry {
@@ -286,48 +1042,74 @@ struct add_geometry {
 
     Feature& feature;
 
+    // Reserve for @_points, @_lines and @_polygons more: Vectors regrown
+    // in the arena of the TileData would leave their previous blocks unused
+    void reserve(size_t _points, size_t _lines, size_t _polygons) {
+        feature.points.reserve(feature.points.size() + _points);
+        feature.lineEnds.reserve(feature.lineEnds.size() + _lines);
+        feature.polygonEnds.reserve(feature.polygonEnds.size() + _polygons);
+    }
+
+    template <typename P>
+    static size_t countPoints(const P& _polygon) {
+        size_t count = 0;
+        for (const auto& ring : _polygon) { count += ring.size(); }
+        return count;
+    }
+
     bool operator()(const geometry::point<int16_t>& p) {
         feature.geometryType = GeometryType::points;
         feature.points.push_back(transformPoint(p));
         return true;
     }
-    bool operator()(const geometry::line_string<int16_t>& geom) {
-        feature.geometryType = GeometryType::lines;
-        feature.lines.emplace_back();
-        Line& line = feature.lines.back();
-        for (const auto& p : geom) {
+    // Append a line or polygon ring to the points of the feature, without repeated points
+    template <typename L>
+    void addLine(const L& _line) {
+        size_t start = feature.points.size();
+        for (const auto& p : _line) {
             auto tp = transformPoint(p);
-            if (line.size() > 0 && tp == line.back()) { continue; }
-            line.push_back(tp);
+            if (feature.points.size() > start && tp == feature.points.back()) { continue; }
+            feature.points.push_back(tp);
         }
+        feature.endLine();
+    }
+
+    bool operator()(const geometry::line_string<int16_t>& geom) {
+        feature.geometryType = GeometryType::lines;
+        reserve(geom.size(), 1, 0);
+        addLine(geom);
         return true;
     }
     bool operator()(const geometry::polygon<int16_t>& geom) {
         feature.geometryType = GeometryType::polygons;
-        feature.polygons.emplace_back();
+        reserve(countPoints(geom), geom.size(), 1);
         for (const auto& ring : geom) {
-            feature.polygons.back().emplace_back();
-            Line& line = feature.polygons.back().back();
-            for (const auto& p : ring) {
-                auto tp = transformPoint(p);
-                if (line.size() > 0 && tp == line.back()) { continue; }
-                line.push_back(tp);
-            }
+            addLine(ring);
         }
+        feature.endPolygon();
         return true;
     }
 
     bool operator()(const geometry::multi_point<int16_t>& geom) {
+        reserve(geom.size(), 0, 0);
         for (auto& g : geom) { (*this)(g); }
         return true;
     }
 
     bool operator()(const geometry::multi_line_string<int16_t>& geom) {
+        reserve(countPoints(geom), geom.size(), 0);
         for (auto& g : geom) { (*this)(g); }
         return true;
     }
 
     bool operator()(const geometry::multi_polygon<int16_t>& geom) {
+        size_t points = 0;
+        size_t rings = 0;
+        for (auto& g : geom) {
+            points += countPoints(g);
+            rings += g.size();
+        }
+        reserve(points, rings, geom.size());
         for (auto& g : geom) { (*this)(g); }
         return true;
     }
@@ -342,26 +1124,97 @@ struct add_geometry {
 std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
                                                      const MapProjection& _projection) const {
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
+    std::unique_lock<std::mutex> lock(m_mutexStore);
+
+    if (m_store->buckets.empty()) { return nullptr; }
+
+    TileID id = _task.tileId();
+    double scale = 1.0 / (1 << id.z);
+    BoundingBox tileBounds{ { id.x * scale, id.y * scale }, { (id.x + 1) * scale, (id.y + 1) * scale } };
+
+    struct Index {
+        TileID bucket;
+        uint64_t version;
+        geometry::feature_collection<double> collection;
+        BoundingBox bounds;
+        std::unique_ptr<geojsonvt::GeoJSONVT> tiles;
+    };
+
+    // Index the buckets of the tile without holding the lock, like
+    // applyDataAsync(), and install the index when the bucket did not
+    // change in the meantime. Buckets that another parse is indexing are
+    // waited for. Under the lock at last, so that updates cannot starve it.
+    for (int attempt = 1; ; attempt++) {
+        std::vector<Index> indexes;
+        bool waiting = false;
+
+        for (auto& entry : m_store->buckets) {
+            auto& bucket = entry.second;
+            if (bucket.tiles || !intersects(bucket.bounds, tileBounds)) { continue; }
+
+            if (attempt == MAX_COMMIT_ATTEMPTS) {
+                m_store->build(bucket, m_generateCentroids);
+            } else if (bucket.indexing) {
+                waiting = true;
+            } else {
+                bucket.indexing = true;
+                indexes.push_back({ entry.first, bucket.version, {}, emptyBounds(), nullptr });
+                m_store->collect(bucket, m_generateCentroids, indexes.back().collection,
+                                 indexes.back().bounds);
+            }
+        }
 
-    auto data = std::make_shared<TileData>();
+        if (indexes.empty()) {
+            if (!waiting) { break; }
+            m_store->indexed.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+        for (auto& index : indexes) {
+            index.tiles = std::make_unique<geojsonvt::GeoJSONVT>(index.collection, options());
+        }
+        lock.lock();
 
-    if (!m_store->tiles) { return nullptr; }
-    auto tile = m_store->tiles->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+        for (auto& index : indexes) {
+            auto it = m_store->buckets.find(index.bucket);
+            if (it == m_store->buckets.end()) { continue; }
+
+            auto& bucket = it->second;
+            bucket.indexing = false;
+            if (!bucket.tiles && bucket.version == index.version) {
+                bucket.tiles = std::move(index.tiles);
+                bucket.bounds = index.bounds;
+            }
+        }
+        m_store->indexed.notify_all();
+    }
+
+    auto data = std::make_shared<TileData>();
+    data->arena = std::make_shared<Arena>();
 
     data->layers.emplace_back("");  // empty name will skip filtering by 'collection'
     Layer& layer = data->layers.back();
 
-    for (auto& it : tile.features) {
-        Feature feature(m_id);
+    for (auto& entry : m_store->buckets) {
+        auto& bucket = entry.second;
+        if (!intersects(bucket.bounds, tileBounds)) { continue; }
+
+        const auto& tile = bucket.tiles->getTile(id.z, id.x, id.y);
 
-        if (geometry::geometry<int16_t>::visit(it.geometry, add_geometry{ feature })) {
-            feature.props = m_store->properties[it.id.get<uint64_t>()];
-            layer.features.emplace_back(std::move(feature));
+        for (auto& it : tile.features) {
+            Feature feature(m_id, data->arena.get());
+
+            if (geometry::geometry<int16_t>::visit(it.geometry, add_geometry{ feature })) {
+                uint64_t index = it.id.get<uint64_t>();
+                feature.props = m_store->features.at(bucket.features[index >> 1]).properties;
+                if (index & 1) { feature.props.set("label_placement", 1.0); }
+
+                layer.features.emplace_back(std::move(feature));
+            }
         }
     }
 
-
     return data;
 }
 
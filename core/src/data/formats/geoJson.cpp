@@ -1,161 +1,366 @@
 #include "data/formats/geoJson.h"
 
-#include "data/propertyItem.h"
 #include "log.h"
 #include "tile/tileTask.h"
 #include "util/geom.h"
 #include "util/mapProjection.h"
 
 #include "glm/glm.hpp"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
+#include <cstring>
+
+// Number of features read between checks for cancellation
+#define CANCEL_CHECK_INTERVAL 64
 
 namespace Tangram {
 
-bool GeoJson::isFeatureCollection(const JsonValue& _in) {
+namespace {
 
-    // A FeatureCollection must have a "type" of "FeatureCollection"
-    // and a member named "features" that is an array.
-    // http://geojson.org/geojson-spec.html#feature-collection-objects
+using Type = GeoJson::FeatureData::Type;
 
-    auto type = _in.FindMember("type");
-    if (type == _in.MemberEnd() || !type->value.IsString() ||
-        std::strcmp(type->value.GetString(), "FeatureCollection") != 0) {
-        return false;
+Type geometryType(const char* _name) {
+    if (std::strcmp(_name, "Point") == 0) { return Type::point; }
+    if (std::strcmp(_name, "MultiPoint") == 0) { return Type::multiPoint; }
+    if (std::strcmp(_name, "LineString") == 0) { return Type::lineString; }
+    if (std::strcmp(_name, "MultiLineString") == 0) { return Type::multiLineString; }
+    if (std::strcmp(_name, "Polygon") == 0) { return Type::polygon; }
+    if (std::strcmp(_name, "MultiPolygon") == 0) { return Type::multiPolygon; }
+    return Type::none;
+}
+
+/* RapidJSON SAX handler that collects one feature at a time.
+ *
+ * Positions are recorded independent of the geometry type, which may come
+ * after the coordinates: Numbers appear at the same nesting level of the
+ * coordinates array for all positions. Closing an array one level above
+ * ends a line or polygon ring, two levels above ends a polygon. */
+class FeatureReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, FeatureReader> {
+
+public:
+
+    FeatureReader(const std::function<void(const std::string&)>& _onLayer,
+                  const std::function<bool(GeoJson::FeatureData&)>& _onFeature)
+        : m_onLayer(_onLayer), m_onFeature(_onFeature) {}
+
+    bool Null() { return true; }
+    bool Bool(bool _value) { return value(double(_value)); }
+    bool Int(int _value) { return _value >= 0 ? Uint64(_value) : number(_value); }
+    bool Uint(unsigned _value) { return Uint64(_value); }
+    bool Int64(int64_t _value) { return _value >= 0 ? Uint64(_value) : number(double(_value)); }
+
+    bool Uint64(uint64_t _value) {
+        if ((top() == Frame::feature || top() == Frame::document) && m_key == "id") {
+            m_feature.hasId = true;
+            m_feature.id = _value;
+            return true;
+        }
+        return number(double(_value));
+    }
+    bool Double(double _value) { return number(_value); }
+
+    bool String(const char* _str, rapidjson::SizeType _length, bool _copy) {
+        switch (top()) {
+        case Frame::properties:
+            m_feature.properties.emplace_back(m_keys.get(m_key), std::string(_str, _length));
+            break;
+        case Frame::geometry:
+            if (m_key == "type") { m_feature.type = geometryType(_str); }
+            break;
+        case Frame::document:
+            // A document with a geometry type is a geometry itself. Keep
+            // the type of a Feature geometry read before "type": "Feature"
+            if (m_key == "type") {
+                Type type = geometryType(_str);
+                if (type != Type::none) { m_feature.type = type; }
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
     }
 
-    auto features = _in.FindMember("features");
-    if (features == _in.MemberEnd() || !features->value.IsArray()) {
-        return false;
+    bool Key(const char* _str, rapidjson::SizeType _length, bool _copy) {
+        m_key.assign(_str, _length);
+        return true;
     }
 
-    return true;
+    bool StartObject() {
+        Frame frame = Frame::skip;
+
+        switch (top()) {
+        case Frame::none:
+            frame = Frame::document;
+            break;
+        case Frame::document:
+            if (m_key == "geometry") { frame = Frame::geometry; }
+            else if (m_key == "properties") { frame = Frame::properties; }
+            else {
+                // Named FeatureCollection
+                frame = Frame::layer;
+                m_layerName = m_key;
+            }
+            break;
+        case Frame::features:
+            frame = Frame::feature;
+            m_feature.clear();
+            break;
+        case Frame::feature:
+            if (m_key == "geometry") { frame = Frame::geometry; }
+            else if (m_key == "properties") { frame = Frame::properties; }
+            break;
+        default:
+            break;
+        }
+        m_stack.push_back(frame);
+        return true;
+    }
 
-}
+    bool EndObject(rapidjson::SizeType _memberCount) {
+        Frame frame = top();
+        m_stack.pop_back();
 
-Point GeoJson::getPoint(const JsonValue& _in, const Transform& _proj) {
-    return _proj(glm::dvec2(_in[0].GetDouble(), _in[1].GetDouble()));
-}
+        if (frame == Frame::feature ||
+            (frame == Frame::document && m_feature.type != Type::none)) {
+            return emitFeature();
+        }
+        return true;
+    }
 
-Line GeoJson::getLine(const JsonValue& _in, const Transform& _proj) {
+    bool StartArray() {
+        Frame frame = Frame::skip;
+
+        switch (top()) {
+        case Frame::document:
+        case Frame::layer:
+            if (m_key == "features") {
+                frame = Frame::features;
+                m_onLayer(top() == Frame::layer ? m_layerName : std::string());
+                m_hasLayer = true;
+            } else if (m_key == "coordinates" && top() == Frame::document) {
+                frame = Frame::coordinates;
+                startCoordinates();
+            }
+            break;
+        case Frame::geometry:
+            if (m_key == "coordinates") {
+                frame = Frame::coordinates;
+                startCoordinates();
+            }
+            break;
+        case Frame::coordinates:
+            frame = Frame::coordinates;
+            m_depth++;
+            m_component = 0;
+            break;
+        default:
+            break;
+        }
+        m_stack.push_back(frame);
+        return true;
+    }
 
-    Line line;
-    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        line.push_back(getPoint(*itr, _proj));
+    bool EndArray(rapidjson::SizeType _elementCount) {
+        Frame frame = top();
+        m_stack.pop_back();
+
+        if (frame != Frame::coordinates) { return true; }
+
+        // Arrays closed before the first number, e.g. an empty leading
+        // line, end nothing but still leave their nesting level
+        if (m_positionDepth > 0) {
+            if (m_depth == m_positionDepth) {
+                if (m_component >= 2) { m_feature.coordinates.push_back(m_position); }
+            } else if (m_depth == m_positionDepth - 1) {
+                m_feature.lineEnds.push_back(uint32_t(m_feature.coordinates.size()));
+            } else if (m_depth == m_positionDepth - 2) {
+                m_feature.polygonEnds.push_back(uint32_t(m_feature.lineEnds.size()));
+            }
+        }
+        m_depth--;
+        return true;
     }
-    return line;
 
-}
+private:
+
+    enum class Frame : uint8_t {
+        none,
+        document,
+        layer,
+        features,
+        feature,
+        geometry,
+        coordinates,
+        properties,
+        skip,
+    };
 
-Polygon GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj) {
+    Frame top() const { return m_stack.empty() ? Frame::none : m_stack.back(); }
 
-    Polygon polygon;
-    for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        polygon.push_back(getLine(*itr, _proj));
+    void startCoordinates() {
+        m_feature.coordinates.clear();
+        m_feature.lineEnds.clear();
+        m_feature.polygonEnds.clear();
+        m_depth = 1;
+        m_positionDepth = 0;
+        m_component = 0;
     }
-    return polygon;
 
-}
+    bool number(double _value) {
+        if (top() != Frame::coordinates) { return value(_value); }
 
-Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
+        // The first number determines the nesting level of positions
+        if (m_positionDepth == 0) { m_positionDepth = m_depth; }
 
-    std::vector<PropertyItem> items;
-    items.reserve(_in.MemberCount());
-
-    for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
+        if (m_depth == m_positionDepth && m_component < 2) {
+            m_position[m_component] = _value;
+        }
+        m_component++;
+        return true;
+    }
 
-        const auto& name = it->name.GetString();
-        const auto& value = it->value;
-        if (value.IsNumber()) {
-            items.emplace_back(name, value.GetDouble());
-        } else if (it->value.IsString()) {
-            items.emplace_back(name, value.GetString());
-        } else if (it->value.IsBool()) {
-            items.emplace_back(name, double(value.GetBool()));
+    bool value(double _value) {
+        if (top() == Frame::properties) {
+            m_feature.properties.emplace_back(m_keys.get(m_key), _value);
         }
+        return true;
     }
 
-    Properties properties;
-    properties.sourceId = _sourceId;
-    properties.setSorted(std::move(items));
-    properties.sort();
+    bool emitFeature() {
+        if (m_feature.type == Type::none) { return true; }
 
-    return properties;
+        if (!m_hasLayer) {
+            m_onLayer(std::string());
+            m_hasLayer = true;
+        }
+        bool proceed = m_onFeature(m_feature);
+        m_feature.clear();
+        return proceed;
+    }
 
-}
+    const std::function<void(const std::string&)>& m_onLayer;
+    const std::function<bool(GeoJson::FeatureData&)>& m_onFeature;
 
-Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+    std::vector<Frame> m_stack;
+    std::string m_key;
+    // Property keys, interned once per distinct name
+    PropertyKeyCache m_keys;
+    std::string m_layerName;
+    bool m_hasLayer = false;
 
-    Feature feature;
+    GeoJson::FeatureData m_feature;
 
-    // Copy properties into tile data
-    auto properties = _in.FindMember("properties");
-    if (properties != _in.MemberEnd()) {
-        feature.props = getProperties(properties->value, _sourceId);
-    }
+    // Nesting level in the coordinates array and the level of positions
+    int m_depth = 0;
+    int m_positionDepth = 0;
+    // Index of the next number in the current position
+    int m_component = 0;
+    glm::dvec2 m_position;
+};
 
-    // Copy geometry into tile data
-    const JsonValue& geometry = _in["geometry"];
-    const JsonValue& coords = geometry["coordinates"];
-    const std::string& geometryType = geometry["type"].GetString();
+}
 
-    if (geometryType.compare("Point") == 0) {
+bool GeoJson::read(const char* _bytes, size_t _length,
+                   const std::function<void(const std::string& _name)>& _onLayer,
+                   const std::function<bool(FeatureData& _feature)>& _onFeature,
+                   const char** _error, size_t* _errorOffset) {
 
-        feature.geometryType = GeometryType::points;
-        feature.points.push_back(getPoint(coords, _proj));
+    FeatureReader handler(_onLayer, _onFeature);
+    rapidjson::MemoryStream stream(_bytes, _length);
+    rapidjson::Reader reader;
 
-    } else if (geometryType.compare("MultiPoint") == 0) {
+    auto result = reader.Parse(stream, handler);
 
-        feature.geometryType = GeometryType::points;
-        for (auto pointCoords = coords.Begin(); pointCoords != coords.End(); ++pointCoords) {
-            feature.points.push_back(getPoint(*pointCoords, _proj));
-        }
+    *_error = nullptr;
+    *_errorOffset = 0;
+    if (result.IsError()) {
+        *_error = rapidjson::GetParseError_En(result.Code());
+        *_errorOffset = result.Offset();
+        return false;
+    }
+    return true;
+}
 
-    } else if (geometryType.compare("LineString") == 0) {
+Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId, PropertyKeyCache& _keys) {
 
-        feature.geometryType = GeometryType::lines;
-        feature.lines.push_back(getLine(coords, _proj));
+    std::vector<PropertyItem> items;
+    items.reserve(_in.MemberCount());
 
-    } else if (geometryType.compare("MultiLineString") == 0) {
+    for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
 
-        feature.geometryType = GeometryType::lines;
-        for (auto lineCoords = coords.Begin(); lineCoords != coords.End(); ++lineCoords) {
-            feature.lines.push_back(getLine(*lineCoords, _proj));
-        }
+        const auto& value = it->value;
+        if (!value.IsNumber() && !value.IsString() && !value.IsBool()) { continue; }
 
-    } else if (geometryType.compare("Polygon") == 0) {
+        auto key = _keys.get(std::string(it->name.GetString(), it->name.GetStringLength()));
+        if (value.IsNumber()) {
+            items.emplace_back(key, value.GetDouble());
+        } else if (value.IsString()) {
+            items.emplace_back(key, value.GetString());
+        } else {
+            items.emplace_back(key, double(value.GetBool()));
+        }
+    }
 
-        feature.geometryType = GeometryType::polygons;
-        feature.polygons.push_back(getPolygon(coords, _proj));
+    return getProperties(std::move(items), _sourceId);
 
-    } else if (geometryType.compare("MultiPolygon") == 0) {
+}
 
-        feature.geometryType = GeometryType::polygons;
-        for (auto polyCoords = coords.Begin(); polyCoords != coords.End(); ++polyCoords) {
-            feature.polygons.push_back(getPolygon(*polyCoords, _proj));
-        }
+Properties GeoJson::getProperties(std::vector<PropertyItem>&& _items, int32_t _sourceId) {
 
-    }
+    Properties properties;
+    properties.sourceId = _sourceId;
+    properties.setSorted(std::move(_items));
+    properties.sort();
 
-    return feature;
+    return properties;
 
 }
 
-Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
-
-    Layer layer("");
+void GeoJson::setGeometry(const FeatureData& _feature, const Transform& _proj, Feature& _out) {
+
+    switch (_feature.type) {
+    case Type::point:
+    case Type::multiPoint:
+        _out.geometryType = GeometryType::points;
+        break;
+    case Type::lineString:
+    case Type::multiLineString:
+        _out.geometryType = GeometryType::lines;
+        break;
+    case Type::polygon:
+    case Type::multiPolygon:
+        _out.geometryType = GeometryType::polygons;
+        break;
+    default:
+        _out.geometryType = GeometryType::unknown;
+        return;
+    }
 
-    auto features = _in.FindMember("features");
+    // Positions, lines and rings map one to one to the flat geometry of a Feature
+    uint32_t pointOffset = _out.points.size();
+    uint32_t lineOffset = _out.lineEnds.size();
 
-    if (features == _in.MemberEnd()) {
-        LOGE("GeoJSON missing 'features' member");
-        return layer;
+    _out.points.reserve(pointOffset + _feature.coordinates.size());
+    for (auto& lonLat : _feature.coordinates) {
+        _out.points.push_back(_proj(lonLat));
     }
 
-    for (auto featureIt = features->value.Begin(); featureIt != features->value.End(); ++featureIt) {
-        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
+    if (_out.geometryType == GeometryType::points) { return; }
+
+    _out.lineEnds.reserve(lineOffset + _feature.lineEnds.size());
+    for (uint32_t end : _feature.lineEnds) {
+        _out.lineEnds.push_back(pointOffset + end);
     }
 
-    return layer;
+    if (_out.geometryType == GeometryType::lines) { return; }
 
+    _out.polygonEnds.reserve(_out.polygonEnds.size() + _feature.polygonEnds.size());
+    for (uint32_t end : _feature.polygonEnds) {
+        _out.polygonEnds.push_back(lineOffset + end);
+    }
 }
 
 std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId) {
@@ -163,16 +368,7 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, const MapPro
     auto& task = static_cast<const BinaryTileTask&>(_task);
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
-
-    // Parse data into a JSON document
-    const char* error;
-    size_t offset;
-    auto document = JsonParseBytes(task.rawTileData->data(), task.rawTileData->size(), &error, &offset);
-
-    if (error) {
-        LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
-        return tileData;
-    }
+    tileData->arena = std::make_shared<Arena>();
 
     BoundingBox tileBounds(_projection.TileBounds(task.tileId()));
     glm::dvec2 tileOrigin = {tileBounds.min.x, tileBounds.max.y*-1.0};
@@ -187,20 +383,34 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, const MapPro
         };
     };
 
-    // Transform JSON data into TileData using GeoJson functions
-    if (GeoJson::isFeatureCollection(document)) {
-        tileData->layers.push_back(GeoJson::getLayer(document, projFn, _sourceId));
-    } else {
-        for (auto layer = document.MemberBegin(); layer != document.MemberEnd(); ++layer) {
-            if (GeoJson::isFeatureCollection(layer->value)) {
-                tileData->layers.push_back(GeoJson::getLayer(layer->value, projFn, _sourceId));
-                tileData->layers.back().name = layer->name.GetString();
-            }
+    size_t numFeatures = 0;
+
+    auto onLayer = [&](const std::string& _name) {
+        tileData->layers.emplace_back(_name);
+    };
+
+    // Transform GeoJSON features into TileData while the JSON is parsed
+    auto onFeature = [&](FeatureData& _data) {
+        if (++numFeatures % CANCEL_CHECK_INTERVAL == 0 && _task.isCanceled()) {
+            return false;
         }
-    }
 
+        Feature feature(_sourceId, tileData->arena.get());
+        feature.props = getProperties(std::move(_data.properties), _sourceId);
+        setGeometry(_data, projFn, feature);
+
+        tileData->layers.back().features.push_back(std::move(feature));
+        return true;
+    };
+
+    const char* error;
+    size_t offset;
+    if (!read(task.rawTileData->data(), task.rawTileData->size(), onLayer, onFeature, &error, &offset)) {
+        if (_task.isCanceled()) { return nullptr; }
 
-    // Discard original JSON object and return TileData
+        LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
+        tileData->layers.clear();
+    }
 
     return tileData;
 
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "util/json.h"
+
+#include "glm/vec2.hpp"
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Tangram {
 
@@ -14,19 +19,69 @@ namespace GeoJson {
 
 using Transform = std::function<Point(glm::dvec2 _lonLat)>;
 
-bool isFeatureCollection(const JsonValue& _in);
+/* Geometry and properties of one GeoJSON feature as read by read() */
+struct FeatureData {
+
+    enum class Type : uint8_t {
+        none,
+        point,
+        multiPoint,
+        lineString,
+        multiLineString,
+        polygon,
+        multiPolygon,
+    };
+
+    Type type = Type::none;
+
+    // Numeric "id" of the feature, if it has one
+    bool hasId = false;
+    uint64_t id = 0;
+
+    // All positions of the geometry, as longitude and latitude
+    std::vector<glm::dvec2> coordinates;
+    // End of each line or polygon ring in coordinates
+    std::vector<uint32_t> lineEnds;
+    // End of each polygon in lineEnds
+    std::vector<uint32_t> polygonEnds;
 
-Point getPoint(const JsonValue& _in, const Transform& _proj);
+    // Numbers, strings and booleans of the feature's properties, in input order
+    std::vector<PropertyItem> properties;
 
-Line getLine(const JsonValue& _in, const Transform& _proj);
+    void clear() {
+        type = Type::none;
+        hasId = false;
+        id = 0;
+        coordinates.clear();
+        lineEnds.clear();
+        polygonEnds.clear();
+        properties.clear();
+    }
+};
 
-Polygon getPolygon(const JsonValue& _in, const Transform& _proj);
+/* Reads the features of the GeoJSON in @_bytes while parsing it, without
+ * building a JSON document. The input may be a FeatureCollection, an object
+ * of named FeatureCollections, a single Feature or a geometry.
+ *
+ * @_onLayer is called with the name of each FeatureCollection before its
+ * features, with an empty name for an unnamed one. @_onFeature is called for
+ * each feature with a geometry and may return false to stop reading.
+ *
+ * Returns false when the input is not valid JSON or reading was stopped,
+ * with a message in @_error and its position in @_errorOffset. */
+bool read(const char* _bytes, size_t _length,
+          const std::function<void(const std::string& _name)>& _onLayer,
+          const std::function<bool(FeatureData& _feature)>& _onFeature,
+          const char** _error, size_t* _errorOffset);
 
-Properties getProperties(const JsonValue& _in, int32_t _sourceId);
+// Properties of the JSON object @_in, with keys interned through @_keys
+Properties getProperties(const JsonValue& _in, int32_t _sourceId, PropertyKeyCache& _keys);
 
-Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+// Sorted properties of @_items
+Properties getProperties(std::vector<PropertyItem>&& _items, int32_t _sourceId);
 
-Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+// Append the geometry of @_feature to @_out, transformed by @_proj
+void setGeometry(const FeatureData& _feature, const Transform& _proj, Feature& _out);
 
 std::shared_ptr<TileData> parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId);
 
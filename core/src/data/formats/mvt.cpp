@@ -5,6 +5,7 @@
 #include "log.h"
 #include "platform.h"
 #include "util/geom.h"
+#include "util/varint.h"
 
 #include <algorithm>
 #include <iterator>
@@ -20,11 +21,148 @@
 #define LAYER_VALUE 4
 #define LAYER_TILE_EXTENT 5
 
+// Number of features parsed between checks for cancellation
+#define CANCEL_CHECK_INTERVAL 64
+
 namespace Tangram {
 
+// Decodes lazily parsed geometry of the features of one layer
+struct MvtGeometryDecoder : public GeometryDecoder {
+
+    // Keeps the encoded geometry alive
+    std::shared_ptr<std::vector<char>> rawData;
+
+    // Arena of the TileData, if any
+    Arena* arena = nullptr;
+
+    int tileExtent = 0;
+    int winding = 0;
+
+    void decode(const char* _data, size_t _size, Feature& _feature) const override {
+        Mvt::ParserContext ctx(_feature.props.sourceId);
+        ctx.arena = arena;
+        ctx.tileExtent = tileExtent;
+        ctx.winding = winding;
+
+        // Malformed geometry is found only now, after the tile was parsed:
+        // The feature is left without geometry and skipped
+        try {
+            Mvt::setGeometry(ctx, Mvt::getGeometry(ctx, protobuf::message(_data, _size)), _feature);
+        } catch(const std::exception& e) {
+            LOGE("Cannot decode feature geometry: %s", e.what());
+            _feature.points.clear();
+            _feature.lineEnds.clear();
+            _feature.polygonEnds.clear();
+        }
+    }
+};
+
 Mvt::Geometry Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
 
-    Geometry geometry;
+    auto& values = _ctx.varints;
+    values.clear();
+
+    if (!Varint::decode(reinterpret_cast<const uint8_t*>(_geomIn.getData()),
+                        reinterpret_cast<const uint8_t*>(_geomIn.getEnd()), values)) {
+        return getGeometryScalar(_ctx, _geomIn);
+    }
+
+    size_t n = values.size();
+
+    // Count points and lines from the commands first: Vectors regrown in
+    // the arena would leave their previous blocks unused
+    size_t numPoints = 0;
+    size_t numLines = 0;
+
+    for (size_t i = 0; i < n; ) {
+
+        uint32_t cmdData = values[i++];
+        uint32_t cmd = cmdData & 0x7;
+        uint32_t cmdRepeat = cmdData >> 3;
+
+        if (cmd == GeomCmd::moveTo || cmd == GeomCmd::lineTo) {
+            // A command without its parameters is left to the reference decoder
+            if (cmdRepeat == 0 || n - i < 2 * size_t(cmdRepeat)) {
+                return getGeometryScalar(_ctx, _geomIn);
+            }
+            numPoints += cmdRepeat;
+            if (cmd == GeomCmd::moveTo) { numLines += cmdRepeat; }
+            i += 2 * cmdRepeat;
+
+        } else if (cmd == GeomCmd::closePath && cmdRepeat == 1) {
+            numPoints++;
+            numLines++;
+        } else {
+            // Unknown commands or repeated closePath
+            return getGeometryScalar(_ctx, _geomIn);
+        }
+    }
+
+    Geometry geometry(_ctx.arena);
+    geometry.coordinates.reserve(numPoints);
+    geometry.sizes.reserve(numLines);
+
+    double invTileExtent = (1.0/(_ctx.tileExtent-1.0));
+
+    int64_t x = 0;
+    int64_t y = 0;
+
+    size_t numCoordinates = 0;
+    size_t i = 0;
+
+    while (i < n) {
+
+        uint32_t cmdData = values[i++];
+        uint32_t cmd = cmdData & 0x7;
+        uint32_t cmdRepeat = cmdData >> 3;
+
+        if (cmd == GeomCmd::moveTo || cmd == GeomCmd::lineTo) {
+            // Decode the whole run of points
+            for (const uint32_t* it = &values[i], *end = it + 2 * cmdRepeat; it != end; it += 2) {
+                // Each point of a moveTo starts a new line
+                if (cmd == GeomCmd::moveTo) {
+                    if (geometry.coordinates.size() > 0) {
+                        geometry.sizes.push_back(numCoordinates);
+                    }
+                    numCoordinates = 0;
+                }
+
+                x += Varint::zigzag(it[0]);
+                y += Varint::zigzag(it[1]);
+
+                Point p;
+                p.x = invTileExtent * (double)x;
+                p.y = invTileExtent * (double)(_ctx.tileExtent - y);
+
+                if (numCoordinates == 0 || geometry.coordinates.back() != p) {
+                    geometry.coordinates.push_back(p);
+                    numCoordinates++;
+                }
+            }
+            i += 2 * cmdRepeat;
+
+        } else if (numCoordinates > 0) {
+            // end of a polygon, push first point in this line as last and push line to poly
+            geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
+            geometry.sizes.push_back(numCoordinates + 1);
+            numCoordinates = 0;
+        } else {
+            // closePath without a line
+            return getGeometryScalar(_ctx, _geomIn);
+        }
+    }
+
+    // Enter the last line
+    if (numCoordinates > 0) {
+        geometry.sizes.push_back(numCoordinates);
+    }
+
+    return geometry;
+}
+
+Mvt::Geometry Mvt::getGeometryScalar(ParserContext& _ctx, protobuf::message _geomIn) {
+
+    Geometry geometry(_ctx.arena);
 
     GeomCmd cmd = GeomCmd::moveTo;
     uint32_t cmdRepeat = 0;
@@ -85,11 +223,12 @@ Mvt::Geometry Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
 
 Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
 
-    Feature feature(_ctx.sourceId);
+    Feature feature(_ctx.sourceId, _ctx.arena);
 
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
 
+    protobuf::message geometryMsg;
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -130,7 +269,7 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
                 break;
             // Actual geometry data
             case FEATURE_GEOM:
-                _ctx.geometry = getGeometry(_ctx, _featureIn.getMessage());
+                geometryMsg = _featureIn.getMessage();
                 break;
 
             default:
@@ -150,58 +289,91 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
     }
     feature.props.setSorted(std::move(properties));
 
-    switch(feature.geometryType) {
+    if (!geometryMsg) { return feature; }
+
+    // The exterior winding of the tile is determined by its first polygon,
+    // so polygons are decoded until it is known
+    if (_ctx.lazyGeometry && _ctx.decoder &&
+        (feature.geometryType != GeometryType::polygons || _ctx.winding != 0)) {
+        feature.encoded.decoder = _ctx.decoder.get();
+        feature.encoded.data = geometryMsg.getData();
+        feature.encoded.size = geometryMsg.getEnd() - geometryMsg.getData();
+        return feature;
+    }
+
+    setGeometry(_ctx, getGeometry(_ctx, geometryMsg), feature);
+
+    return feature;
+}
+
+void Mvt::setGeometry(ParserContext& _ctx, Geometry&& _geometry, Feature& _feature) {
+
+    // Each line or ring ends at most one line and one polygon. Lines closed
+    // before a moveTo leave empty sizes
+    auto numLines = [&]() {
+        return size_t(std::count_if(_geometry.sizes.begin(), _geometry.sizes.end(),
+                                    [](int _length) { return _length > 0; }));
+    };
+
+    switch(_feature.geometryType) {
         case GeometryType::points:
-            feature.points.insert(feature.points.begin(),
-                                  _ctx.geometry.coordinates.begin(),
-                                  _ctx.geometry.coordinates.end());
+            _feature.points = std::move(_geometry.coordinates);
             break;
 
         case GeometryType::lines:
         {
-            auto pos = _ctx.geometry.coordinates.begin();
-            for (int length : _ctx.geometry.sizes) {
+            _feature.points = std::move(_geometry.coordinates);
+            _feature.lineEnds.reserve(numLines());
+            uint32_t end = 0;
+            for (int length : _geometry.sizes) {
                 if (length == 0) { continue; }
-                Line line;
-                line.reserve(length);
-                line.insert(line.begin(), pos, pos + length);
-                pos += length;
-                feature.lines.emplace_back(std::move(line));
+                end += length;
+                _feature.lineEnds.push_back(end);
             }
             break;
         }
         case GeometryType::polygons:
         {
-            auto pos = _ctx.geometry.coordinates.begin();
-            auto rpos = _ctx.geometry.coordinates.rend();
-            for (int length : _ctx.geometry.sizes) {
+            // Rings are reordered and compacted in place
+            _feature.points = std::move(_geometry.coordinates);
+            auto& points = _feature.points;
+
+            size_t rings = numLines();
+            _feature.lineEnds.reserve(rings);
+            _feature.polygonEnds.reserve(rings);
+
+            size_t read = 0;
+            size_t write = 0;
+            bool polygonStarted = false;
+
+            for (int length : _geometry.sizes) {
                 if (length == 0) { continue; }
-                float area = signedArea(pos, pos + length);
-                if (area == 0) {
-                    pos += length;
-                    rpos -= length;
-                    continue;
-                }
+                auto ring = points.begin() + read;
+                read += length;
+
+                float area = signedArea(ring, ring + length);
+                if (area == 0) { continue; }
+
                 int winding = area > 0 ? 1 : -1;
                 // Determine exterior winding from first polygon.
                 if (_ctx.winding == 0) {
                     _ctx.winding = winding;
                 }
-                Line line;
-                line.reserve(length);
-                if (_ctx.winding > 0) {
-                    line.insert(line.end(), pos, pos + length);
-                } else {
-                    line.insert(line.end(), rpos - length, rpos);
-                }
-                pos += length;
-                rpos -= length;
-                if (winding == _ctx.winding || feature.polygons.empty()) {
+                if (winding == _ctx.winding || !polygonStarted) {
                     // This is an exterior polygon.
-                    feature.polygons.emplace_back();
+                    if (polygonStarted) { _feature.endPolygon(); }
+                    polygonStarted = true;
                 }
-                feature.polygons.back().push_back(std::move(line));
+                auto dest = points.begin() + write;
+                if (dest != ring) { std::copy(ring, ring + length, dest); }
+                if (_ctx.winding < 0) { std::reverse(dest, dest + length); }
+
+                write += length;
+                _feature.lineEnds.push_back(uint32_t(write));
             }
+            points.resize(write);
+
+            if (polygonStarted) { _feature.endPolygon(); }
             break;
         }
         case GeometryType::unknown:
@@ -209,8 +381,6 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
         default:
             break;
     }
-
-    return feature;
 }
 
 Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
@@ -243,7 +413,7 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
                 continue;
             }
             case LAYER_KEY: {
-                _ctx.keys.push_back(_layerIn.string());
+                _ctx.keys.emplace_back(_layerIn.string());
                 break;
             }
             case LAYER_VALUE: {
@@ -306,9 +476,24 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
                   return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
               });
 
+    std::shared_ptr<MvtGeometryDecoder> decoder;
+    if (_ctx.lazyGeometry) {
+        decoder = std::make_shared<MvtGeometryDecoder>();
+        decoder->rawData = _ctx.rawData;
+        decoder->arena = _ctx.arena;
+        decoder->tileExtent = _ctx.tileExtent;
+        layer.decoder = decoder;
+    }
+    _ctx.decoder = decoder;
+
     layer.features.reserve(numFeatures);
     for (auto& featureItr : _ctx.featureMsgs) {
         do {
+            if (_ctx.canceled && layer.features.size() % CANCEL_CHECK_INTERVAL == 0 &&
+                *_ctx.canceled) {
+                return layer;
+            }
+
             auto featureMsg = featureItr.getMessage();
 
             layer.features.push_back(getFeature(_ctx, featureMsg));
@@ -316,22 +501,33 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
         } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
     }
 
+    // Polygons of this layer are only encoded once the winding is known
+    if (decoder) { decoder->winding = _ctx.winding; }
+
     return layer;
 }
 
-std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId) {
+std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId,
+                                         bool _lazyGeometry, bool _useArena) {
 
     auto tileData = std::make_shared<TileData>();
+    if (_useArena) { tileData->arena = std::make_shared<Arena>(); }
 
     auto& task = static_cast<const BinaryTileTask&>(_task);
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
     ParserContext ctx(_sourceId);
+    ctx.canceled = &_task.canceledFlag();
+    ctx.lazyGeometry = _lazyGeometry;
+    ctx.rawData = task.rawTileData;
+    ctx.arena = tileData->arena.get();
 
     try {
         while(item.next()) {
             if(item.tag == 3) {
                 tileData->layers.push_back(getLayer(ctx, item.getMessage()));
+
+                if (_task.isCanceled()) { return {}; }
             } else {
                 item.skip();
             }
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "data/tileData.h"
 #include "pbf/pbf.hpp"
 #include "util/variant.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,18 +19,26 @@ class MapProjection;
 namespace Mvt {
 
     struct Geometry {
-        std::vector<Point> coordinates;
-        std::vector<int> sizes;
+        Geometry(Arena* _arena = nullptr)
+            : coordinates(ArenaAllocator<Point>(_arena)),
+              sizes(ArenaAllocator<int>(_arena)) {}
+
+        ArenaVector<Point> coordinates;
+        ArenaVector<int> sizes;
     };
 
     struct ParserContext {
         ParserContext(int32_t _sourceId) : sourceId(_sourceId){}
 
         int32_t sourceId;
-        std::vector<std::string> keys;
+        // Arena of the parsed TileData, see TileData::arena
+        Arena* arena = nullptr;
+        // Keys of the layer, interned once for all its features
+        std::vector<PropertyKey> keys;
         std::vector<Value> values;
         std::vector<protobuf::message> featureMsgs;
-        Geometry geometry;
+        // Decoded varints of the current geometry
+        std::vector<uint32_t> varints;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
         // Key IDs sorted by Property key ordering
@@ -36,6 +46,16 @@ namespace Mvt {
 
         int tileExtent = 0;
         int winding = 0;
+
+        // Keep feature geometry encoded in rawData until it is styled,
+        // see Feature::decodeGeometry()
+        bool lazyGeometry = false;
+        std::shared_ptr<std::vector<char>> rawData;
+        // Decoder of the current layer
+        std::shared_ptr<GeometryDecoder> decoder;
+
+        // Set while parsing for a TileTask: Parsing stops when it is canceled
+        const std::atomic<bool>* canceled = nullptr;
     };
 
     enum GeomCmd {
@@ -44,13 +64,24 @@ namespace Mvt {
         closePath = 7
     };
 
+    // Decodes all varints of @_geomIn at once, see Varint::decode()
     Geometry getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
 
+    // Reference decoder reading one varint at a time. getGeometry()
+    // falls back to it for geometry that is not valid
+    Geometry getGeometryScalar(ParserContext& _ctx, protobuf::message _geomIn);
+
+    // Add @_geometry to @_feature as points, lines or polygons of its geometryType
+    void setGeometry(ParserContext& _ctx, Geometry&& _geometry, Feature& _feature);
+
     Feature getFeature(ParserContext& _ctx, protobuf::message _featureIn);
 
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
-    std::shared_ptr<TileData> parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId);
+    // Geometry is decoded lazily when @_lazyGeometry is set. With @_useArena
+    // the geometry is allocated from an Arena of the TileData.
+    std::shared_ptr<TileData> parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId,
+                                        bool _lazyGeometry = true, bool _useArena = true);
 
 } // namespace Mvt
 
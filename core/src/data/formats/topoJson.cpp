@@ -82,12 +82,11 @@ Point TopoJson::getPoint(const JsonValue& _coordinates, const Topology& _topolog
 
 }
 
-Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
-
-    Line line;
+void TopoJson::addLine(const JsonValue& _arcs, const Topology& _topology, Feature& _feature) {
 
     if (!_arcs.IsArray()) {
-        return line;
+        _feature.endLine();
+        return;
     }
 
     for (auto arcIt = _arcs.Begin(); arcIt != _arcs.End(); ++arcIt) {
@@ -122,46 +121,39 @@ Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
         }
 
         for (auto pointIt = begin; pointIt != end; pointIt += inc) {
-            line.push_back(*pointIt);
+            _feature.points.push_back(*pointIt);
         }
 
     }
 
-    return line;
+    _feature.endLine();
 
 }
 
-Polygon TopoJson::getPolygon(const JsonValue& _arcSets, const Topology& _topology) {
-
-    Polygon polygon;
-
-    if (!_arcSets.IsArray()) {
-        return polygon;
-    }
-
-    for (auto arcSetIt = _arcSets.Begin(); arcSetIt != _arcSets.End(); ++arcSetIt) {
-
-        auto ring = getLine(*arcSetIt, _topology);
-        polygon.push_back(ring);
+void TopoJson::addPolygon(const JsonValue& _arcSets, const Topology& _topology, Feature& _feature) {
 
+    if (_arcSets.IsArray()) {
+        for (auto arcSetIt = _arcSets.Begin(); arcSetIt != _arcSets.End(); ++arcSetIt) {
+            addLine(*arcSetIt, _topology, _feature);
+        }
     }
 
-    return polygon;
+    _feature.endPolygon();
 
 }
 
-Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source) {
+Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source, Arena* _arena) {
 
     static const JsonValue keyProperties("properties");
     static const JsonValue keyType("type");
     static const JsonValue keyCoordinates("coordinates");
     static const JsonValue keyArcs("arcs");
 
-    Feature feature;
+    Feature feature(_source, _arena);
 
     auto propertiesIt = _geometry.FindMember(keyProperties);
     if (propertiesIt != _geometry.MemberEnd() && propertiesIt->value.IsObject()) {
-        feature.props = GeoJson::getProperties(propertiesIt->value, _source);
+        feature.props = GeoJson::getProperties(propertiesIt->value, _source, _topology.keys);
     }
 
     std::string type;
@@ -191,7 +183,7 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         feature.geometryType = GeometryType::lines;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.lines.push_back(getLine(arcsIt->value, _topology));
+            addLine(arcsIt->value, _topology, feature);
         }
     } else if (type == "MultiLineString") {
         feature.geometryType = GeometryType::lines;
@@ -199,14 +191,14 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.lines.push_back(getLine(*arcList, _topology));
+                addLine(*arcList, _topology, feature);
             }
         }
     } else if (type == "Polygon") {
         feature.geometryType = GeometryType::polygons;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.polygons.push_back(getPolygon(arcsIt->value, _topology));
+            addPolygon(arcsIt->value, _topology, feature);
         }
     } else if (type == "MultiPolygon") {
         feature.geometryType = GeometryType::polygons;
@@ -214,7 +206,7 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.polygons.push_back(getPolygon(*arcList, _topology));
+                addPolygon(*arcList, _topology, feature);
             }
         }
     } else if (type == "GeometryCollection") {
@@ -225,7 +217,8 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
 
 }
 
-Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology, int32_t _source) {
+Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology, int32_t _source,
+                         Arena* _arena) {
 
     Layer layer(_objectIt->name.GetString());
 
@@ -235,7 +228,7 @@ Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _
         auto geometries = object.FindMember("geometries");
         if (geometries != object.MemberEnd() && geometries->value.IsArray()) {
             for (auto it = geometries->value.Begin(); it != geometries->value.End(); ++it) {
-                layer.features.push_back(getFeature(*it, _topology, _source));
+                layer.features.push_back(getFeature(*it, _topology, _source, _arena));
             }
         }
     }
@@ -249,6 +242,7 @@ std::shared_ptr<TileData> TopoJson::parseTile(const TileTask& _task, const MapPr
     auto& task = static_cast<const BinaryTileTask&>(_task);
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
+    tileData->arena = std::make_shared<Arena>();
 
     // Parse data into a JSON document
     const char* error;
@@ -282,7 +276,7 @@ std::shared_ptr<TileData> TopoJson::parseTile(const TileTask& _task, const MapPr
     if (objectsIt == document.MemberEnd()) { return tileData; }
     auto& objects = objectsIt->value;
     for (auto layer = objects.MemberBegin(); layer != objects.MemberEnd(); ++layer) {
-        tileData->layers.push_back(TopoJson::getLayer(layer, topology, _source));
+        tileData->layers.push_back(TopoJson::getLayer(layer, topology, _source, tileData->arena.get()));
     }
 
     // Discard JSON object and return TileData
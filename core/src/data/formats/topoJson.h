@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "data/tileData.h"
 #include "util/json.h"
 
@@ -21,19 +22,26 @@ struct Topology {
     glm::dvec2 translate = { 0., 0. };
     std::vector<Line> arcs;
     Transform proj;
+    // Keys of feature properties, interned once per parse
+    mutable PropertyKeyCache keys;
 };
 
 Topology getTopology(const JsonDocument& _document, const Transform& _proj);
 
 Point getPoint(const JsonValue& _coordinates, const Topology& _topology, glm::ivec2& _cursor);
 
-Line getLine(const JsonValue& _arcs, const Topology& _topology);
+// Append the line made of @_arcs to the geometry of @_feature
+void addLine(const JsonValue& _arcs, const Topology& _topology, Feature& _feature);
 
-Polygon getPolygon(const JsonValue& _arcs, const Topology& _topology);
+// Append the polygon with the rings made of @_arcs to the geometry of @_feature
+void addPolygon(const JsonValue& _arcs, const Topology& _topology, Feature& _feature);
 
-Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId);
+// Geometry is allocated from @_arena when given, see TileData::arena
+Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId,
+                   Arena* _arena = nullptr);
 
-Layer getLayer(JsonValue::MemberIterator& _object, const Topology& _topology, int32_t _sourceId);
+Layer getLayer(JsonValue::MemberIterator& _object, const Topology& _topology, int32_t _sourceId,
+               Arena* _arena = nullptr);
 
 std::shared_ptr<TileData> parseTile(const TileTask& _task, const MapProjection& _projection, int32_t _sourceId);
 
@@ -2,8 +2,10 @@
 
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
+#include "util/zlibHelper.h"
 #include "log.h"
 
+#include <algorithm>
 #include <list>
 #include <mutex>
 #include <unordered_map>
@@ -15,8 +17,15 @@ struct RawCache {
     // Used to ensure safe access from async loading threads
     std::mutex m_mutex;
 
+    struct CacheEntry {
+        TileID id;
+        std::shared_ptr<std::vector<char>> data;
+        bool compressed;
+        // Size of the data when inflated
+        size_t inflatedSize;
+    };
+
     // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
     using CacheList = std::list<CacheEntry>;
     using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
 
@@ -24,6 +33,9 @@ struct RawCache {
     CacheList m_cacheList;
     int m_usage = 0;
     int m_maxUsage = 0;
+    size_t m_inflatedUsage = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
 
     bool get(BinaryTileTask& _task) {
 
@@ -37,29 +49,35 @@ struct RawCache {
         if (it != m_cacheMap.end()) {
             // Move cached entry to start of list
             m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
+            _task.rawTileData = m_cacheList.front().data;
+            _task.compressed = m_cacheList.front().compressed;
 
+            m_hits++;
             return true;
         }
 
+        m_misses++;
         return false;
     }
-    void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
+    void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef,
+             bool compressed, size_t inflatedSize) {
 
         if (m_maxUsage <= 0) { return; }
 
         std::lock_guard<std::mutex> lock(m_mutex);
         TileID id(tileID.x, tileID.y, tileID.z);
 
-        m_cacheList.push_front({id, rawDataRef});
+        m_cacheList.push_front({id, rawDataRef, compressed, inflatedSize});
         m_cacheMap[id] = m_cacheList.begin();
 
         m_usage += rawDataRef->size();
+        m_inflatedUsage += inflatedSize;
 
         while (m_usage > m_maxUsage) {
             if (m_cacheList.empty()) {
                 LOGE("Error: invalid cache state!");
                 m_usage = 0;
+                m_inflatedUsage = 0;
                 break;
             }
 
@@ -67,18 +85,31 @@ struct RawCache {
             //        double(m_cacheUsage) / (1024*1024));
 
             auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
+            m_usage -= entry.data->size();
+            m_inflatedUsage -= entry.inflatedSize;
 
-            m_cacheMap.erase(entry.first);
+            m_cacheMap.erase(entry.id);
             m_cacheList.pop_back();
         }
     }
 
-    void clear() {
+    void stats(TileSource::RawCacheStats& _stats) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        _stats.hits += m_hits;
+        _stats.misses += m_misses;
+        _stats.entries += m_cacheList.size();
+        _stats.usage += m_usage;
+        _stats.inflatedUsage += m_inflatedUsage;
+    }
+
+    size_t clear() {
         std::lock_guard<std::mutex> lock(m_mutex);
+        size_t usage = m_usage;
         m_cacheMap.clear();
         m_cacheList.clear();
         m_usage = 0;
+        m_inflatedUsage = 0;
+        return usage;
     }
 };
 
@@ -97,8 +128,40 @@ bool MemoryCacheDataSource::cacheGet(BinaryTileTask& _task) {
     return m_cache->get(_task);
 }
 
-void MemoryCacheDataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
-    m_cache->put(_tileID, _rawDataRef);
+void MemoryCacheDataSource::cachePut(BinaryTileTask& _task) {
+
+    auto data = _task.rawTileData;
+    if (!data || data->empty()) { return; }
+
+    size_t inflatedSize = data->size();
+    bool compressed = false;
+
+    // Raster images are compressed already
+    if (m_compressed && !_task.source().isRaster()) {
+        if (zlib::isGzip(data->data(), data->size())) {
+            // Kept as delivered, the inflated size is only estimated
+            inflatedSize = std::max(zlib::inflatedSizeHint(data->data(), data->size()), data->size());
+            compressed = true;
+            _task.compressed = true;
+
+        } else {
+            // The task keeps the data as delivered, only the cache holds the
+            // compressed copy
+            auto deflated = std::make_shared<std::vector<char>>();
+            if (zlib::deflate(data->data(), data->size(), *deflated) == 0) {
+                data = std::move(deflated);
+                compressed = true;
+            }
+        }
+    }
+
+    m_cache->put(_task.tileId(), data, compressed, inflatedSize);
+}
+
+void MemoryCacheDataSource::cacheStats(TileSource::RawCacheStats& _stats) const {
+    m_cache->stats(_stats);
+
+    if (next) { next->cacheStats(_stats); }
 }
 
 bool MemoryCacheDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
@@ -124,7 +187,7 @@ bool MemoryCacheDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTa
 
             auto& task = static_cast<BinaryTileTask&>(*_task);
 
-            if (task.hasData()) { cachePut(task.tileId(), task.rawTileData); }
+            if (task.hasData()) { cachePut(task); }
 
             _cb.func(_task);
         }});
@@ -139,4 +202,12 @@ void MemoryCacheDataSource::clear() {
     if (next) { next->clear(); }
 }
 
+size_t MemoryCacheDataSource::releaseCache() {
+    size_t size = m_cache->clear();
+
+    if (next) { size += next->releaseCache(); }
+
+    return size;
+}
+
 }
@@ -14,18 +14,32 @@ public:
 
     void clear() override;
 
+    size_t releaseCache() override;
+
     /* @_cacheSize: Set size of in-memory cache for tile data in bytes.
      * This cache holds unprocessed tile data for fast recreation of recently used tiles.
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* @_compressed: Keep tile data gzip compressed in the cache, so that it holds
+     * more tiles for its size. Data that is delivered compressed is kept as is,
+     * other data is compressed when cached while the loading task keeps it as
+     * delivered. Tasks of cache hits get the compressed data, which is inflated
+     * on the worker thread.
+     */
+    void setCompression(bool _compressed) { m_compressed = _compressed; }
+
+    void cacheStats(TileSource::RawCacheStats& _stats) const override;
+
 private:
     bool cacheGet(BinaryTileTask& _task);
 
-    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
+    void cachePut(BinaryTileTask& _task);
 
     std::unique_ptr<RawCache> m_cache;
 
+    bool m_compressed = false;
+
 };
 
 }
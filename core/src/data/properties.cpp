@@ -33,7 +33,7 @@ const Value& Properties::get(const std::string& key) const {
 
     const auto it = std::find_if(props.begin(), props.end(),
                                  [&](const auto& item) {
-                                     return item.key == key;
+                                     return item.key.str() == key;
                                  });
     if (it == props.end()) {
         return NOT_A_VALUE;
@@ -50,12 +50,24 @@ const Value& Properties::get(const std::string& key) const {
     return it->value;
 }
 
+const Value& Properties::get(const PropertyKey& key) const {
+
+    for (const auto& item : props) {
+        if (item.key == key) { return item.value; }
+    }
+    return NOT_A_VALUE;
+}
+
 void Properties::clear() { props.clear(); }
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
 }
 
+bool Properties::contains(const PropertyKey& key) const {
+    return !get(key).is<none_type>();
+}
+
 bool Properties::getNumber(const std::string& key, double& value) const {
     auto& it = get(key);
     if (it.is<double>()) {
@@ -129,7 +141,7 @@ void Properties::set(std::string key, std::string value) {
 
     auto it = std::lower_bound(props.begin(), props.end(), key,
                                [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+                                   return keyComparator(item.key.str(), key);
                                });
 
     if (it == props.end() || it->key != key) {
@@ -143,7 +155,7 @@ void Properties::set(std::string key, double value) {
 
     auto it = std::lower_bound(props.begin(), props.end(), key,
                                [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+                                   return keyComparator(item.key.str(), key);
                                });
 
     if (it == props.end() || it->key != key) {
@@ -159,7 +171,7 @@ std::string Properties::toJson() const {
 
     for (const auto& item : props) {
         bool last = (&item == &props.back());
-        json += "\"" + item.key + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
+        json += "\"" + item.key.str() + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
     }
 
     json += " }";
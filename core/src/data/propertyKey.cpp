@@ -0,0 +1,48 @@
+#include "data/propertyKey.h"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace Tangram {
+
+// Elements of an unordered_set keep their address on rehash
+struct KeyTable {
+    std::mutex mutex;
+    std::unordered_set<std::string> names;
+
+    const std::string* intern(const std::string& _name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return &*names.insert(_name).first;
+    }
+};
+
+static KeyTable& keyTable() {
+    // Leaked on purpose: keys may still be used by static objects at exit
+    static KeyTable* s_table = new KeyTable();
+    return *s_table;
+}
+
+static const std::string* emptyKey() {
+    static const std::string* s_empty = keyTable().intern("");
+    return s_empty;
+}
+
+PropertyKey::PropertyKey() : m_name(emptyKey()) {}
+
+PropertyKey::PropertyKey(const std::string& _name) : m_name(keyTable().intern(_name)) {}
+
+PropertyKey PropertyKeyCache::get(const std::string& _name) {
+    auto it = m_keys.find(_name);
+    if (it == m_keys.end()) {
+        it = m_keys.emplace(_name, PropertyKey(_name)).first;
+    }
+    return it->second;
+}
+
+size_t PropertyKey::internedCount() {
+    auto& table = keyTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names.size();
+}
+
+}
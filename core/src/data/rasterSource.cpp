@@ -27,7 +27,7 @@ public:
         }
     }
 
-    void process(TileBuilder& _tileBuilder) override {
+    bool parse(const MapProjection& _projection) override {
 
         auto source = reinterpret_cast<RasterSource*>(m_source.get());
 
@@ -36,10 +36,10 @@ public:
             m_texture = source->createTexture(*rawTileData);
         }
 
-        // Create tile geometries
-        if (!isSubTask()) {
-            BinaryTileTask::process(_tileBuilder);
-        }
+        // Sub-tasks only provide the texture, no tile geometries to build
+        if (isSubTask()) { return false; }
+
+        return BinaryTileTask::parse(_projection);
     }
 
     void complete() override {
@@ -109,13 +109,15 @@ std::shared_ptr<TileData> RasterSource::parse(const TileTask& _task, const MapPr
 
     Feature rasterFeature;
     rasterFeature.geometryType = GeometryType::polygons;
-    rasterFeature.polygons = { { {
-                                         {0.0f, 0.0f, 0.0f},
-                                         {1.0f, 0.0f, 0.0f},
-                                         {1.0f, 1.0f, 0.0f},
-                                         {0.0f, 1.0f, 0.0f},
-                                         {0.0f, 0.0f, 0.0f}
-                                 } } };
+    rasterFeature.points = {
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f}
+    };
+    rasterFeature.endLine();
+    rasterFeature.endPolygon();
     rasterFeature.props = Properties();
 
     tileData->layers.emplace_back("");
@@ -187,4 +189,18 @@ void RasterSource::clearRaster(const TileID &tileID) {
     }
 }
 
+size_t RasterSource::releaseRasters() {
+    size_t size = TileSource::releaseRasters();
+
+    for (auto it = m_textures.begin(); it != m_textures.end(); ) {
+        if (it->second.use_count() <= 1) {
+            if (it->second) { size += it->second->bufferSize(); }
+            it = m_textures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return size;
+}
+
 }
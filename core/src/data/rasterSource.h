@@ -41,6 +41,9 @@ public:
 
     virtual void clearRasters() override;
     virtual void clearRaster(const TileID& id) override;
+
+    /* Drops the textures that are not used by any tile */
+    virtual size_t releaseRasters() override;
     virtual bool isRaster() const override { return true; }
 
     std::shared_ptr<Texture> createTexture(const std::vector<char>& _rawTileData);
@@ -2,7 +2,11 @@
 
 #include "glm/vec3.hpp"
 #include "data/properties.h"
+#include "util/arena.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -38,8 +42,10 @@ Data heirarchy:
 
   A <Feature> contains a <GeometryType> denoting what variety of geometry is
   contained in the feature, a <Properties> struct describing the feature, and
-  one collection each of <Point>s, <Line>s, and <Polygon>s. Only the geometry
-  collection corresponding to the feature's geometryType should contain data.
+  its geometry in flat storage: All <Point>s of the feature in one vector, the
+  end of each line or polygon ring in that vector and the end of each polygon
+  in the vector of rings. lines() and polygons() give <LineRef>s and
+  <PolygonRef>s to these ranges.
 
   A <Properties> contains a sorted vector of key-value pairs storing the
   properties of a <Feature>
@@ -50,9 +56,22 @@ Data heirarchy:
 
   A <Line> is a collection of <Point>s.
 
+  <Line> and <Polygon> own their points and are used to build geometry, while
+  <LineRef> and <PolygonRef> refer to the geometry of a <Feature>.
+
   A <Point> is 3 32-bit floating point coordinates representing x, y, and z
   (in that order).
 
+  Parsers may keep the geometry of a <Feature> encoded until it is needed:
+  Its geometryType and properties are set, while points, lines and polygons
+  are empty until decodeGeometry() is called. Filters run on the properties
+  alone, so the geometry of features that no draw rule matches is never
+  decoded.
+
+  The geometry of the features of a <TileData> may be allocated from its
+  <Arena>, which lives as long as the TileData. Copies of a <Feature>
+  allocate their geometry from the heap.
+
 */
 namespace Tangram {
 
@@ -69,17 +88,232 @@ typedef std::vector<Point> Line;
 
 typedef std::vector<Line> Polygon;
 
+/* Points of a line or polygon ring in the geometry of a Feature */
+class LineRef {
+public:
+    using value_type = Point;
+
+    LineRef() {}
+    LineRef(const Point* _begin, const Point* _end) : m_begin(_begin), m_end(_end) {}
+    LineRef(const Line& _line) : m_begin(_line.data()), m_end(_line.data() + _line.size()) {}
+
+    const Point* begin() const { return m_begin; }
+    const Point* end() const { return m_end; }
+    size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+
+    const Point& operator[](size_t _i) const { return m_begin[_i]; }
+    const Point& front() const { return *m_begin; }
+    const Point& back() const { return *(m_end - 1); }
+
+private:
+    const Point* m_begin = nullptr;
+    const Point* m_end = nullptr;
+};
+
+/* Iterates over the elements of random access ranges that return them by value */
+template<typename Range>
+class RefIterator {
+public:
+    RefIterator(const Range& _range, size_t _index) : m_range(_range), m_index(_index) {}
+
+    auto operator*() const { return m_range[m_index]; }
+    RefIterator& operator++() { m_index++; return *this; }
+    bool operator!=(const RefIterator& _other) const { return m_index != _other.m_index; }
+
+private:
+    Range m_range;
+    size_t m_index;
+};
+
+/* Consecutive lines in the geometry of a Feature: All lines of a feature or
+ * the rings of a polygon, where the first ring is the outer ring */
+class LinesRef {
+public:
+    using value_type = LineRef;
+
+    LinesRef(const Point* _points, const uint32_t* _ends, uint32_t _start, size_t _count)
+        : m_points(_points), m_ends(_ends), m_start(_start), m_count(_count) {}
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    LineRef operator[](size_t _i) const {
+        uint32_t start = _i == 0 ? m_start : m_ends[_i - 1];
+        return { m_points + start, m_points + m_ends[_i] };
+    }
+    LineRef front() const { return (*this)[0]; }
+
+    RefIterator<LinesRef> begin() const { return { *this, 0 }; }
+    RefIterator<LinesRef> end() const { return { *this, m_count }; }
+
+    /* Number of points in all lines */
+    size_t pointCount() const { return m_count == 0 ? 0 : m_ends[m_count - 1] - m_start; }
+
+private:
+    const Point* m_points;
+    const uint32_t* m_ends;
+    uint32_t m_start;
+    size_t m_count;
+};
+
+typedef LinesRef PolygonRef;
+
+/* Polygons in the geometry of a Feature */
+class PolygonsRef {
+public:
+    using value_type = PolygonRef;
+
+    PolygonsRef(const Point* _points, const uint32_t* _lineEnds, const uint32_t* _polygonEnds, size_t _count)
+        : m_points(_points), m_lineEnds(_lineEnds), m_polygonEnds(_polygonEnds), m_count(_count) {}
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    PolygonRef operator[](size_t _i) const {
+        uint32_t firstRing = _i == 0 ? 0 : m_polygonEnds[_i - 1];
+        uint32_t start = firstRing == 0 ? 0 : m_lineEnds[firstRing - 1];
+        return { m_points, m_lineEnds + firstRing, start, m_polygonEnds[_i] - firstRing };
+    }
+
+    RefIterator<PolygonsRef> begin() const { return { *this, 0 }; }
+    RefIterator<PolygonsRef> end() const { return { *this, m_count }; }
+
+private:
+    const Point* m_points;
+    const uint32_t* m_lineEnds;
+    const uint32_t* m_polygonEnds;
+    size_t m_count;
+};
+
+struct Feature;
+
+/* Decodes the geometry of the features of a Layer that were parsed lazily */
+struct GeometryDecoder {
+    virtual ~GeometryDecoder() {}
+
+    /* Adds the geometry encoded in @_data to @_feature */
+    virtual void decode(const char* _data, size_t _size, Feature& _feature) const = 0;
+
+    // Serializes decoding of features that are shared between threads
+    mutable std::mutex mutex;
+};
+
+/* Reference to the encoded geometry of a Feature */
+struct EncodedGeometry {
+    EncodedGeometry() {}
+
+    // noexcept, so that vectors of Features move them when they grow
+    EncodedGeometry(const EncodedGeometry& _other) noexcept { *this = _other; }
+
+    EncodedGeometry& operator=(const EncodedGeometry& _other) noexcept {
+        decoder = _other.decoder;
+        data = _other.data;
+        size = _other.size;
+        decoded = _other.decoded.load(std::memory_order_acquire);
+        return *this;
+    }
+
+    // Owned by the Layer of the feature
+    const GeometryDecoder* decoder = nullptr;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    mutable std::atomic<bool> decoded{false};
+};
+
 struct Feature {
     Feature() {}
     Feature(int32_t _sourceId) { props.sourceId = _sourceId; }
 
+    /* Allocate the geometry from @_arena, see TileData::arena */
+    Feature(int32_t _sourceId, Arena* _arena)
+        : points(ArenaAllocator<Point>(_arena)),
+          lineEnds(ArenaAllocator<uint32_t>(_arena)),
+          polygonEnds(ArenaAllocator<uint32_t>(_arena)) {
+        props.sourceId = _sourceId;
+    }
+
+    /* Decode the geometry of a lazily parsed feature, once.
+     * Safe to call concurrently for features of shared TileData */
+    void decodeGeometry() const {
+        if (!encoded.decoder || encoded.decoded.load(std::memory_order_acquire)) { return; }
+
+        std::lock_guard<std::mutex> lock(encoded.decoder->mutex);
+        if (encoded.decoded.load(std::memory_order_relaxed)) { return; }
+
+        // The geometry of a const Feature is only written here, before it is read
+        encoded.decoder->decode(encoded.data, encoded.size, const_cast<Feature&>(*this));
+        encoded.decoded.store(true, std::memory_order_release);
+    }
+
     GeometryType geometryType = GeometryType::polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    // The points of a point feature, or all points of its lines or polygon rings
+    ArenaVector<Point> points;
+    // End of each line or polygon ring in points
+    ArenaVector<uint32_t> lineEnds;
+    // End of each polygon in lineEnds
+    ArenaVector<uint32_t> polygonEnds;
+
+    LinesRef lines() const {
+        return { points.data(), lineEnds.data(), 0, lineEnds.size() };
+    }
+    PolygonsRef polygons() const {
+        return { points.data(), lineEnds.data(), polygonEnds.data(), polygonEnds.size() };
+    }
+
+    /* Ends the line or polygon ring of the points added since the last one */
+    void endLine() { lineEnds.push_back(uint32_t(points.size())); }
+
+    /* Ends the polygon of the rings added since the last one */
+    void endPolygon() { polygonEnds.push_back(uint32_t(lineEnds.size())); }
+
+    void addLine(const LineRef& _line) {
+        points.insert(points.end(), _line.begin(), _line.end());
+        endLine();
+    }
+
+    template<typename P>
+    void addPolygon(const P& _polygon) {
+        for (const auto& ring : _polygon) { addLine(ring); }
+        endPolygon();
+    }
+
+    void clearGeometry() {
+        points.clear();
+        lineEnds.clear();
+        polygonEnds.clear();
+    }
+
+    /* Heap memory of the geometry, zero when it is allocated from an Arena */
+    size_t geometryMemoryUsage() const {
+        if (points.get_allocator().arena()) { return 0; }
+        return points.capacity() * sizeof(Point) +
+            (lineEnds.capacity() + polygonEnds.capacity()) * sizeof(uint32_t);
+    }
 
     Properties props;
+
+    EncodedGeometry encoded;
+};
+
+/* Decodes geometry with another decoder and then passes it to a function,
+ * for stages that change the geometry of lazily parsed features */
+template<typename F>
+struct ProcessingDecoder : public GeometryDecoder {
+
+    ProcessingDecoder(std::shared_ptr<const GeometryDecoder> _decoder, F _process)
+        : decoder(std::move(_decoder)), process(std::move(_process)) {}
+
+    void decode(const char* _data, size_t _size, Feature& _feature) const override {
+        decoder->decode(_data, _size, _feature);
+        // Serialized by the mutex of this decoder
+        process(_feature);
+    }
+
+    std::shared_ptr<const GeometryDecoder> decoder;
+    mutable F process;
 };
 
 struct Layer {
@@ -90,12 +324,53 @@ struct Layer {
 
     std::vector<Feature> features;
 
+    // Decoder of lazily parsed features, see Feature::decodeGeometry()
+    std::shared_ptr<const GeometryDecoder> decoder;
+
+    /* Applies @_process to the geometry of each feature: Right away when it
+     * is decoded, otherwise when it is decoded. Must be called before the
+     * layer is shared between threads. */
+    template<typename F>
+    void processGeometry(F _process) {
+        std::shared_ptr<GeometryDecoder> processing;
+        if (decoder) {
+            processing = std::make_shared<ProcessingDecoder<F>>(decoder, _process);
+        }
+
+        for (auto& feature : features) {
+            if (processing && feature.encoded.decoder == decoder.get() &&
+                !feature.encoded.decoded.load(std::memory_order_relaxed)) {
+                feature.encoded.decoder = processing.get();
+            } else {
+                _process(feature);
+            }
+        }
+
+        if (processing) { decoder = std::move(processing); }
+    }
+
 };
 
 struct TileData {
 
+    // Backs the geometry of the features, when set. Declared first so that
+    // it outlives the layers.
+    std::shared_ptr<Arena> arena;
+
     std::vector<Layer> layers;
 
+    /* Approximate memory of the features and their geometry */
+    size_t memoryUsage() const {
+        size_t size = arena ? arena->capacity() : 0;
+        for (auto& layer : layers) {
+            size += layer.features.capacity() * sizeof(Feature);
+            for (auto& feature : layer.features) {
+                size += feature.geometryMemoryUsage();
+            }
+        }
+        return size;
+    }
+
 };
 
 }
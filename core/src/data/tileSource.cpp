@@ -5,26 +5,118 @@
 #include "data/formats/topoJson.h"
 #include "data/tileData.h"
 #include "platform.h"
+#include "tile/tileHash.h"
 #include "tile/tileID.h"
 #include "tile/tile.h"
 #include "tile/tileTask.h"
 #include "log.h"
+#include "util/clip.h"
 #include "util/geom.h"
+#include "util/simplify.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <functional>
+#include <list>
+#include <unordered_map>
 
 namespace Tangram {
 
+// Maximum number of zoom levels between a tile and the ancestor it is sliced from
+const static int MAX_SLICE_LEVELS = 3;
+
+struct TileDataCache {
+
+    // Accessed from the main thread and from parse workers
+    std::mutex m_mutex;
+
+    // LRU cache of parsed tile data
+    using CacheEntry = std::pair<TileID, std::shared_ptr<TileData>>;
+    using CacheList = std::list<CacheEntry>;
+    using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
+
+    CacheMap m_cacheMap;
+    CacheList m_cacheList;
+    size_t m_maxTiles = 0;
+    // Source generation of the cached data
+    int64_t m_generation = 0;
+
+    bool enabled() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maxTiles > 0;
+    }
+
+    std::shared_ptr<TileData> get(const TileID& _tileID) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_cacheMap.find(_tileID);
+        if (it == m_cacheMap.end()) { return nullptr; }
+
+        // Move cached entry to start of list
+        m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
+        return m_cacheList.front().second;
+    }
+
+    void put(const TileID& _tileID, std::shared_ptr<TileData> _data, int64_t _generation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Skip data parsed before the source was cleared
+        if (m_maxTiles == 0 || _generation != m_generation) { return; }
+
+        auto it = m_cacheMap.find(_tileID);
+        if (it != m_cacheMap.end()) {
+            it->second->second = std::move(_data);
+            m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
+            return;
+        }
+
+        m_cacheList.push_front({_tileID, std::move(_data)});
+        m_cacheMap[_tileID] = m_cacheList.begin();
+
+        limit();
+    }
+
+    void limit() {
+        while (m_cacheList.size() > m_maxTiles) {
+            m_cacheMap.erase(m_cacheList.back().first);
+            m_cacheList.pop_back();
+        }
+    }
+
+    size_t release() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        size_t size = 0;
+        for (auto& entry : m_cacheList) {
+            // Data still referenced by tasks is not released
+            if (entry.second.use_count() == 1) { size += entry.second->memoryUsage(); }
+        }
+        m_cacheMap.clear();
+        m_cacheList.clear();
+        return size;
+    }
+
+    void clear(int64_t _generation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cacheMap.clear();
+        m_cacheList.clear();
+        m_generation = _generation;
+    }
+};
+
 TileSource::TileSource(const std::string& _name, std::unique_ptr<DataSource> _sources,
                        ZoomOptions _zoomOptions) :
     m_name(_name),
     m_zoomOptions(_zoomOptions),
-    m_sources(std::move(_sources)) {
+    m_sources(std::move(_sources)),
+    m_tileDataCache(std::make_unique<TileDataCache>()) {
 
     static std::atomic<int32_t> s_serial;
 
     m_id = s_serial++;
+
+    m_tileDataCache->m_generation = m_generation;
 }
 
 TileSource::~TileSource() {
@@ -83,13 +175,123 @@ void TileSource::clearData() {
     if (m_sources) { m_sources->clear(); }
 
     m_generation++;
+
+    if (m_tileDataCache) { m_tileDataCache->clear(m_generation); }
+}
+
+void TileSource::setTileDataSlicing(size_t _maxTiles) {
+    if (isRaster()) {
+        LOGW("Slicing is not supported for raster source: %s", m_name.c_str());
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_tileDataCache->m_mutex);
+    m_tileDataCache->m_maxTiles = _maxTiles;
+    m_tileDataCache->limit();
+}
+
+void TileSource::cacheTileData(const TileTask& _task, std::shared_ptr<TileData> _data) {
+    // Key by data tile: Overzoomed tiles share the data
+    TileID id = _task.tileId();
+    m_tileDataCache->put(TileID(id.x, id.y, id.z), std::move(_data), _task.sourceGeneration());
+}
+
+void TileSource::setClipBuffer(float _pixels) {
+    if (isRaster()) {
+        LOGW("Clipping is not supported for raster source: %s", m_name.c_str());
+        return;
+    }
+    m_clipBuffer = _pixels;
+}
+
+void TileSource::setSimplification(float _pixels) {
+    if (isRaster()) {
+        LOGW("Simplification is not supported for raster source: %s", m_name.c_str());
+        return;
+    }
+    m_simplification = std::max(_pixels, 0.f);
+}
+
+void TileSource::processTileData(const TileTask& _task, TileData& _data) const {
+
+    TileID id = _task.tileId();
+    float clipBuffer = m_clipBuffer;
+    float simplification = m_simplification;
+
+    if (clipBuffer >= 0.f) {
+        // At the smallest size the data is drawn with: Overzoomed tiles share it
+        float tilePixels = std::ldexp(256.f, m_zoomOptions.zoomBias);
+        clipTileData(_data, clipBuffer / tilePixels);
+    }
+
+    if (simplification > 0.f && id.z < m_zoomOptions.maxZoom) {
+        // Tiles are drawn with 256 pixels at their styling zoom
+        float tilePixels = std::ldexp(256.f, id.s - id.z);
+        simplifyTileData(_data, simplification / tilePixels);
+    }
+}
+
+size_t TileSource::releaseRawData() {
+    size_t size = m_sources ? m_sources->releaseCache() : 0;
+
+    for (auto& raster : m_rasterSources) {
+        size += raster->releaseRawData();
+    }
+    return size;
+}
+
+TileSource::RawCacheStats TileSource::rawCacheStats() const {
+    RawCacheStats stats;
+    if (m_sources) { m_sources->cacheStats(stats); }
+    return stats;
+}
+
+size_t TileSource::releaseTileData() {
+    size_t size = m_tileDataCache->release();
+
+    for (auto& raster : m_rasterSources) {
+        size += raster->releaseTileData();
+    }
+    return size;
+}
+
+size_t TileSource::releaseRasters() {
+    size_t size = 0;
+
+    for (auto& raster : m_rasterSources) {
+        size += raster->releaseRasters();
+    }
+    return size;
+}
+
+bool TileSource::loadSlicedTileData(TileTask& _task) {
+
+    if (!_task.isSliceable() || _task.isSubTask() || !m_tileDataCache->enabled()) {
+        return false;
+    }
+
+    TileID id = _task.tileId();
+
+    for (int level = 0; level <= MAX_SLICE_LEVELS && level <= id.z; level++) {
+        TileID parentID(id.x >> level, id.y >> level, id.z - level);
+
+        if (auto data = m_tileDataCache->get(parentID)) {
+            _task.setParentData(std::move(data), parentID);
+            return true;
+        }
+    }
+    return false;
 }
 
 void TileSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
 
     if (m_sources) {
         if (_task->needsLoading()) {
-            if (m_sources->loadTileData(_task, _cb)) {
+            if (loadSlicedTileData(*_task)) {
+                // Built from kept data: No need to load
+                _task->startedLoading();
+                _cb.func(_task);
+
+            } else if (m_sources->loadTileData(_task, _cb)) {
                 _task->startedLoading();
             }
         } else if(_task->hasData()) {
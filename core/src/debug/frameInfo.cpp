@@ -8,6 +8,7 @@
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
+#include "tile/tileWorker.h"
 #include "view/view.h"
 
 #include <deque>
@@ -52,7 +53,8 @@ void FrameInfo::beginFrame() {
 }
 
 
-void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager) {
+void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager,
+                     const TileWorker& _tileWorker) {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
         static int cpt = 0;
@@ -116,10 +118,39 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
                                  + std::to_string(features));
             debuginfos.push_back("tile cache size:"
                                  + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
+            const auto& cache = _tileManager.getTileCache()->stats();
+            debuginfos.push_back("tile cache hits:" + std::to_string(cache.hits)
+                                 + " misses:" + std::to_string(cache.misses)
+                                 + " evictions:" + std::to_string(cache.evictions));
             debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
+
+            const auto& prefetch = _tileManager.getPrefetchStats();
+            debuginfos.push_back("prefetch tiles:" + std::to_string(prefetch.requested)
+                                 + " canceled:" + std::to_string(prefetch.canceled)
+                                 + " hit rate:" + to_string_with_precision(prefetch.hitRate() * 100, 1) + "%");
             debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
             debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
             debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
+
+            auto workerStats = _tileWorker.stats();
+            auto stageInfo = [](const char* _name, const TileWorker::Stats::Stage& _stage) {
+                float avgTime = _stage.processed > 0 ? _stage.busyMs / _stage.processed : 0.f;
+                return std::string(_name) + " queue:" + std::to_string(_stage.queued)
+                    + " tasks:" + std::to_string(_stage.processed)
+                    + " avg:" + to_string_with_precision(avgTime, 2) + "ms";
+            };
+            debuginfos.push_back(stageInfo("parse", workerStats.parse)
+                                 + " blocked:" + to_string_with_precision(workerStats.parse.blockedMs, 0) + "ms");
+            debuginfos.push_back(stageInfo("build", workerStats.build));
+            debuginfos.push_back("canceled tasks:"
+                                 + std::to_string(workerStats.parse.aborted + workerStats.build.aborted)
+                                 + " saved:" + to_string_with_precision(workerStats.parse.savedMs +
+                                                                       workerStats.build.savedMs, 0) + "ms");
+            const auto& diskCache = workerStats.diskCache;
+            debuginfos.push_back("disk cache hits:" + std::to_string(diskCache.hits)
+                                 + " misses:" + std::to_string(diskCache.misses)
+                                 + " size:" + std::to_string(diskCache.usage / 1024) + "kb");
+
             debuginfos.push_back("zoom:" + std::to_string(_view.getZoom()));
             debuginfos.push_back("pos:" + std::to_string(_view.getPosition().x) + "/"
                                  + std::to_string(_view.getPosition().y));
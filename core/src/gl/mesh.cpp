@@ -54,11 +54,8 @@ MeshBase::~MeshBase() {
     });
 
 
-    if (m_glVertexData) {
+    if (!m_dataOwner) {
         delete[] m_glVertexData;
-    }
-
-    if (m_glIndexData) {
         delete[] m_glIndexData;
     }
 
@@ -133,7 +130,7 @@ void MeshBase::upload(RenderState& rs) {
     rs.vertexBuffer(m_glVertexBuffer);
     GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
 
-    delete[] m_glVertexData;
+    if (!m_dataOwner) { delete[] m_glVertexData; }
     m_glVertexData = nullptr;
 
     if (m_glIndexData) {
@@ -147,10 +144,12 @@ void MeshBase::upload(RenderState& rs) {
 
         GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
 
-        delete[] m_glIndexData;
+        if (!m_dataOwner) { delete[] m_glIndexData; }
         m_glIndexData = nullptr;
     }
 
+    m_dataOwner.reset();
+
     m_disposer = Disposer(rs);
 
     m_isUploaded = true;
@@ -283,4 +282,21 @@ void MeshBase::setDirty(GLintptr _byteOffset, GLsizei _byteSize) {
     }
 }
 
+void RawMesh::compile(std::shared_ptr<void> _owner, GLbyte* _vertices, size_t _nVertices,
+                      GLushort* _indices, size_t _nIndices,
+                      std::vector<std::pair<uint32_t, uint32_t>> _vertexOffsets) {
+
+    m_dataOwner = std::move(_owner);
+
+    m_glVertexData = _vertices;
+    m_nVertices = _nVertices;
+
+    m_glIndexData = _nIndices > 0 ? _indices : nullptr;
+    m_nIndices = _nIndices;
+
+    m_vertexOffsets = std::move(_vertexOffsets);
+
+    m_isCompiled = true;
+}
+
 }
@@ -74,6 +74,17 @@ public:
 
     size_t bufferSize() const;
 
+    /*
+     * Compiled vertices and indices; available until the mesh is uploaded
+     */
+    const GLbyte* vertexData() const { return m_glVertexData; }
+    const GLushort* indexData() const { return m_glIndexData; }
+    size_t vertexCount() const { return m_nVertices; }
+    size_t indexCount() const { return m_nIndices; }
+    const auto& vertexOffsets() const { return m_vertexOffsets; }
+    const auto& vertexLayout() const { return m_vertexLayout; }
+    GLenum drawMode() const { return m_drawMode; }
+
 protected:
 
     // Used in draw for legth and offsets: sumIndices, sumVertices
@@ -95,6 +106,10 @@ protected:
     // Compiled  indices for upload
     GLushort* m_glIndexData = nullptr;
 
+    // Owner of the memory of m_glVertexData and m_glIndexData when it was
+    // not allocated by the mesh
+    std::shared_ptr<void> m_dataOwner;
+
     GLenum m_drawMode;
     GLenum m_hint;
 
@@ -132,6 +147,15 @@ struct MeshData {
         indices.clear();
         vertices.clear();
     }
+
+    // Append the geometry of @_other. Indices are relative to their offsets
+    // entry so they can be taken over unchanged.
+    void append(MeshData<T>& _other) {
+        indices.insert(indices.end(), _other.indices.begin(), _other.indices.end());
+        vertices.insert(vertices.end(), _other.vertices.begin(), _other.vertices.end());
+        offsets.insert(offsets.end(), _other.offsets.begin(), _other.offsets.end());
+        _other.clear();
+    }
 };
 
 template<class T>
@@ -152,6 +176,8 @@ public:
         return MeshBase::draw(rs, shader, useVao);
     }
 
+    const MeshBase* meshBase() const override { return this; }
+
     void compile(const std::vector<MeshData<T>>& _meshes);
 
     void compile(const MeshData<T>& _mesh);
@@ -172,6 +198,35 @@ public:
                          size_t _attribOffset = 0);
 };
 
+/*
+ * RawMesh - Mesh of vertices and indices that were compiled by a Mesh<T>,
+ * e.g. restored from a cache
+ */
+class RawMesh : public StyledMesh, protected MeshBase {
+public:
+
+    RawMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode)
+        : MeshBase(_vertexLayout, _drawMode) {}
+
+    size_t bufferSize() const override {
+        return MeshBase::bufferSize();
+    }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    const MeshBase* meshBase() const override { return this; }
+
+    /*
+     * Uses _nVertices vertices and _nIndices indices in memory of _owner,
+     * without copies, drawn in the batches of _vertexOffsets as created by
+     * Mesh<T>::compile. _owner is released once the mesh is uploaded.
+     */
+    void compile(std::shared_ptr<void> _owner, GLbyte* _vertices, size_t _nVertices,
+                 GLushort* _indices, size_t _nIndices,
+                 std::vector<std::pair<uint32_t, uint32_t>> _vertexOffsets);
+};
 
 template<class T>
 void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
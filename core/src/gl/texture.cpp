@@ -218,7 +218,8 @@ void Texture::update(RenderState& rs, GLuint _textureUnit) {
 
     update(rs, _textureUnit, data);
 
-    m_data.clear();
+    // Release the CPU copy once it is uploaded
+    std::vector<GLuint>().swap(m_data);
 }
 
 void Texture::update(RenderState& rs, GLuint _textureUnit, const GLuint* data) {
@@ -285,7 +286,7 @@ bool Texture::isRepeatWrapping(TextureWrapping _wrapping) {
     return _wrapping.wraps == GL_REPEAT || _wrapping.wrapt == GL_REPEAT;
 }
 
-size_t Texture::bytesPerPixel() {
+size_t Texture::bytesPerPixel() const {
     switch (m_options.internalFormat) {
         case GL_ALPHA:
         case GL_LUMINANCE:
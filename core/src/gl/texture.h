@@ -62,6 +62,9 @@ public:
     unsigned int getWidth() const { return m_width; }
     unsigned int getHeight() const { return m_height; }
 
+    /* Size of the texture data in bytes */
+    size_t bufferSize() const { return m_width * m_height * bytesPerPixel(); }
+
     void bind(RenderState& rs, GLuint _unit);
 
     void setDirty(size_t yOffset, size_t height);
@@ -117,7 +120,7 @@ protected:
 
 private:
 
-    size_t bytesPerPixel();
+    size_t bytesPerPixel() const;
 
     bool m_generateMipmaps;
 };
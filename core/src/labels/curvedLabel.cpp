@@ -207,9 +207,9 @@ void CurvedLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
         uint16_t(m_fontAttrib.fontScale),
     };
 
-    auto it = m_textLabels.quads.begin() + m_textRanges[m_textRangeIndex].start;
+    auto it = m_textLabels->quads.begin() + m_textRanges[m_textRangeIndex].start;
     auto end = it + m_textRanges[m_textRangeIndex].length;
-    auto& style = m_textLabels.style;
+    auto& style = m_textLabels->style;
 
     auto& meshes = style.getMeshes();
 
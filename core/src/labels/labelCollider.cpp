@@ -8,6 +8,9 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/norm.hpp"
 
+// Number of labels or collision pairs processed between checks for cancellation
+#define CANCEL_CHECK_INTERVAL 64
+
 namespace Tangram {
 
 void LabelCollider::addLabels(std::vector<std::unique_ptr<Label>>& _labels) {
@@ -56,7 +59,18 @@ size_t LabelCollider::filterRepeatGroups(size_t startPos, size_t curPos) {
     return endPos;
 }
 
-void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tileSize) {
+void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tileSize,
+                            const std::atomic<bool>* _canceled) {
+
+    size_t checkpoint = 0;
+    auto canceled = [&]() {
+        if (!_canceled || ++checkpoint % CANCEL_CHECK_INTERVAL != 0 || !*_canceled) {
+            return false;
+        }
+        m_labels.clear();
+        m_aabbs.clear();
+        return true;
+    };
 
     // Sort labels so that all labels of one repeat group are next to each other
     std::sort(m_labels.begin(), m_labels.end(),
@@ -110,6 +124,8 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
     m_transforms.clear();
 
     for (auto it = m_labels.begin(); it != m_labels.end(); ) {
+        if (canceled()) { return; }
+
         auto& entry = *it;
         auto* label = entry.label;
         ScreenTransform transform { m_transforms, entry.transform };
@@ -202,6 +218,8 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
     // Narrow Phase, resolve conflicts
     for (auto& pair : m_isect2d.pairs) {
 
+        if (canceled()) { return; }
+
         auto& e1 = m_labels[pair.first];
         auto& e2 = m_labels[pair.second];
         auto* l1 = e1.label;
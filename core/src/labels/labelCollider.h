@@ -7,6 +7,7 @@
 
 #include "isect2d.h"
 #include "glm_vec.h" // for isect2d.h
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -22,7 +23,10 @@ public:
 
     void addLabels(std::vector<std::unique_ptr<Label>>& _labels);
 
-    void process(TileID _tileID, float _tileInverseScale, float _tileSize);
+    // Resolve collisions between the added labels. Stops early, leaving the
+    // labels in an undefined state, when @_canceled is set meanwhile.
+    void process(TileID _tileID, float _tileInverseScale, float _tileSize,
+                 const std::atomic<bool>* _canceled = nullptr);
 
 private:
 
@@ -60,7 +60,7 @@ SpriteLabel::SpriteLabel(Coordinates _coordinates, glm::vec2 _size, Label::Optio
                          SpriteLabels& _labels, size_t _labelsPos)
     : Label(_size, Label::Type::point, _options),
       m_coordinates(_coordinates),
-      m_labels(_labels),
+      m_labels(&_labels),
       m_labelsPos(_labelsPos),
       m_texture(_texture),
       m_vertexAttrib(_attrib) {
@@ -224,7 +224,7 @@ void SpriteLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
     //     vertex_pos.xy += clamp(dz, 0.0, 1.0) * UNPACK_EXTRUDE(a_extrude.xy);
     // }
 
-    auto& quad = m_labels.quads[m_labelsPos];
+    auto& quad = m_labels->quads[m_labelsPos];
 
     SpriteVertex::State state {
         m_vertexAttrib.selectionColor,
@@ -233,7 +233,7 @@ void SpriteLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
         0,
     };
 
-    auto& style = m_labels.m_style;
+    auto& style = m_labels->m_style;
 
     // Before pushing our geometry to the mesh, we push the texture that should be
     // used to draw this label. We check a few potential textures in order of priority.
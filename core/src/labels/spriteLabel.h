@@ -59,13 +59,19 @@ public:
         return glm::vec2(m_coordinates);
     }
 
+    // Move to the quads of @_labels, starting at @_quadOffset
+    void rebind(const SpriteLabels& _labels, size_t _quadOffset) {
+        m_labels = &_labels;
+        m_labelsPos += _quadOffset;
+    }
+
 private:
 
     const Coordinates m_coordinates;
 
     // Back-pointer to owning container and position
-    const SpriteLabels& m_labels;
-    const size_t m_labelsPos;
+    const SpriteLabels* m_labels;
+    size_t m_labelsPos;
 
     // Non-owning reference to a texture that is specific to this label.
     // If non-null, this indicates a custom texture for a marker.
@@ -41,7 +41,7 @@ TextLabel::TextLabel(Coordinates _coordinates, Type _type, Label::Options _optio
                      TextLabels& _labels, TextRange _textRanges, Align _preferedAlignment)
     : Label(_dim, _type, _options),
       m_coordinates(_coordinates),
-      m_textLabels(_labels),
+      m_textLabels(&_labels),
       m_textRanges(_textRanges),
       m_fontAttrib(_attrib),
       m_preferedAlignment(_preferedAlignment) {
@@ -203,9 +203,9 @@ void TextLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2&
         uint16_t(m_fontAttrib.fontScale),
     };
 
-    auto it = m_textLabels.quads.begin() + m_textRanges[m_textRangeIndex].start;
+    auto it = m_textLabels->quads.begin() + m_textRanges[m_textRangeIndex].start;
     auto end = it + m_textRanges[m_textRangeIndex].length;
-    auto& style = m_textLabels.style;
+    auto& style = m_textLabels->style;
 
     auto& meshes = style.getMeshes();
 
@@ -68,6 +68,12 @@ public:
         return m_textRanges;
     }
 
+    // Move to the quads of @_labels, starting at @_quadOffset
+    void rebind(const TextLabels& _labels, size_t _quadOffset) {
+        m_textLabels = &_labels;
+        for (auto& range : m_textRanges) { range.start += int(_quadOffset); }
+    }
+
     uint32_t selectionColor() override {
         return m_fontAttrib.selectionColor;
     }
@@ -87,7 +93,7 @@ protected:
     const Coordinates m_coordinates;
 
     // Back-pointer to owning container
-    const TextLabels& m_textLabels;
+    const TextLabels* m_textLabels;
 
     // first vertex and count in m_textLabels quads (left,right,center)
     TextRange m_textRanges;
@@ -22,6 +22,7 @@
 #include "text/fontContext.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
+#include "tile/tileDiskCache.h"
 #include "tile/tileManager.h"
 #include "util/asyncWorker.h"
 #include "util/fastmap.h"
@@ -35,18 +36,19 @@
 
 namespace Tangram {
 
-const static size_t MAX_WORKERS = 2;
+// Keyframes sampled from the ease curve of flyTo()
+const static int FLY_TO_KEYFRAMES = 16;
 
 enum class EaseField { position, zoom, rotation, tilt };
 
 class Map::Impl {
 
 public:
-    Impl(std::shared_ptr<Platform> _platform) :
+    Impl(std::shared_ptr<Platform> _platform, const TileWorkerOptions& _tileWorkers) :
         platform(_platform),
         inputHandler(_platform, view),
         scene(std::make_shared<Scene>(_platform)),
-        tileWorker(_platform, MAX_WORKERS),
+        tileWorker(_platform, _tileWorkers.buildWorkers, _tileWorkers.parseWorkers),
         tileManager(_platform, tileWorker) {}
 
     void setScene(std::shared_ptr<Scene>& _scene);
@@ -61,6 +63,8 @@ public:
 
     void setPixelScale(float _pixelsPerPoint);
 
+    void clearPrefetchPath();
+
     std::mutex tilesMutex;
     std::mutex sceneMutex;
 
@@ -104,10 +108,17 @@ void Map::Impl::clearEase(EaseField _f) {
     eases[static_cast<size_t>(_f)] = none;
 }
 
+void Map::Impl::clearPrefetchPath() {
+    std::lock_guard<std::mutex> lock(tilesMutex);
+    tileManager.clearPrefetchPath();
+}
+
 static std::bitset<9> g_flags = 0;
 
-Map::Map(std::shared_ptr<Platform> _platform) : platform(_platform) {
-    impl.reset(new Impl(_platform));
+Map::Map(std::shared_ptr<Platform> _platform) : Map(_platform, TileWorkerOptions()) {}
+
+Map::Map(std::shared_ptr<Platform> _platform, TileWorkerOptions _tileWorkers) : platform(_platform) {
+    impl.reset(new Impl(_platform, _tileWorkers));
 }
 
 Map::~Map() {
@@ -125,7 +136,11 @@ Map::~Map() {
 
 void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
 
-    scene = _scene;
+    {
+        // Guards the scene for stats and memory warnings from other threads
+        std::lock_guard<std::mutex> lock(sceneMutex);
+        scene = _scene;
+    }
 
     scene->setPixelScale(view.pixelScale());
 
@@ -452,6 +467,87 @@ void Map::setPickRadius(float _radius) {
     impl->pickRadius = _radius;
 }
 
+void Map::setTileStyleWorkers(int _workers) {
+    impl->tileWorker.setStyleWorkers(std::max(_workers, 0));
+}
+
+void Map::setTilePrefetch(float _seconds, int _budget) {
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+    impl->tileManager.setPrefetch(_seconds, std::max(_budget, 0));
+}
+
+void Map::setTileCacheQuota(const std::string& _source, size_t _bytes) {
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+    impl->tileManager.setCacheQuota(_source, _bytes);
+}
+
+std::vector<TileCacheStats> Map::getTileCacheStats() {
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+    auto toStats = [](const TileCache::Stats& _stats, std::string _name) {
+        TileCacheStats stats;
+        stats.source = std::move(_name);
+        stats.hits = _stats.hits;
+        stats.misses = _stats.misses;
+        stats.evictions = _stats.evictions;
+        stats.memoryUsage = _stats.memoryUsage;
+        stats.tiles = _stats.tiles;
+        return stats;
+    };
+
+    auto& tileCache = impl->tileManager.getTileCache();
+
+    std::vector<TileCacheStats> result;
+    result.push_back(toStats(tileCache->stats(), ""));
+
+    for (auto& entry : tileCache->sourceStats()) {
+        std::string name;
+        for (auto& tileSet : impl->tileManager.getTileSets()) {
+            if (tileSet.source->id() == entry.first) {
+                name = tileSet.source->name();
+                break;
+            }
+        }
+        result.push_back(toStats(entry.second, std::move(name)));
+    }
+
+    return result;
+}
+
+std::vector<RawCacheStats> Map::getRawCacheStats() {
+
+    std::vector<RawCacheStats> result;
+
+    std::lock_guard<std::mutex> lock(impl->sceneMutex);
+    if (!impl->scene) { return result; }
+
+    for (auto& source : impl->scene->tileSources()) {
+        auto sourceStats = source->rawCacheStats();
+        RawCacheStats stats;
+        stats.source = source->name();
+        stats.hits = sourceStats.hits;
+        stats.misses = sourceStats.misses;
+        stats.entries = sourceStats.entries;
+        stats.memoryUsage = sourceStats.usage;
+        stats.inflatedUsage = sourceStats.inflatedUsage;
+        stats.hitRate = sourceStats.hitRate();
+        stats.entriesPerMB = sourceStats.entriesPerMB();
+        result.push_back(std::move(stats));
+    }
+
+    return result;
+}
+
+void Map::setTileDiskCache(const std::string& _path, size_t _maxBytes) {
+    if (_path.empty()) {
+        impl->tileWorker.setDiskCache(nullptr);
+        return;
+    }
+
+    auto cache = std::make_shared<TileDiskCache>(_path, _maxBytes);
+    impl->tileWorker.setDiskCache(cache->isValid() ? cache : nullptr);
+}
+
 void Map::pickFeatureAt(float _x, float _y, FeaturePickCallback _onFeaturePickCallback) {
     impl->selectionQueries.push_back({{_x, _y}, impl->pickRadius, _onFeaturePickCallback});
 
@@ -527,7 +623,7 @@ void Map::render() {
 
     if (drawSelectionBuffer) {
         impl->selectionBuffer->drawDebug(impl->renderState, viewport);
-        FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+        FrameInfo::draw(impl->renderState, impl->view, impl->tileManager, impl->tileWorker);
         return;
     }
 
@@ -558,7 +654,7 @@ void Map::render() {
 
     impl->labels.drawDebug(impl->renderState, impl->view);
 
-    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager, impl->tileWorker);
 }
 
 int Map::getViewportHeight() {
@@ -590,6 +686,7 @@ void Map::setPosition(double _lon, double _lat) {
 
     impl->setPositionNow(_lon, _lat);
     impl->clearEase(EaseField::position);
+    impl->clearPrefetchPath();
 
 }
 
@@ -599,6 +696,7 @@ void Map::setPositionEased(double _lon, double _lat, float _duration, EaseType _
     getPosition(lon_start, lat_start);
     auto cb = [=](float t) { impl->setPositionNow(ease(lon_start, _lon, t, _e), ease(lat_start, _lat, t, _e)); };
     impl->setEase(EaseField::position, { _duration, cb });
+    impl->clearPrefetchPath();
 
 }
 
@@ -623,6 +721,7 @@ void Map::setZoom(float _z) {
 
     impl->setZoomNow(_z);
     impl->clearEase(EaseField::zoom);
+    impl->clearPrefetchPath();
 
 }
 
@@ -631,6 +730,7 @@ void Map::setZoomEased(float _z, float _duration, EaseType _e) {
     float z_start = getZoom();
     auto cb = [=](float t) { impl->setZoomNow(ease(z_start, _z, t, _e)); };
     impl->setEase(EaseField::zoom, { _duration, cb });
+    impl->clearPrefetchPath();
 
 }
 
@@ -640,6 +740,55 @@ float Map::getZoom() {
 
 }
 
+void Map::flyTo(double _lon, double _lat, float _zoom, float _duration, EaseType _e) {
+
+    double lon_start, lat_start;
+    getPosition(lon_start, lat_start);
+    float z_start = getZoom();
+
+    // Sample the ease curve: Keyframe times are the deadlines of the tiles on the way
+    std::vector<CameraKeyframe> keyframes;
+    for (int i = 0; i <= FLY_TO_KEYFRAMES; i++) {
+        float t = float(i) / FLY_TO_KEYFRAMES;
+        CameraKeyframe keyframe;
+        keyframe.position = LngLat(ease(lon_start, _lon, t, _e), ease(lat_start, _lat, t, _e));
+        keyframe.zoom = ease(z_start, _zoom, t, _e);
+        keyframe.time = t * _duration;
+        keyframes.push_back(keyframe);
+    }
+
+    auto positionCb = [=](float t) { impl->setPositionNow(ease(lon_start, _lon, t, _e), ease(lat_start, _lat, t, _e)); };
+    auto zoomCb = [=](float t) { impl->setZoomNow(ease(z_start, _zoom, t, _e)); };
+    impl->setEase(EaseField::position, { _duration, positionCb });
+    impl->setEase(EaseField::zoom, { _duration, zoomCb });
+
+    prefetchCameraPath(keyframes);
+
+}
+
+void Map::prefetchCameraPath(const std::vector<CameraKeyframe>& _keyframes) {
+
+    std::vector<TileManager::PathKeyframe> path;
+    path.reserve(_keyframes.size());
+
+    for (const auto& keyframe : _keyframes) {
+        glm::dvec2 meters = impl->view.getMapProjection().LonLatToMeters({ keyframe.position.longitude,
+                                                                            keyframe.position.latitude });
+        path.push_back({ meters, keyframe.zoom, keyframe.time });
+    }
+
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+    impl->tileManager.setPrefetchPath(impl->view, path);
+    platform->requestRender();
+
+}
+
+void Map::cancelCameraPathPrefetch() {
+
+    impl->clearPrefetchPath();
+
+}
+
 void Map::Impl::setRotationNow(float _radians) {
 
     view.setRoll(_radians);
@@ -651,6 +800,7 @@ void Map::setRotation(float _radians) {
 
     impl->setRotationNow(_radians);
     impl->clearEase(EaseField::rotation);
+    impl->clearPrefetchPath();
 
 }
 
@@ -665,6 +815,7 @@ void Map::setRotationEased(float _radians, float _duration, EaseType _e) {
 
     auto cb = [=](float t) { impl->setRotationNow(ease(radians_start, _radians, t, _e)); };
     impl->setEase(EaseField::rotation, { _duration, cb });
+    impl->clearPrefetchPath();
 
 }
 
@@ -686,6 +837,7 @@ void Map::setTilt(float _radians) {
 
     impl->setTiltNow(_radians);
     impl->clearEase(EaseField::tilt);
+    impl->clearPrefetchPath();
 
 }
 
@@ -694,6 +846,7 @@ void Map::setTiltEased(float _radians, float _duration, EaseType _e) {
     float tilt_start = getTilt();
     auto cb = [=](float t) { impl->setTiltNow(ease(tilt_start, _radians, t, _e)); };
     impl->setEase(EaseField::tilt, { _duration, cb });
+    impl->clearPrefetchPath();
 
 }
 
@@ -858,42 +1011,49 @@ void Map::markerRemoveAll() {
 void Map::handleTapGesture(float _posX, float _posY) {
 
     impl->inputHandler.handleTapGesture(_posX, _posY);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handleDoubleTapGesture(float _posX, float _posY) {
 
     impl->inputHandler.handleDoubleTapGesture(_posX, _posY);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handlePanGesture(float _startX, float _startY, float _endX, float _endY) {
 
     impl->inputHandler.handlePanGesture(_startX, _startY, _endX, _endY);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handleFlingGesture(float _posX, float _posY, float _velocityX, float _velocityY) {
 
     impl->inputHandler.handleFlingGesture(_posX, _posY, _velocityX, _velocityY);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handlePinchGesture(float _posX, float _posY, float _scale, float _velocity) {
 
     impl->inputHandler.handlePinchGesture(_posX, _posY, _scale, _velocity);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handleRotateGesture(float _posX, float _posY, float _radians) {
 
     impl->inputHandler.handleRotateGesture(_posX, _posY, _radians);
+    impl->clearPrefetchPath();
 
 }
 
 void Map::handleShoveGesture(float _distance) {
 
     impl->inputHandler.handleShoveGesture(_distance);
+    impl->clearPrefetchPath();
 
 }
 
@@ -932,20 +1092,69 @@ void Map::runAsyncTask(std::function<void()> _task) {
     }
 }
 
-void Map::onMemoryWarning() {
-    auto& tileCache = impl->tileManager.getTileCache();
+std::vector<MemoryReleaseStats> Map::onMemoryWarning(MemoryWarningLevel _level) {
 
-    if (tileCache) {
-        tileCache->clear();
-    }
+    std::vector<MemoryReleaseStats> result;
+
+    auto released = [&](const char* _subsystem, size_t _bytes) {
+        MemoryReleaseStats stats;
+        stats.subsystem = _subsystem;
+        stats.bytes = _bytes;
+        result.push_back(std::move(stats));
+    };
+
+    bool critical = _level == MemoryWarningLevel::critical;
+
+    {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+        // Tiles out of view: Built again from kept or cached data
+        auto& tileCache = impl->tileManager.getTileCache();
+        if (tileCache) {
+            released("tile cache", tileCache->getMemoryUsage());
+            tileCache->clear();
+        }
+
+        auto& tileSets = impl->tileManager.getTileSets();
 
-    for (auto& tileSet : impl->tileManager.getTileSets()) {
-        tileSet.source->clearData();
+        // Parsed data: Parsed again from raw data
+        size_t bytes = 0;
+        for (auto& tileSet : tileSets) { bytes += tileSet.source->releaseTileData(); }
+        released("tile data", bytes);
+
+        // Raster textures, no longer referenced by cached tiles: Decoded again from raw data
+        bytes = 0;
+        for (auto& tileSet : tileSets) { bytes += tileSet.source->releaseRasters(); }
+        released("raster textures", bytes);
+
+        // Raw data: Loaded again
+        if (critical) {
+            bytes = 0;
+            for (auto& tileSet : tileSets) { bytes += tileSet.source->releaseRawData(); }
+            released("raw tile data", bytes);
+        }
     }
 
+    std::lock_guard<std::mutex> lock(impl->sceneMutex);
+
     if (impl->scene && impl->scene->fontContext()) {
-        impl->scene->fontContext()->releaseFonts();
+        auto& fontContext = impl->scene->fontContext();
+
+        // Glyphs of labels out of view: Rendered again
+        released("glyph textures", fontContext->releaseUnusedTextures());
+
+        // Font faces are loaded again on demand; their size is not known here
+        if (critical) { fontContext->releaseFonts(); }
     }
+
+    // The CPU copies of meshes and textures (sprite atlases included) are
+    // already released once they are uploaded.
+
+    for (auto& stats : result) {
+        LOG("Memory warning: Released %zu bytes of %s", stats.bytes, stats.subsystem.c_str());
+    }
+
+    return result;
 }
 
 void Map::setDefaultBackgroundColor(float r, float g, float b) {
@@ -187,8 +187,8 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     // Build a feature for the new set of polyline points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::lines;
-    feature->lines.emplace_back();
-    auto& line = feature->lines.back();
+    auto& line = feature->points;
+    line.reserve(count);
 
     // Determine the bounds of the polyline.
     BoundingBox bounds;
@@ -212,6 +212,7 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
         auto meters = m_mapProjection->LonLatToMeters(degrees);
         line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale, 0.f);
     }
+    feature->endLine();
 
     // Update the feature data for the marker.
     marker->setFeature(std::move(feature));
@@ -238,8 +239,6 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     // Build a feature for the new set of polygon points.
     auto feature = std::make_unique<Feature>();
     feature->geometryType = GeometryType::polygons;
-    feature->polygons.emplace_back();
-    auto& polygon = feature->polygons.back();
 
     // Determine the bounds of the polygon.
     BoundingBox bounds;
@@ -268,15 +267,15 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     ring = coordinates;
     for (int i = 0; i < rings; ++i) {
         int count = counts[i];
-        polygon.emplace_back();
-        auto& line = polygon.back();
         for (int j = 0; j < count; ++j) {
             auto degrees = glm::dvec2(ring[j].longitude, ring[j].latitude);
             auto meters = m_mapProjection->LonLatToMeters(degrees);
-            line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale, 0.f);
+            feature->points.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale, 0.f);
         }
+        feature->endLine();
         ring += count;
     }
+    feature->endPolygon();
 
     // Update the feature data for the marker.
     marker->setFeature(std::move(feature));
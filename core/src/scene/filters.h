@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "util/variant.h"
 
 #include <memory>
@@ -28,24 +29,24 @@ struct Filter {
     };
 
     struct EqualitySet {
-        std::string key;
+        PropertyKey key;
         std::vector<Value> values;
         FilterKeyword keyword;
     };
     struct Equality {
-        std::string key;
+        PropertyKey key;
         Value value;
         FilterKeyword keyword;
     };
     struct Range {
-        std::string key;
+        PropertyKey key;
         float min;
         float max;
         FilterKeyword keyword;
         bool hasPixelArea;
     };
     struct Existence {
-        std::string key;
+        PropertyKey key;
         bool exists;
     };
     struct Function {
@@ -83,18 +84,18 @@ struct Filter {
     // Create an 'equality' filter
     inline static Filter MatchEquality(const std::string& k, const std::vector<Value>& vals) {
         if (vals.size() == 1) {
-            return { Equality{ k, vals[0], keywordType(k) }};
+            return { Equality{ PropertyKey(k), vals[0], keywordType(k) }};
         } else {
-            return { EqualitySet{ k, vals, keywordType(k) }};
+            return { EqualitySet{ PropertyKey(k), vals, keywordType(k) }};
         }
     }
     // Create a 'range' filter
     inline static Filter MatchRange(const std::string& k, float min, float max, bool sqA) {
-        return { Range{ k, min, max, keywordType(k), sqA }};
+        return { Range{ PropertyKey(k), min, max, keywordType(k), sqA }};
     }
     // Create an 'existence' filter
     inline static Filter MatchExistence(const std::string& k, bool ex) {
-        return { Existence{ k, ex }};
+        return { Existence{ PropertyKey(k), ex }};
     }
     // Create an 'function' filter with reference to Scene function id
     inline static Filter MatchFunction(uint32_t id) {
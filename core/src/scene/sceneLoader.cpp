@@ -1058,6 +1058,13 @@ void SceneLoader::loadSource(const std::shared_ptr<Platform>& platform, const st
     auto rawSources = std::make_unique<MemoryCacheDataSource>();
     rawSources->setCacheSize(CACHE_SIZE);
 
+    if (auto compressedCacheNode = source["compressed_cache"]) {
+        // Keep the cached tile data compressed, inflated when tiles are parsed
+        bool compressedCache = false;
+        getBool(compressedCacheNode, compressedCache);
+        rawSources->setCompression(compressedCache);
+    }
+
     if (isMBTilesFile) {
         // If we have MBTiles, we know the source is tiled.
         tiled = true;
@@ -1104,6 +1111,30 @@ void SceneLoader::loadSource(const std::shared_ptr<Platform>& platform, const st
         }
     }
 
+    if (auto sliceTilesNode = source["slice_tiles"]) {
+        // Number of parsed tiles kept to build overzoomed and loading tiles from
+        int32_t sliceTiles = sliceTilesNode.as<int32_t>(0);
+        if (sliceTiles > 0) {
+            sourcePtr->setTileDataSlicing(sliceTiles);
+        }
+    }
+
+    if (auto clipBufferNode = source["clip_buffer"]) {
+        // Buffer in pixels around tiles that geometry is clipped to
+        float clipBuffer = clipBufferNode.as<float>(-1.f);
+        if (clipBuffer >= 0.f) {
+            sourcePtr->setClipBuffer(clipBuffer);
+        }
+    }
+
+    if (auto simplifyNode = source["simplify"]) {
+        // Tolerance in pixels for removing detail of lines and polygons
+        float simplify = simplifyNode.as<float>(0.f);
+        if (simplify > 0.f) {
+            sourcePtr->setSimplification(simplify);
+        }
+    }
+
     _scene->tileSources().push_back(sourcePtr);
 
     if (auto rasters = source["rasters"]) {
@@ -72,6 +72,9 @@ struct DebugStyleBuilder : public StyleBuilder {
 
     const Style& style() const override { return m_style; }
 
+    // Builds no per-feature geometry
+    bool canMerge() const override { return true; }
+
     DebugStyleBuilder(const DebugStyle& _style) : m_style(_style) {}
 
 };
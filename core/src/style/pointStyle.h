@@ -55,6 +55,8 @@ public:
     auto& getMesh() const { return m_mesh; }
     virtual size_t dynamicMeshSize() const override { return m_mesh->bufferSize(); }
 
+    virtual bool createsLabels() const override { return true; }
+
     virtual std::unique_ptr<StyleBuilder> createBuilder() const override;
 
     virtual void build(const Scene& _scene) override;
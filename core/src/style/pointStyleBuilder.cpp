@@ -38,6 +38,30 @@ void PointStyleBuilder::addLayoutItems(LabelCollider& _layout) {
     m_textStyleBuilder->addLayoutItems(_layout);
 }
 
+void PointStyleBuilder::merge(StyleBuilder& _other) {
+    auto& other = static_cast<PointStyleBuilder&>(_other);
+
+    size_t quadOffset = m_quads.size();
+
+    for (auto& label : other.m_labels) {
+        static_cast<SpriteLabel&>(*label).rebind(*m_spriteLabels, quadOffset);
+        m_labels.push_back(std::move(label));
+    }
+    m_quads.insert(m_quads.end(), other.m_quads.begin(), other.m_quads.end());
+
+    other.m_labels.clear();
+    other.m_quads.clear();
+
+    // Icon texts stay linked to their icons, which are moved as well
+    m_textStyleBuilder->merge(*other.m_textStyleBuilder);
+}
+
+void PointStyleBuilder::clear() {
+    m_labels.clear();
+    m_quads.clear();
+    m_textStyleBuilder->clear();
+}
+
 std::unique_ptr<StyledMesh> PointStyleBuilder::build() {
     if (m_quads.empty()) { return nullptr; }
 
@@ -306,7 +330,7 @@ bool PointStyleBuilder::getUVQuad(PointStyle::Parameters& _params, glm::vec4& _q
     return true;
 }
 
-void PointStyleBuilder::labelPointsPlacing(const Line& _line, const glm::vec4& uvsQuad,
+void PointStyleBuilder::labelPointsPlacing(const LineRef& _line, const glm::vec4& uvsQuad,
                                            PointStyle::Parameters& params, const DrawRule& _rule) {
 
     if (_line.size() < 2) { return; }
@@ -411,7 +435,7 @@ bool PointStyleBuilder::addPoint(const Point& _point, const Properties& _props,
     return true;
 }
 
-bool PointStyleBuilder::addLine(const Line& _line, const Properties& _props,
+bool PointStyleBuilder::addLine(const LineRef& _line, const Properties& _props,
                                 const DrawRule& _rule) {
 
     PointStyle::Parameters p = applyRule(_rule, _props);
@@ -426,7 +450,7 @@ bool PointStyleBuilder::addLine(const Line& _line, const Properties& _props,
     return true;
 }
 
-bool PointStyleBuilder::addPolygon(const Polygon& _polygon, const Properties& _props,
+bool PointStyleBuilder::addPolygon(const PolygonRef& _polygon, const Properties& _props,
                                    const DrawRule& _rule) {
 
     PointStyle::Parameters p = applyRule(_rule, _props);
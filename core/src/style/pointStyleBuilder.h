@@ -27,12 +27,14 @@ struct PointStyleBuilder : public StyleBuilder {
 
     bool checkRule(const DrawRule& _rule) const override;
 
-    bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
-    bool addLine(const Line& _line, const Properties& _props, const DrawRule& _rule) override;
+    bool addPolygon(const PolygonRef& _polygon, const Properties& _props, const DrawRule& _rule) override;
+    bool addLine(const LineRef& _line, const Properties& _props, const DrawRule& _rule) override;
     bool addPoint(const Point& _line, const Properties& _props, const DrawRule& _rule) override;
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void clear() override;
+
     const Style& style() const override { return m_style; }
 
     PointStyleBuilder(const PointStyle& _style) : m_style(_style) {
@@ -44,7 +46,7 @@ struct PointStyleBuilder : public StyleBuilder {
     PointStyle::Parameters applyRule(const DrawRule& _rule, const Properties& _props) const;
 
     // Gets points for label placement and appropriate angle for each label (if `auto` angle is set)
-    void labelPointsPlacing(const Line& _line, const glm::vec4& _quad,
+    void labelPointsPlacing(const LineRef& _line, const glm::vec4& _quad,
                             PointStyle::Parameters& _params, const DrawRule& _rule);
 
     void addLabel(const Point& _point, const glm::vec4& _quad,
@@ -52,6 +54,10 @@ struct PointStyleBuilder : public StyleBuilder {
 
     void addLayoutItems(LabelCollider& _layout) override;
 
+    bool canMerge() const override { return m_textStyleBuilder->canMerge(); }
+
+    void merge(StyleBuilder& _other) override;
+
     bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
 
 private:
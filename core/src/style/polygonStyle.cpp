@@ -110,18 +110,26 @@ public:
         m_meshData.clear();
     }
 
-    bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
+    bool addPolygon(const PolygonRef& _polygon, const Properties& _props, const DrawRule& _rule) override;
 
     const Style& style() const override { return m_style; }
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void clear() override { m_meshData.clear(); }
+
     PolygonStyleBuilder(const PolygonStyle& _style) : m_style(_style) {}
 
     void parseRule(const DrawRule& _rule, const Properties& _props);
 
     PolygonBuilder& polygonBuilder() { return m_builder; }
 
+    bool canMerge() const override { return true; }
+
+    void merge(StyleBuilder& _other) override {
+        m_meshData.append(static_cast<PolygonStyleBuilder<V>&>(_other).m_meshData);
+    }
+
 private:
 
     const PolygonStyle& m_style;
@@ -165,7 +173,7 @@ void PolygonStyleBuilder<V>::parseRule(const DrawRule& _rule, const Properties&
 }
 
 template <class V>
-bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
+bool PolygonStyleBuilder<V>::addPolygon(const PolygonRef& _polygon, const Properties& _props, const DrawRule& _rule) {
 
     parseRule(_rule, _props);
 
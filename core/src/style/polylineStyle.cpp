@@ -185,13 +185,18 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void clear() override {
+        m_meshData[0].clear();
+        m_meshData[1].clear();
+    }
+
     PolylineStyleBuilder(const PolylineStyle& _style)
         : m_style(_style),
           m_meshData(2) {}
 
-    void addMesh(const Line& _line, const Parameters& _params);
+    void addMesh(const LineRef& _line, const Parameters& _params);
 
-    void buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+    void buildLine(const LineRef& _line, const typename Parameters::Attributes& _att,
                    MeshData<V>& _mesh, GLuint _selection);
 
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
@@ -200,6 +205,14 @@ public:
 
     PolyLineBuilder& polylineBuilder() { return m_builder; }
 
+    bool canMerge() const override { return true; }
+
+    void merge(StyleBuilder& _other) override {
+        auto& other = static_cast<PolylineStyleBuilder<V>&>(_other);
+        m_meshData[0].append(other.m_meshData[0]);
+        m_meshData[1].append(other.m_meshData[1]);
+    }
+
 private:
 
     const PolylineStyle& m_style;
@@ -408,16 +421,15 @@ bool PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
         // Line geometries are never clipped to tiles, so keep all segments
         params.keepTileEdges = true;
 
-        for (auto& line : _feat.lines) {
+        for (auto line : _feat.lines()) {
             addMesh(line, params);
         }
     } else {
         params.closedPolygon = true;
 
-        for (auto& polygon : _feat.polygons) {
-            for (const auto& line : polygon) {
-                addMesh(line, params);
-            }
+        // Outlines of all polygon rings
+        for (auto line : _feat.lines()) {
+            addMesh(line, params);
         }
     }
 
@@ -425,7 +437,7 @@ bool PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+void PolylineStyleBuilder<V>::buildLine(const LineRef& _line, const typename Parameters::Attributes& _att,
                                         MeshData<V>& _mesh, GLuint selection) {
 
     float zoom = m_overzoom2;
@@ -447,7 +459,7 @@ void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parame
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _params) {
+void PolylineStyleBuilder<V>::addMesh(const LineRef& _line, const Parameters& _params) {
 
     m_builder.cap = _params.fill.cap;
     m_builder.join = _params.fill.join;
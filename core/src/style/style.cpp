@@ -504,12 +504,12 @@ bool StyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
             }
             break;
         case GeometryType::lines:
-            for (auto& line : _feat.lines) {
+            for (auto line : _feat.lines()) {
                 added |= addLine(line, _feat.props, _rule);
             }
             break;
         case GeometryType::polygons:
-            for (auto& polygon : _feat.polygons) {
+            for (auto polygon : _feat.polygons()) {
                 added |= addPolygon(polygon, _feat.props, _rule);
             }
             break;
@@ -525,12 +525,12 @@ bool StyleBuilder::addPoint(const Point& _point, const Properties& _props, const
     return false;
 }
 
-bool StyleBuilder::addLine(const Line& _line, const Properties& _props, const DrawRule& _rule) {
+bool StyleBuilder::addLine(const LineRef& _line, const Properties& _props, const DrawRule& _rule) {
     // No-op by default
     return false;
 }
 
-bool StyleBuilder::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
+bool StyleBuilder::addPolygon(const PolygonRef& _polygon, const Properties& _props, const DrawRule& _rule) {
     // No-op by default
     return false;
 }
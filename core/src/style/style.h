@@ -30,6 +30,7 @@ class View;
 struct DrawRule;
 struct LightUniforms;
 struct MaterialUniforms;
+struct MeshBase;
 
 enum class LightingType : uint8_t {
     none,
@@ -56,6 +57,9 @@ struct StyledMesh {
     virtual bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Compiled buffers of meshes built from MeshData, nullptr otherwise */
+    virtual const MeshBase* meshBase() const { return nullptr; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -74,18 +78,28 @@ public:
     virtual bool addPoint(const Point& _point, const Properties& _props, const DrawRule& _rule);
 
     /* Build styled vertex data for line geometry */
-    virtual bool addLine(const Line& _line, const Properties& _props, const DrawRule& _rule);
+    virtual bool addLine(const LineRef& _line, const Properties& _props, const DrawRule& _rule);
 
     /* Build styled vertex data for polygon geometry */
-    virtual bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule);
+    virtual bool addPolygon(const PolygonRef& _polygon, const Properties& _props, const DrawRule& _rule);
 
     /* Create a new mesh object using the vertex layout corresponding to this style */
     virtual std::unique_ptr<StyledMesh> build() = 0;
 
+    /* Drop the geometry and labels added since setup() without building a mesh */
+    virtual void clear() {}
+
     virtual bool checkRule(const DrawRule& _rule) const;
 
     virtual void addLayoutItems(LabelCollider& _layout) {}
 
+    /* Whether this builder implements merge() */
+    virtual bool canMerge() const { return false; }
+
+    /* Append the geometry and labels of @_other, a builder of the same style
+     * that was set up for the same tile. @_other is left empty. */
+    virtual void merge(StyleBuilder& _other) {}
+
     virtual void addSelectionItems(LabelCollider& _layout) {}
 
     virtual const Style& style() const = 0;
@@ -291,6 +305,10 @@ public:
 
     virtual bool hasRasters() const { return m_rasterType != RasterType::none; }
 
+    /* Whether the style creates labels; their meshes refer to the glyph and
+     * sprite atlases of the running scene and cannot be persisted */
+    virtual bool createsLabels() const { return false; }
+
     void setupRasters(const std::vector<std::shared_ptr<TileSource>>& _sources);
 
     std::vector<StyleUniform>& styleUniforms() { return m_mainUniforms.styleUniforms; }
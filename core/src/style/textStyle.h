@@ -101,6 +101,8 @@ public:
 
     virtual size_t dynamicMeshSize() const override;
 
+    virtual bool createsLabels() const override { return true; }
+
     virtual ~TextStyle() override;
 
 private:
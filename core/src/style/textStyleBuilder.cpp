@@ -66,6 +66,29 @@ void TextStyleBuilder::addLayoutItems(LabelCollider& _layout) {
     _layout.addLabels(m_labels);
 }
 
+void TextStyleBuilder::merge(StyleBuilder& _other) {
+    auto& other = static_cast<TextStyleBuilder&>(_other);
+
+    size_t quadOffset = m_quads.size();
+
+    for (auto& label : other.m_labels) {
+        static_cast<TextLabel&>(*label).rebind(*m_textLabels, quadOffset);
+        m_labels.push_back(std::move(label));
+    }
+    m_quads.insert(m_quads.end(), other.m_quads.begin(), other.m_quads.end());
+    m_atlasRefs |= other.m_atlasRefs;
+
+    other.m_labels.clear();
+    other.m_quads.clear();
+    other.m_atlasRefs.reset();
+}
+
+void TextStyleBuilder::clear() {
+    m_labels.clear();
+    m_quads.clear();
+    m_atlasRefs.reset();
+}
+
 std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
 
     if (m_quads.empty()) { return nullptr; }
@@ -243,7 +266,7 @@ bool TextStyleBuilder::handleBoundaryLabel(const Feature& _feat, const DrawRule&
         }
     };
 
-    for (auto& line : _feat.lines) {
+    for (auto line : _feat.lines()) {
         addStraightTextLabels(line, labelWidth, onAddLabel);
     }
 
@@ -277,8 +300,7 @@ bool TextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
             }
 
         } else if (_feat.geometryType == GeometryType::polygons) {
-            const auto& polygons = _feat.polygons;
-            for (const auto& polygon : polygons) {
+            for (auto polygon : _feat.polygons()) {
                 if (!polygon.empty()) {
                     glm::vec3 c;
                     c = centroid(polygon.front().begin(), polygon.front().end());
@@ -298,7 +320,7 @@ bool TextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
     return true;
 }
 
-bool TextStyleBuilder::addStraightTextLabels(const Line& _line, float _labelWidth,
+bool TextStyleBuilder::addStraightTextLabels(const LineRef& _line, float _labelWidth,
                                              const std::function<void(glm::vec2,glm::vec2)>& _onAddLabel) {
 
     // Size of pixel in tile coordinates
@@ -377,7 +399,7 @@ bool TextStyleBuilder::addStraightTextLabels(const Line& _line, float _labelWidt
     return false;
 }
 
-void TextStyleBuilder::addCurvedTextLabels(const Line& _line, const TextStyle::Parameters& _params,
+void TextStyleBuilder::addCurvedTextLabels(const LineRef& _line, const TextStyle::Parameters& _params,
                                            const LabelAttributes& _attributes, const DrawRule& _rule) {
 
     // Size of pixel in tile coordinates
@@ -537,7 +559,7 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
         addLabel(Label::Type::line, {{ a, b }}, _params, _attributes, _rule);
     };
 
-    for (auto& line : _feat.lines) {
+    for (auto line : _feat.lines()) {
 
         if (!addStraightTextLabels(line, _attributes.width, straightLabelCb) &&
             line.size() > 2 && !_params.hasComplexShaping &&
@@ -37,6 +37,8 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void clear() override;
+
     TextStyle::Parameters applyRule(const DrawRule& _rule, const Properties& _props, bool _iconText) const;
 
     bool prepareLabel(TextStyle::Parameters& _params, Label::Type _type, LabelAttributes& _attributes);
@@ -48,10 +50,10 @@ public:
     void addLineTextLabels(const Feature& _feature, const TextStyle::Parameters& _params,
                            const LabelAttributes& _attributes, const DrawRule& _rule);
 
-    bool addStraightTextLabels(const Line& _feature, float _labelWidth,
+    bool addStraightTextLabels(const LineRef& _feature, float _labelWidth,
                                const std::function<void(glm::vec2,glm::vec2)>& _onAddLabel);
 
-    void addCurvedTextLabels(const Line& _feature, const TextStyle::Parameters& _params,
+    void addCurvedTextLabels(const LineRef& _feature, const TextStyle::Parameters& _params,
                              const LabelAttributes& _attributes, const DrawRule& _rule);
 
     bool handleBoundaryLabel(const Feature& _feat, const DrawRule& _rule,
@@ -63,6 +65,10 @@ public:
 
     void addLayoutItems(LabelCollider& _layout) override;
 
+    bool canMerge() const override { return true; }
+
+    void merge(StyleBuilder& _other) override;
+
 protected:
 
     const TextStyle& m_style;
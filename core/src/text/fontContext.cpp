@@ -73,6 +73,9 @@ void FontContext::addGlyph(alfons::AtlasID id, uint16_t gx, uint16_t gy, uint16_
     auto& texData = m_textures[id].texData;
     auto& texture = m_textures[id].texture;
 
+    // Released by releaseUnusedTextures()
+    if (texData.empty()) { texData.resize(GlyphTexture::size * GlyphTexture::size); }
+
     size_t stride = GlyphTexture::size;
     size_t width =  GlyphTexture::size;
 
@@ -107,6 +110,25 @@ void FontContext::releaseAtlas(std::bitset<max_textures> _refs) {
     }
 }
 
+size_t FontContext::releaseUnusedTextures() {
+    // Same lock order as layoutText()
+    std::lock_guard<std::mutex> fontLock(m_fontMutex);
+    std::lock_guard<std::mutex> lock(m_textureMutex);
+
+    size_t size = 0;
+    for (size_t i = 0; i < m_textures.size(); i++) {
+        auto& texData = m_textures[i].texData;
+
+        if (m_atlasRefCount[i] == 0 && !texData.empty()) {
+            m_atlas.clear(i);
+            size += texData.capacity();
+            std::vector<unsigned char>().swap(texData);
+            m_textures[i].dirty = false;
+        }
+    }
+    return size;
+}
+
 void FontContext::updateTextures(RenderState& rs) {
     std::lock_guard<std::mutex> lock(m_textureMutex);
 
@@ -253,7 +275,7 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const icu::UnicodeS
 
         // Clear unused textures
         for (size_t i = 0; i < m_textures.size(); i++) {
-            if (m_atlasRefCount[i] == 0) {
+            if (m_atlasRefCount[i] == 0 && !m_textures[i].texData.empty()) {
                 m_atlas.clear(i);
                 m_textures[i].texData.assign(GlyphTexture::size *
                                              GlyphTexture::size, 0);
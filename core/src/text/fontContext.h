@@ -84,6 +84,12 @@ public:
 
     void releaseAtlas(std::bitset<max_textures> _refs);
 
+    /* Drops the pixels of glyph textures that are not used by any label.
+     * Their glyphs are rendered again when needed. Returns the number of
+     * bytes released.
+     */
+    size_t releaseUnusedTextures();
+
     /* Update all textures batches, uploads the data to the GPU */
     void updateTextures(RenderState& rs);
 
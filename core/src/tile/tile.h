@@ -100,6 +100,12 @@ public:
 
     void setProxyState(bool isProxy) { m_proxyState = isProxy; }
 
+    /* Whether the tile was built from data sliced from a parent tile,
+     * to be replaced once the tile's own data is loaded */
+    bool isProvisional() const { return m_provisional; }
+
+    void setProvisional(bool _provisional) { m_provisional = _provisional; }
+
 private:
 
     const TileID m_id;
@@ -118,6 +124,8 @@ private:
 
     bool m_proxyState = false;
 
+    bool m_provisional = false;
+
     glm::dvec2 m_tileOrigin; // South-West corner of the tile in 2D projection space in meters (e.g. mercator meters)
 
     glm::mat4 m_modelMatrix; // Matrix relating tile-local coordinates to global projection space coordinates;
@@ -10,19 +10,50 @@
 #include "selection/featureSelection.h"
 #include "style/style.h"
 #include "tile/tile.h"
+#include "util/asyncWorker.h"
 #include "util/mapProjection.h"
 #include "view/view.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+// Smaller tiles are not worth the synchronization overhead
+#define PARALLEL_STYLING_MIN_FEATURES 512
+
+// Number of features styled between checks for cancellation
+#define CANCEL_CHECK_INTERVAL 64
+
 namespace Tangram {
 
-TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
+struct TileBuilder::Helper {
+    TileBuilder builder;
+    AsyncWorker worker;
+
+    Helper(std::shared_ptr<Scene> _scene) : builder(_scene) {}
+};
+
+TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene, size_t _styleWorkers)
     : m_scene(_scene) {
 
     m_styleContext.initFunctions(*_scene);
 
+    bool canMerge = true;
+
     // Initialize StyleBuilders
     for (auto& style : _scene->styles()) {
-        m_styleBuilder[style->getName()] = style->createBuilder();
+        auto builder = style->createBuilder();
+        canMerge &= builder->canMerge();
+        m_styleBuilder[style->getName()] = std::move(builder);
+    }
+
+    if (_styleWorkers > 0 && !canMerge) {
+        LOGW("Parallel styling is disabled: Not all styles support merging");
+        _styleWorkers = 0;
+    }
+
+    for (size_t i = 0; i < _styleWorkers; i++) {
+        m_helpers.push_back(std::make_unique<Helper>(_scene));
     }
 }
 
@@ -40,6 +71,10 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
     // If no rules matched the feature, return immediately
     if (!m_ruleSet.match(_feature, _layer, m_styleContext)) { return; }
 
+    // Filters only use the properties: Decode the geometry of lazily
+    // parsed features once they are going to be built
+    _feature.decodeGeometry();
+
     uint32_t selectionColor = 0;
     bool added = false;
 
@@ -54,6 +89,8 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             continue;
         }
 
+        if (m_labelsOnly && !style->style().createsLabels()) { continue; }
+
         // Apply defaul draw rules defined for this style
         style->style().applyDefaultDrawRules(rule);
 
@@ -79,7 +116,7 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             auto* outlineStyle = getStyleBuilder(styleName);
             if (!outlineStyle) {
                 LOGN("Invalid style %s", styleName.c_str());
-            } else {
+            } else if (!m_labelsOnly || outlineStyle->style().createsLabels()) {
                 rule.isOutlineOnly = true;
                 outlineStyle->addFeature(_feature, rule);
                 rule.isOutlineOnly = false;
@@ -95,41 +132,174 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
     }
 }
 
-std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const TileSource& _source) {
+void TileBuilder::setup(const Tile& _tile) {
 
     m_selectionFeatures.clear();
 
+    m_styleContext.setKeywordZoom(_tile.getID().s);
+
+    for (auto& builder : m_styleBuilder) {
+        if (builder.second)
+            builder.second->setup(_tile);
+    }
+}
+
+static bool layerContainsCollection(const DataLayer& _layer, const std::string& _collection) {
+    if (_collection.empty()) { return true; }
+
+    const auto& dlc = _layer.collections();
+    return std::find(dlc.begin(), dlc.end(), _collection) != dlc.end();
+}
+
+bool TileBuilder::applyStyling(const DataLayer& _layer, const TileData& _data) {
+
+    for (const auto& collection : _data.layers) {
+
+        if (!layerContainsCollection(_layer, collection.name)) { continue; }
+
+        size_t count = 0;
+        for (const auto& feat : collection.features) {
+            if (m_canceled && ++count % CANCEL_CHECK_INTERVAL == 0 && *m_canceled) {
+                return false;
+            }
+            applyStyling(feat, _layer);
+        }
+    }
+    return !(m_canceled && *m_canceled);
+}
+
+void TileBuilder::applyStylingParallel(const Tile& _tile, const TileData& _data,
+                                       const std::vector<const DataLayer*>& _layers,
+                                       const std::vector<size_t>& _featureCount) {
+
+    size_t numParts = std::min(m_helpers.size() + 1, _layers.size());
+
+    size_t totalFeatures = 0;
+    for (auto count : _featureCount) { totalFeatures += count; }
+
+    // Split layers into contiguous ranges with a similar number of features.
+    // Part 0 is styled by this builder, the others by the helpers.
+    std::vector<size_t> partEnd;
+    size_t features = 0;
+    for (size_t i = 0; i < _layers.size(); i++) {
+        features += _featureCount[i];
+
+        bool lastPart = partEnd.size() == numParts - 1;
+        size_t layersLeft = _layers.size() - i - 1;
+        size_t partsLeft = numParts - partEnd.size() - 1;
+
+        if (!lastPart && (features * numParts >= totalFeatures * (partEnd.size() + 1) ||
+                          layersLeft == partsLeft)) {
+            partEnd.push_back(i + 1);
+        }
+    }
+    partEnd.push_back(_layers.size());
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t pending = partEnd.size() - 1;
+
+    for (size_t part = 1; part < partEnd.size(); part++) {
+        auto& helper = *m_helpers[part - 1];
+
+        helper.builder.m_canceled = m_canceled;
+        helper.builder.m_labelsOnly = m_labelsOnly;
+
+        helper.worker.enqueue([&, part]() {
+            helper.builder.setup(_tile);
+
+            for (size_t i = partEnd[part - 1]; i < partEnd[part]; i++) {
+                if (!helper.builder.applyStyling(*_layers[i], _data)) { break; }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            condition.notify_one();
+        });
+    }
+
+    for (size_t i = 0; i < partEnd[0]; i++) {
+        if (!applyStyling(*_layers[i], _data)) { break; }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]{ return pending == 0; });
+    }
+
+    // Merge in DataLayer order
+    for (size_t part = 1; part < partEnd.size(); part++) {
+        auto& helper = m_helpers[part - 1]->builder;
+
+        for (auto& builder : m_styleBuilder) {
+            auto* other = helper.getStyleBuilder(builder.first.k);
+            if (builder.second && other) {
+                builder.second->merge(*other);
+            }
+        }
+        for (auto& feature : helper.m_selectionFeatures) {
+            m_selectionFeatures[feature.first] = std::move(feature.second);
+        }
+        helper.m_selectionFeatures.clear();
+    }
+}
+
+std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const TileSource& _source,
+                                         const std::atomic<bool>* _canceled) {
+
+    m_canceled = _canceled;
+
     auto tile = std::make_shared<Tile>(_tileID, *m_scene->mapProjection(), &_source);
 
     tile->initGeometry(m_scene->styles().size());
 
-    m_styleContext.setKeywordZoom(_tileID.s);
+    setup(*tile);
 
-    for (auto& builder : m_styleBuilder) {
-        if (builder.second)
-            builder.second->setup(*tile);
-    }
+    std::vector<const DataLayer*> layers;
+    std::vector<size_t> featureCount;
+    size_t totalFeatures = 0;
 
     for (const auto& datalayer : m_scene->layers()) {
 
         if (datalayer.source() != _source.name()) { continue; }
 
+        size_t count = 0;
         for (const auto& collection : _tileData.layers) {
+            if (layerContainsCollection(datalayer, collection.name)) {
+                count += collection.features.size();
+            }
+        }
+        if (count == 0) { continue; }
 
-            if (!collection.name.empty()) {
-                const auto& dlc = datalayer.collections();
-                bool layerContainsCollection =
-                    std::find(dlc.begin(), dlc.end(), collection.name) != dlc.end();
+        layers.push_back(&datalayer);
+        featureCount.push_back(count);
+        totalFeatures += count;
+    }
 
-                if (!layerContainsCollection) { continue; }
-            }
+    if (!m_helpers.empty() && layers.size() > 1 &&
+        totalFeatures >= PARALLEL_STYLING_MIN_FEATURES) {
 
-            for (const auto& feat : collection.features) {
-                applyStyling(feat, datalayer);
-            }
+        applyStylingParallel(*tile, _tileData, layers, featureCount);
+
+    } else {
+        for (auto* datalayer : layers) {
+            if (!applyStyling(*datalayer, _tileData)) { break; }
         }
     }
 
+    auto canceled = [&]() {
+        if (!_canceled || !*_canceled) { return false; }
+
+        // Drop what was added so far
+        for (auto& builder : m_styleBuilder) {
+            builder.second->clear();
+        }
+        return true;
+    };
+
+    if (canceled()) { return nullptr; }
+
     for (auto& builder : m_styleBuilder) {
 
         builder.second->addLayoutItems(m_labelLayout);
@@ -137,7 +307,9 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
 
     float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
 
-    m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
+    m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize, _canceled);
+
+    if (canceled()) { return nullptr; }
 
     for (auto& builder : m_styleBuilder) {
         tile->setMesh(builder.second->style(), builder.second->build());
@@ -148,4 +320,14 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
     return tile;
 }
 
+std::shared_ptr<Tile> TileBuilder::buildLabels(TileID _tileID, const TileData& _tileData,
+                                               const TileSource& _source,
+                                               const std::atomic<bool>* _canceled) {
+    m_labelsOnly = true;
+    auto tile = build(_tileID, _tileData, _source, _canceled);
+    m_labelsOnly = false;
+
+    return tile;
+}
+
 }
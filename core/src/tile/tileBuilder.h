@@ -5,6 +5,10 @@
 #include "scene/styleContext.h"
 #include "scene/drawRule.h"
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace Tangram {
 
 class DataLayer;
@@ -15,22 +19,52 @@ struct Feature;
 struct Properties;
 struct TileData;
 
+/* Builds Tiles from TileData
+ *
+ * With @_styleWorkers > 0 the DataLayers of large tiles are split into
+ * contiguous ranges that are styled concurrently by helper builders, each
+ * with its own StyleContext and StyleBuilders. Their results are merged in
+ * DataLayer order, so that the tile is the same as when styled sequentially.
+ */
 class TileBuilder {
 
 public:
 
-    TileBuilder(std::shared_ptr<Scene> _scene);
+    TileBuilder(std::shared_ptr<Scene> _scene, size_t _styleWorkers = 0);
 
     ~TileBuilder();
 
     StyleBuilder* getStyleBuilder(const std::string& _name);
 
-    std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const TileSource& _source);
+    // Returns nullptr when @_canceled is set while building
+    std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const TileSource& _source,
+                                const std::atomic<bool>* _canceled = nullptr);
+
+    // Build only the meshes of styles that create labels, for a tile whose
+    // other meshes are restored from a TileDiskCache
+    std::shared_ptr<Tile> buildLabels(TileID _tileID, const TileData& _data, const TileSource& _source,
+                                      const std::atomic<bool>* _canceled = nullptr);
 
     const Scene& scene() const { return *m_scene; }
 
+    size_t styleWorkers() const { return m_helpers.size(); }
+
 private:
 
+    struct Helper;
+
+    // Prepare StyleBuilders and StyleContext for building @_tile
+    void setup(const Tile& _tile);
+
+    // Apply styling to all features of @_data that belong to @_layer.
+    // Returns false when the build was canceled.
+    bool applyStyling(const DataLayer& _layer, const TileData& _data);
+
+    // Style ranges of @_layers on the helpers and merge their results
+    void applyStylingParallel(const Tile& _tile, const TileData& _data,
+                              const std::vector<const DataLayer*>& _layers,
+                              const std::vector<size_t>& _featureCount);
+
     // Determine and apply DrawRules for a @_feature
     void applyStyling(const Feature& _feature, const SceneLayer& _layer);
 
@@ -44,6 +78,14 @@ private:
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
+
+    std::vector<std::unique_ptr<Helper>> m_helpers;
+
+    // Cancel flag of the current build
+    const std::atomic<bool>* m_canceled = nullptr;
+
+    // Skip draw rules of styles that do not create labels
+    bool m_labelsOnly = false;
 };
 
 }
@@ -0,0 +1,444 @@
+#include "tile/tileBundle.h"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+#include "gl/mesh.h"
+#include "log.h"
+#include "scene/scene.h"
+#include "selection/featureSelection.h"
+#include "style/style.h"
+#include "tile/tile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tangram {
+
+const uint32_t TileBundle::VERSION = 2;
+
+const size_t TileBundle::ALIGNMENT = 16;
+
+static const char MAGIC[4] = { 'T', 'G', 'T', 'B' };
+
+enum BundleFlags : uint32_t {
+    has_labels = 1 << 0,
+};
+
+enum class ValueType : uint8_t {
+    none,
+    number,
+    string,
+};
+
+struct BundleHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t flags;
+    uint32_t numMeshes;
+    uint32_t featuresOffset;
+    uint32_t numFeatures;
+};
+
+// Offsets are relative to the start of the bundle
+struct MeshRecord {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t drawMode;
+    uint32_t stride;
+    uint32_t batchesOffset;
+    uint32_t numBatches;
+    uint32_t vertexOffset;
+    uint32_t numVertices;
+    uint32_t indexOffset;
+    uint32_t numIndices;
+};
+
+// Appends plain values to a bundle
+struct Writer {
+    std::vector<char>& out;
+
+    void put(const void* _data, size_t _size) {
+        auto* data = static_cast<const char*>(_data);
+        out.insert(out.end(), data, data + _size);
+    }
+
+    template<typename T>
+    void put(const T& _value) { put(&_value, sizeof(T)); }
+
+    void put(const std::string& _string) {
+        put(uint32_t(_string.size()));
+        put(_string.data(), _string.size());
+    }
+
+    uint32_t align(size_t _alignment) {
+        out.resize((out.size() + _alignment - 1) / _alignment * _alignment);
+        return out.size();
+    }
+};
+
+// Reads plain values from a bundle, fails on reading past the end
+struct Reader {
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+
+    const char* take(size_t _size) {
+        if (pos > size || _size > size - pos) { return nullptr; }
+        const char* result = data + pos;
+        pos += _size;
+        return result;
+    }
+
+    template<typename T>
+    bool get(T& _value) {
+        const char* result = take(sizeof(T));
+        if (!result) { return false; }
+        std::memcpy(&_value, result, sizeof(T));
+        return true;
+    }
+
+    bool get(std::string& _string) {
+        uint32_t length;
+        if (!get(length)) { return false; }
+        const char* result = take(length);
+        if (!result) { return false; }
+        _string.assign(result, length);
+        return true;
+    }
+};
+
+// Byte offset of the selection color in vertices of @_layout, or -1
+static int selectionColorOffset(const VertexLayout& _layout) {
+    for (auto& attrib : _layout.getAttribs()) {
+        if (attrib.name == "a_selection_color") {
+            return attrib.offset;
+        }
+    }
+    return -1;
+}
+
+std::shared_ptr<TileBundle> TileBundle::map(const std::string& _path) {
+
+#if defined(_WIN32)
+    // No mapping: Read the file
+    FILE* file = fopen(_path.c_str(), "rb");
+    if (!file) { return nullptr; }
+
+    std::vector<char> data;
+    char buffer[4096];
+    while (size_t size = fread(buffer, 1, sizeof(buffer), file)) {
+        data.insert(data.end(), buffer, buffer + size);
+    }
+    fclose(file);
+
+    if (data.empty()) { return nullptr; }
+
+    return fromData(std::move(data));
+#else
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0) { return nullptr; }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // Private mapping: Replacing selection colors only copies the touched pages
+    void* data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        LOGW("Cannot map tile bundle: %s", _path.c_str());
+        return nullptr;
+    }
+
+    auto bundle = std::shared_ptr<TileBundle>(new TileBundle());
+    bundle->m_data = static_cast<char*>(data);
+    bundle->m_size = info.st_size;
+    bundle->m_mapped = true;
+
+    return bundle;
+#endif
+}
+
+std::shared_ptr<TileBundle> TileBundle::fromData(std::vector<char> _data) {
+
+    auto bundle = std::shared_ptr<TileBundle>(new TileBundle());
+    bundle->m_buffer = std::move(_data);
+    bundle->m_data = bundle->m_buffer.data();
+    bundle->m_size = bundle->m_buffer.size();
+
+    return bundle;
+}
+
+TileBundle::~TileBundle() {
+#if !defined(_WIN32)
+    if (m_mapped) { munmap(m_data, m_size); }
+#endif
+}
+
+std::vector<char> TileBundle::encode(uint64_t _key, const Tile& _tile, const Scene& _scene) {
+
+    BundleHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.key = _key;
+    header.flags = 0;
+    header.numMeshes = 0;
+    header.featuresOffset = 0;
+    header.numFeatures = _tile.getSelectionFeatures().size();
+
+    std::vector<std::pair<const Style*, const MeshBase*>> meshes;
+
+    for (auto& style : _scene.styles()) {
+        auto& mesh = _tile.getMesh(*style);
+        if (!mesh) { continue; }
+
+        if (style->createsLabels()) {
+            header.flags |= has_labels;
+            continue;
+        }
+
+        auto* meshBase = mesh->meshBase();
+        if (!meshBase || (!meshBase->vertexData() && meshBase->vertexCount() > 0)) {
+            LOGW("Cannot encode mesh of style '%s'", style->getName().c_str());
+            return {};
+        }
+        meshes.emplace_back(style.get(), meshBase);
+    }
+    header.numMeshes = meshes.size();
+
+    std::vector<char> data;
+    Writer out{data};
+
+    out.put(header);
+
+    std::vector<MeshRecord> records(meshes.size());
+    size_t recordsOffset = data.size();
+    data.resize(data.size() + records.size() * sizeof(MeshRecord));
+
+    for (size_t i = 0; i < meshes.size(); i++) {
+        auto& style = *meshes[i].first;
+        auto& mesh = *meshes[i].second;
+        auto& record = records[i];
+
+        record.drawMode = mesh.drawMode();
+        record.stride = mesh.vertexLayout()->getStride();
+
+        record.nameOffset = data.size();
+        record.nameLength = style.getName().size();
+        out.put(style.getName().data(), style.getName().size());
+
+        record.batchesOffset = out.align(alignof(uint32_t));
+        record.numBatches = mesh.vertexOffsets().size();
+        for (auto& batch : mesh.vertexOffsets()) {
+            out.put(batch.first);
+            out.put(batch.second);
+        }
+
+        record.vertexOffset = out.align(ALIGNMENT);
+        record.numVertices = mesh.vertexCount();
+        out.put(mesh.vertexData(), mesh.vertexCount() * record.stride);
+
+        record.indexOffset = out.align(ALIGNMENT);
+        record.numIndices = mesh.indexCount();
+        out.put(mesh.indexData(), mesh.indexCount() * sizeof(GLushort));
+    }
+
+    header.featuresOffset = out.align(alignof(uint64_t));
+
+    for (auto& feature : _tile.getSelectionFeatures()) {
+        auto& props = *feature.second;
+
+        out.put(feature.first);
+        out.put(props.sourceId);
+        out.put(uint32_t(props.items().size()));
+
+        for (auto& item : props.items()) {
+            out.put(item.key.str());
+            if (item.value.is<double>()) {
+                out.put(ValueType::number);
+                out.put(item.value.get<double>());
+            } else if (item.value.is<std::string>()) {
+                out.put(ValueType::string);
+                out.put(item.value.get<std::string>());
+            } else {
+                out.put(ValueType::none);
+            }
+        }
+    }
+
+    if (data.size() > UINT32_MAX) {
+        LOGW("Tile %s is too large for a bundle", _tile.getID().toString().c_str());
+        return {};
+    }
+
+    std::memcpy(data.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(data.data() + recordsOffset, records.data(), records.size() * sizeof(MeshRecord));
+    }
+
+    return data;
+}
+
+bool TileBundle::isValid(uint64_t _key) const {
+
+    BundleHeader header;
+    if (m_size < sizeof(header)) { return false; }
+
+    std::memcpy(&header, m_data, sizeof(header));
+
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+        header.version == VERSION && header.key == _key;
+}
+
+bool TileBundle::hasLabels() const {
+
+    BundleHeader header;
+    if (m_size < sizeof(header)) { return false; }
+
+    std::memcpy(&header, m_data, sizeof(header));
+
+    return header.flags & has_labels;
+}
+
+bool TileBundle::decode(uint64_t _key, Tile& _tile, const Scene& _scene) {
+
+    if (!isValid(_key)) { return false; }
+
+    Reader in{m_data, m_size};
+
+    BundleHeader header;
+    in.get(header);
+
+    // Selection colors of the bundle and their replacement
+    fastmap<uint32_t, uint32_t> selectionColors;
+
+    auto newSelectionColor = [&](uint32_t _color) {
+        auto it = selectionColors.find(_color);
+        if (it != selectionColors.end()) { return it->second; }
+
+        uint32_t color = _scene.featureSelection()->nextColorIdentifier();
+        selectionColors[_color] = color;
+        return color;
+    };
+
+    auto inBundle = [&](size_t _offset, size_t _size) {
+        return _offset <= m_size && _size <= m_size - _offset;
+    };
+
+    std::vector<std::pair<const Style*, std::unique_ptr<StyledMesh>>> meshes;
+
+    for (uint32_t i = 0; i < header.numMeshes; i++) {
+        MeshRecord record;
+        if (!in.get(record)) { return false; }
+
+        size_t vertexBytes = size_t(record.numVertices) * record.stride;
+        size_t indexBytes = size_t(record.numIndices) * sizeof(GLushort);
+
+        if (!inBundle(record.nameOffset, record.nameLength) ||
+            !inBundle(record.batchesOffset, size_t(record.numBatches) * 2 * sizeof(uint32_t)) ||
+            !inBundle(record.vertexOffset, vertexBytes) ||
+            !inBundle(record.indexOffset, indexBytes) ||
+            record.vertexOffset % ALIGNMENT != 0 || record.indexOffset % ALIGNMENT != 0) {
+            return false;
+        }
+
+        std::string name(m_data + record.nameOffset, record.nameLength);
+
+        auto* style = _scene.findStyle(name);
+        if (!style || style->createsLabels() ||
+            size_t(style->vertexLayout()->getStride()) != record.stride) {
+            return false;
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> batches(record.numBatches);
+        auto* batchData = m_data + record.batchesOffset;
+        for (auto& batch : batches) {
+            std::memcpy(&batch.first, batchData, sizeof(uint32_t));
+            std::memcpy(&batch.second, batchData + sizeof(uint32_t), sizeof(uint32_t));
+            batchData += 2 * sizeof(uint32_t);
+        }
+
+        auto* vertices = reinterpret_cast<GLbyte*>(m_data + record.vertexOffset);
+        auto* indices = reinterpret_cast<GLushort*>(m_data + record.indexOffset);
+
+        int selectionOffset = selectionColorOffset(*style->vertexLayout());
+        if (selectionOffset >= 0) {
+            for (size_t offset = selectionOffset; offset < vertexBytes; offset += record.stride) {
+                uint32_t color;
+                std::memcpy(&color, vertices + offset, sizeof(color));
+                if (color == 0) { continue; }
+
+                color = newSelectionColor(color);
+                std::memcpy(vertices + offset, &color, sizeof(color));
+            }
+        }
+
+        auto mesh = std::make_unique<RawMesh>(style->vertexLayout(), record.drawMode);
+        mesh->compile(shared_from_this(), vertices, record.numVertices,
+                      indices, record.numIndices, std::move(batches));
+
+        meshes.emplace_back(style, std::move(mesh));
+    }
+
+    auto selectionFeatures = _tile.getSelectionFeatures();
+
+    in.pos = header.featuresOffset;
+
+    for (uint32_t i = 0; i < header.numFeatures; i++) {
+        uint32_t color, numItems;
+        auto props = std::make_shared<Properties>();
+
+        if (!in.get(color) || !in.get(props->sourceId) || !in.get(numItems)) { return false; }
+
+        std::vector<Properties::Item> items;
+        items.reserve(std::min<size_t>(numItems, m_size));
+
+        for (uint32_t j = 0; j < numItems; j++) {
+            std::string key;
+            ValueType type;
+            if (!in.get(key) || !in.get(type)) { return false; }
+
+            switch (type) {
+            case ValueType::number: {
+                double number;
+                if (!in.get(number)) { return false; }
+                items.emplace_back(std::move(key), number);
+                break;
+            }
+            case ValueType::string: {
+                std::string string;
+                if (!in.get(string)) { return false; }
+                items.emplace_back(std::move(key), std::move(string));
+                break;
+            }
+            default:
+                items.emplace_back(std::move(key), Value());
+            }
+        }
+        props->setSorted(std::move(items));
+
+        selectionFeatures[newSelectionColor(color)] = std::move(props);
+    }
+
+    // Only change the tile when the whole bundle is valid
+    for (auto& mesh : meshes) {
+        _tile.setMesh(*mesh.first, std::move(mesh.second));
+    }
+    _tile.setSelectionFeatures(selectionFeatures);
+
+    return true;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class Scene;
+class Tile;
+
+/* Binary container of the compiled meshes and selection features of a Tile
+ *
+ * Layout, in host byte order:
+ *   BundleHeader
+ *   MeshRecord[numMeshes]
+ *   Style names, vertex batches, vertex data and index data of each mesh
+ *   Selection features
+ * Vertex and index data start at offsets aligned to ALIGNMENT, so that a
+ * mapped bundle file is passed to the GL without copies.
+ *
+ * Meshes of styles that create labels are not included: They refer to the
+ * glyph and sprite atlases of the running scene. The labels of a bundle
+ * with HAS_LABELS are built from the tile data.
+ *
+ * Bundles are written by encode() and read from memory or from a mapped
+ * file. The meshes that decode() adds to a Tile refer to the memory of the
+ * bundle until they are uploaded.
+ */
+class TileBundle : public std::enable_shared_from_this<TileBundle> {
+
+public:
+
+    static const uint32_t VERSION;
+
+    // Alignment of vertex and index data
+    static const size_t ALIGNMENT;
+
+    // Map the bundle file at @_path. Returns nullptr when it cannot be read.
+    static std::shared_ptr<TileBundle> map(const std::string& _path);
+
+    // Bundle in @_data, as returned by encode()
+    static std::shared_ptr<TileBundle> fromData(std::vector<char> _data);
+
+    // Encode the meshes and selection features of @_tile, which must not
+    // be uploaded yet, as bundle @_key
+    static std::vector<char> encode(uint64_t _key, const Tile& _tile, const Scene& _scene);
+
+    ~TileBundle();
+
+    // Whether this is a bundle @_key of a supported version
+    bool isValid(uint64_t _key) const;
+
+    // Whether the tile has labels to be built from its data
+    bool hasLabels() const;
+
+    size_t size() const { return m_size; }
+
+    // Add the meshes and selection features of the bundle to @_tile. Selection
+    // colors are replaced by new ones of @_scene, in place, so that a bundle
+    // can only be decoded once. Returns false when the bundle is not valid for
+    // @_key and @_scene.
+    bool decode(uint64_t _key, Tile& _tile, const Scene& _scene);
+
+private:
+
+    TileBundle() = default;
+
+    char* m_data = nullptr;
+    size_t m_size = 0;
+
+    // Memory of a bundle that is not mapped
+    std::vector<char> m_buffer;
+    bool m_mapped = false;
+};
+
+}
@@ -0,0 +1,285 @@
+#include "tile/tileCache.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+// Share of the cache size for tiles that were cached only once
+const static float ONCE_QUEUE_SHARE = 0.25f;
+
+// Minimum number of remembered keys of recently evicted or reused tiles
+const static size_t MIN_GHOSTS = 128;
+
+TileCache::TileCache(size_t _cacheSizeBytes) :
+    m_cacheSize(_cacheSizeBytes) {}
+
+std::vector<TileCacheKey> TileCache::put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
+
+    TileCacheKey key(_sourceId, _tile->getID());
+    auto& source = m_sources[_sourceId];
+
+    // Replace a tile that is already cached
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        erase(_sourceId, source, it->second);
+    }
+
+    insert(_sourceId, source, std::move(_tile), removeGhost(key));
+
+    std::vector<TileCacheKey> evicted;
+
+    evictOverQuota(_sourceId, source, evicted);
+    evictOverSize(evicted);
+
+    return evicted;
+}
+
+std::shared_ptr<Tile> TileCache::get(int32_t _sourceId, TileID _tileId) {
+
+    TileCacheKey key(_sourceId, _tileId);
+    auto& source = m_sources[_sourceId];
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        m_stats.misses++;
+        source.stats.misses++;
+        return nullptr;
+    }
+
+    auto tile = std::move(it->second->tile);
+    erase(_sourceId, source, it->second);
+
+    m_stats.hits++;
+    source.stats.hits++;
+
+    addGhost(key);
+
+    return tile;
+}
+
+std::shared_ptr<Tile> TileCache::contains(int32_t _sourceId, TileID _tileID) const {
+
+    auto it = m_entries.find(TileCacheKey(_sourceId, _tileID));
+    if (it != m_entries.end()) {
+        return it->second->tile;
+    }
+    return nullptr;
+}
+
+std::vector<TileCacheKey> TileCache::limitCacheSize(size_t _cacheSizeBytes) {
+    m_cacheSize = _cacheSizeBytes;
+
+    std::vector<TileCacheKey> evicted;
+    evictOverSize(evicted);
+
+    return evicted;
+}
+
+std::vector<TileCacheKey> TileCache::setSourceQuota(int32_t _sourceId, size_t _quotaBytes) {
+    auto& source = m_sources[_sourceId];
+    source.quota = _quotaBytes;
+
+    std::vector<TileCacheKey> evicted;
+    evictOverQuota(_sourceId, source, evicted);
+
+    return evicted;
+}
+
+std::vector<std::pair<int32_t, TileCache::Stats>> TileCache::sourceStats() const {
+    std::vector<std::pair<int32_t, Stats>> stats;
+    stats.reserve(m_sources.size());
+
+    for (auto& source : m_sources) {
+        stats.emplace_back(source.first, source.second.stats);
+    }
+    return stats;
+}
+
+void TileCache::clear() {
+    for (auto& source : m_sources) {
+        source.second.once.clear();
+        source.second.reused.clear();
+        source.second.stats.memoryUsage = 0;
+        source.second.stats.tiles = 0;
+    }
+    m_entries.clear();
+    m_ghosts.clear();
+    m_ghostEntries.clear();
+
+    m_onceUsage = 0;
+    m_stats.memoryUsage = 0;
+    m_stats.tiles = 0;
+}
+
+void TileCache::removeSource(int32_t _sourceId) {
+
+    auto it = m_sources.find(_sourceId);
+    if (it != m_sources.end()) {
+        auto& source = it->second;
+        while (!source.once.empty()) { erase(_sourceId, source, source.once.begin()); }
+        while (!source.reused.empty()) { erase(_sourceId, source, source.reused.begin()); }
+
+        m_sources.erase(it);
+    }
+
+    for (auto ghost = m_ghosts.begin(); ghost != m_ghosts.end(); ) {
+        if (ghost->first == _sourceId) {
+            m_ghostEntries.erase(*ghost);
+            ghost = m_ghosts.erase(ghost);
+        } else {
+            ++ghost;
+        }
+    }
+}
+
+std::vector<TileCacheKey> TileCache::removeTiles(int32_t _sourceId,
+                                                 const std::function<bool(const Tile&)>& _remove) {
+    std::vector<TileCacheKey> removed;
+
+    auto it = m_sources.find(_sourceId);
+    if (it == m_sources.end()) { return removed; }
+
+    auto& source = it->second;
+    for (auto* list : { &source.once, &source.reused }) {
+        for (auto entry = list->begin(); entry != list->end(); ) {
+            auto next = std::next(entry);
+            if (_remove(*entry->tile)) {
+                removed.emplace_back(_sourceId, entry->id);
+                erase(_sourceId, source, entry);
+            }
+            entry = next;
+        }
+    }
+    return removed;
+}
+
+void TileCache::insert(int32_t _sourceId, Source& _source, std::shared_ptr<Tile> _tile, bool _reused) {
+
+    TileID id = _tile->getID();
+    size_t size = _tile->getMemoryUsage();
+
+    auto& list = _reused ? _source.reused : _source.once;
+    list.push_front({ id, std::move(_tile), size, m_stamp++, _reused });
+    m_entries[TileCacheKey(_sourceId, id)] = list.begin();
+
+    if (!_reused) { m_onceUsage += size; }
+
+    _source.stats.memoryUsage += size;
+    _source.stats.tiles++;
+    m_stats.memoryUsage += size;
+    m_stats.tiles++;
+}
+
+void TileCache::erase(int32_t _sourceId, Source& _source, EntryList::iterator _entry) {
+
+    size_t size = _entry->size;
+
+    if (!_entry->reused) { m_onceUsage -= size; }
+
+    _source.stats.memoryUsage -= size;
+    _source.stats.tiles--;
+    m_stats.memoryUsage -= size;
+    m_stats.tiles--;
+
+    m_entries.erase(TileCacheKey(_sourceId, _entry->id));
+
+    auto& list = _entry->reused ? _source.reused : _source.once;
+    list.erase(_entry);
+}
+
+void TileCache::evict(int32_t _sourceId, Source& _source, bool _once,
+                      std::vector<TileCacheKey>& _evicted) {
+
+    auto& list = _once ? _source.once : _source.reused;
+
+    TileCacheKey key(_sourceId, list.back().id);
+    erase(_sourceId, _source, std::prev(list.end()));
+
+    // A tile cached once that is put again soon was not just passed by
+    if (_once) { addGhost(key); }
+
+    _evicted.push_back(key);
+    _source.stats.evictions++;
+    m_stats.evictions++;
+}
+
+void TileCache::evictOverQuota(int32_t _sourceId, Source& _source, std::vector<TileCacheKey>& _evicted) {
+
+    if (_source.quota == 0) { return; }
+
+    while (_source.stats.memoryUsage > _source.quota && _source.stats.tiles > 0) {
+        evict(_sourceId, _source, !_source.once.empty(), _evicted);
+    }
+}
+
+void TileCache::evictOverSize(std::vector<TileCacheKey>& _evicted) {
+
+    int32_t victimId = 0;
+    Source* victim = nullptr;
+
+    // Find the source with the oldest tile in one of the queues
+    auto findOldest = [&](bool _once) {
+        uint64_t oldest = 0;
+        victim = nullptr;
+
+        for (auto& it : m_sources) {
+            auto& list = _once ? it.second.once : it.second.reused;
+            if (list.empty()) { continue; }
+
+            if (!victim || list.back().stamp < oldest) {
+                victimId = it.first;
+                victim = &it.second;
+                oldest = list.back().stamp;
+            }
+        }
+        return victim != nullptr;
+    };
+
+    while (m_stats.memoryUsage > m_cacheSize) {
+
+        // Evict tiles cached once while they use more than their share,
+        // otherwise the least recently used of the reused tiles
+        bool once = m_onceUsage > m_cacheSize * ONCE_QUEUE_SHARE;
+
+        if (!findOldest(once)) {
+            once = !once;
+
+            if (!findOldest(once)) {
+                LOGE("Invalid cache state!");
+                m_stats.memoryUsage = 0;
+                m_onceUsage = 0;
+                break;
+            }
+        }
+
+        evict(victimId, *victim, once, _evicted);
+    }
+}
+
+void TileCache::addGhost(const TileCacheKey& _key) {
+
+    if (m_ghostEntries.count(_key) > 0) { return; }
+
+    m_ghosts.push_front(_key);
+    m_ghostEntries[_key] = m_ghosts.begin();
+
+    size_t maxGhosts = std::max(m_entries.size(), MIN_GHOSTS);
+
+    while (m_ghosts.size() > maxGhosts) {
+        m_ghostEntries.erase(m_ghosts.back());
+        m_ghosts.pop_back();
+    }
+}
+
+bool TileCache::removeGhost(const TileCacheKey& _key) {
+
+    auto it = m_ghostEntries.find(_key);
+    if (it == m_ghostEntries.end()) { return false; }
+
+    m_ghosts.erase(it->second);
+    m_ghostEntries.erase(it);
+
+    return true;
+}
+
+}
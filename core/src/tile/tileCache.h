@@ -5,9 +5,11 @@
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
 
+#include <functional>
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 // TileSet serial + TileID
@@ -28,95 +30,126 @@ namespace std {
 
 namespace Tangram {
 
+/* Cache of Tiles that are not visible anymore
+ *
+ * Tiles are replaced with the 2Q policy: A tile put into the cache for the
+ * first time goes to a FIFO queue that holds at most a quarter of the cache
+ * size. Only tiles that are put again after they were taken from the cache or
+ * after they were recently evicted from the FIFO go to the main LRU queue.
+ * Tiles passed by once, e.g. while panning fast over the map, can thereby not
+ * evict the tiles that are reused.
+ *
+ * In addition each source may have a memory quota. Tiles of a source that
+ * exceeds its quota are evicted before tiles of other sources are touched.
+ * Memory usage is accounted on put() and get() with the tile size at put().
+ */
 class TileCache {
-    struct CacheEntry {
-        TileCacheKey key;
-        std::shared_ptr<Tile> tile;
+
+public:
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t memoryUsage = 0;
+        size_t tiles = 0;
     };
 
-    using CacheList = std::list<CacheEntry>;
-    using CacheMap = std::unordered_map<TileCacheKey, typename CacheList::iterator>;
+    TileCache(size_t _cacheSizeBytes);
 
-public:
+    /* Adds @_tile of source @_sourceId. Returns the keys of the tiles that
+     * were evicted to stay within the cache size and the source quota. */
+    std::vector<TileCacheKey> put(int32_t _sourceId, std::shared_ptr<Tile> _tile);
 
-    TileCache(size_t _cacheSizeMB) :
-        m_cacheUsage(0),
-        m_cacheMaxUsage(_cacheSizeMB) {}
+    /* Removes and returns the tile, nullptr when it is not cached */
+    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId);
 
-    std::vector<TileID> put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
-        TileCacheKey k(_sourceId, _tile->getID());
+    /* Returns the tile without removing it and without counting a hit or miss */
+    std::shared_ptr<Tile> contains(int32_t _sourceId, TileID _tileID) const;
 
-        m_cacheList.push_front({k, _tile});
-        m_cacheMap[k] = m_cacheList.begin();
-        m_cacheUsage += _tile->getMemoryUsage();
+    /* Sets the cache size, returns the keys of evicted tiles */
+    std::vector<TileCacheKey> limitCacheSize(size_t _cacheSizeBytes);
 
-        return limitCacheSize(m_cacheMaxUsage);
-    }
+    /* Limits the memory used by tiles of source @_sourceId, 0 for no quota.
+     * Returns the keys of evicted tiles. */
+    std::vector<TileCacheKey> setSourceQuota(int32_t _sourceId, size_t _quotaBytes);
 
-    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId) {
-        std::shared_ptr<Tile> tile;
-        TileCacheKey k(_sourceId, _tileId);
-
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            std::swap(tile, (*(it->second)).tile);
-            m_cacheList.erase(it->second);
-            m_cacheMap.erase(it);
-            m_cacheUsage -= tile->getMemoryUsage();
-        }
-        return tile;
-    }
+    size_t getMemoryUsage() const { return m_stats.memoryUsage; }
 
-    std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID) {
-        std::shared_ptr<Tile> tile;
-        TileCacheKey k(_source, _tileID);
+    size_t getCacheSize() const { return m_cacheSize; }
 
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            return it->second->tile;
-        }
-        return nullptr;
-    }
-
-    std::vector<TileID> limitCacheSize(size_t _cacheSizeBytes) {
-        std::vector<TileID> poppedTileIDs;
-        m_cacheMaxUsage = _cacheSizeBytes;
-
-        while (m_cacheUsage > m_cacheMaxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Invalid cache state!");
-                m_cacheUsage = 0;
-                break;
-            }
-            auto& tile = m_cacheList.back().tile;
-            poppedTileIDs.push_back(tile->getID());
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
-        }
-        return poppedTileIDs;
-    }
+    /* Counters for all sources */
+    const Stats& stats() const { return m_stats; }
 
-    size_t getMemoryUsage() const {
-        size_t sum = 0;
-        for (auto& entry : m_cacheList) {
-            sum += entry.tile->getMemoryUsage();
-        }
-        return sum;
-    }
+    /* Counters by source id */
+    std::vector<std::pair<int32_t, Stats>> sourceStats() const;
+
+    /* Removes all tiles. Counters and quotas are kept. */
+    void clear();
 
-    void clear() {
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_cacheUsage = 0;
-    }
+    /* Removes the tiles, counters and quota of source @_sourceId,
+     * e.g. when the source is removed from the map */
+    void removeSource(int32_t _sourceId);
+
+    /* Removes the tiles of source @_sourceId for which @_remove returns true,
+     * e.g. tiles of data that changed since. Returns their keys. */
+    std::vector<TileCacheKey> removeTiles(int32_t _sourceId,
+                                          const std::function<bool(const Tile&)>& _remove);
 
 private:
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
 
-    int m_cacheUsage;
-    int m_cacheMaxUsage;
+    struct Entry {
+        TileID id;
+        std::shared_ptr<Tile> tile;
+        size_t size;
+        // Put order over all sources
+        uint64_t stamp;
+        bool reused;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    struct Source {
+        // Tiles cached once, FIFO
+        EntryList once;
+        // Tiles that were reused, LRU
+        EntryList reused;
+
+        size_t quota = 0;
+        Stats stats;
+    };
+
+    void insert(int32_t _sourceId, Source& _source, std::shared_ptr<Tile> _tile, bool _reused);
+
+    void erase(int32_t _sourceId, Source& _source, EntryList::iterator _entry);
+
+    /* Evicts the oldest tile of the once or reused queue of @_source */
+    void evict(int32_t _sourceId, Source& _source, bool _once, std::vector<TileCacheKey>& _evicted);
+
+    void evictOverQuota(int32_t _sourceId, Source& _source, std::vector<TileCacheKey>& _evicted);
+
+    void evictOverSize(std::vector<TileCacheKey>& _evicted);
+
+    /* Remembers @_key as recently used, so that the tile goes
+     * to the LRU queue when it is put again */
+    void addGhost(const TileCacheKey& _key);
+
+    bool removeGhost(const TileCacheKey& _key);
+
+    std::unordered_map<int32_t, Source> m_sources;
+    std::unordered_map<TileCacheKey, EntryList::iterator> m_entries;
+
+    // Keys of tiles evicted from the FIFO queue or taken from the cache
+    std::list<TileCacheKey> m_ghosts;
+    std::unordered_map<TileCacheKey, std::list<TileCacheKey>::iterator> m_ghostEntries;
+
+    size_t m_cacheSize;
+    // Memory used by tiles that were cached once
+    size_t m_onceUsage = 0;
+
+    uint64_t m_stamp = 0;
+
+    Stats m_stats;
 };
 
 }
@@ -0,0 +1,330 @@
+#include "tile/tileDiskCache.h"
+
+#include "log.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace Tangram {
+
+static const char* FILE_SUFFIX = ".tile";
+
+// Directory functions, only available on POSIX platforms: Elsewhere no
+// directory is created and the cache is not valid
+#if !defined(_WIN32)
+
+// Create the directory @_path and its parents. Returns whether it exists.
+static bool createDirectories(const std::string& _path) {
+    for (size_t pos = 0; pos != std::string::npos; ) {
+        pos = _path.find('/', pos + 1);
+        mkdir(_path.substr(0, pos).c_str(), 0755);
+    }
+    struct stat info;
+    return stat(_path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+// Call @_cb with the name, size and modification time of each file in @_path
+static bool listFiles(const std::string& _path,
+                      const std::function<void(const std::string&, size_t, time_t)>& _cb) {
+    DIR* dir = opendir(_path.c_str());
+    if (!dir) { return false; }
+
+    while (dirent* item = readdir(dir)) {
+        std::string name = item->d_name;
+        if (name[0] == '.') { continue; }
+
+        struct stat info;
+        if (stat((_path + "/" + name).c_str(), &info) != 0) { continue; }
+
+        _cb(name, size_t(info.st_size), info.st_mtime);
+    }
+    closedir(dir);
+    return true;
+}
+
+static void touchFile(const std::string& _path) {
+    utimensat(AT_FDCWD, _path.c_str(), nullptr, 0);
+}
+
+#else
+
+static bool createDirectories(const std::string& _path) { return false; }
+
+static bool listFiles(const std::string& _path,
+                      const std::function<void(const std::string&, size_t, time_t)>& _cb) {
+    return false;
+}
+
+static void touchFile(const std::string& _path) {}
+
+#endif
+
+TileDiskCache::TileDiskCache(std::string _path, size_t _maxBytes)
+    : m_path(std::move(_path)),
+      m_maxBytes(_maxBytes) {
+
+    if (!createDirectories(m_path)) {
+        LOGE("Cannot open tile cache directory: %s", m_path.c_str());
+        return;
+    }
+    m_valid = true;
+
+    m_worker = std::make_unique<AsyncWorker>();
+
+    // Read the entries of the directory in the background: Until then
+    // load() waits for it
+    m_worker->enqueue([this]() { index(); });
+}
+
+void TileDiskCache::index() {
+    std::call_once(m_indexed, [this]() {
+
+        struct File {
+            uint64_t key;
+            size_t size;
+            time_t time;
+        };
+        std::vector<File> files;
+        std::vector<std::string> stale;
+
+        listFiles(m_path, [&](const std::string& _name, size_t _size, time_t _time) {
+            size_t suffix = _name.find(FILE_SUFFIX);
+
+            if (suffix != 16 || _name.size() != 16 + strlen(FILE_SUFFIX)) {
+                // Left over from an interrupted write
+                stale.push_back(m_path + "/" + _name);
+                return;
+            }
+            files.push_back({ std::strtoull(_name.c_str(), nullptr, 16), _size, _time });
+        });
+
+        for (auto& path : stale) { std::remove(path.c_str()); }
+
+        // Files are touched when used, so the oldest is the least recently used
+        std::sort(files.begin(), files.end(), [](auto& a, auto& b) { return a.time < b.time; });
+
+        std::vector<uint64_t> evicted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& file : files) {
+                auto keys = insert(file.key, file.size);
+                evicted.insert(evicted.end(), keys.begin(), keys.end());
+            }
+        }
+        for (auto key : evicted) {
+            std::remove(filePath(key).c_str());
+        }
+    });
+}
+
+TileDiskCache::~TileDiskCache() {
+    if (m_worker) { flush(); }
+}
+
+std::string TileDiskCache::filePath(uint64_t _key) const {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)_key);
+    return m_path + "/" + name + FILE_SUFFIX;
+}
+
+std::vector<uint64_t> TileDiskCache::insert(uint64_t _key, size_t _size) {
+
+    auto it = m_entries.find(_key);
+    if (it != m_entries.end()) {
+        m_stats.usage -= it->second.size;
+        m_lru.erase(it->second.position);
+        m_entries.erase(it);
+    }
+
+    m_lru.push_front(_key);
+    m_entries[_key] = { m_lru.begin(), _size };
+    m_stats.usage += _size;
+
+    std::vector<uint64_t> evicted;
+
+    while (m_stats.usage > m_maxBytes && m_lru.size() > 1) {
+        uint64_t key = m_lru.back();
+        m_lru.pop_back();
+
+        auto entry = m_entries.find(key);
+        m_stats.usage -= entry->second.size;
+        m_entries.erase(entry);
+
+        evicted.push_back(key);
+    }
+
+    m_stats.entries = m_entries.size();
+
+    return evicted;
+}
+
+void TileDiskCache::removeFiles(std::vector<uint64_t> _keys) {
+    if (_keys.empty()) { return; }
+
+    m_worker->enqueue([this, keys = std::move(_keys)]() {
+        for (auto key : keys) {
+            std::remove(filePath(key).c_str());
+        }
+    });
+}
+
+std::shared_ptr<TileBundle> TileDiskCache::load(uint64_t _key) {
+    if (!m_valid) { return nullptr; }
+
+    index();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(_key);
+        if (it == m_entries.end()) {
+            m_stats.misses++;
+            return nullptr;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it->second.position);
+    }
+
+    std::string path = filePath(_key);
+
+    auto bundle = TileBundle::map(path);
+
+    if (!bundle || !bundle->isValid(_key)) {
+        remove(_key);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    // Keep the order of use for the next start
+    touchFile(path);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.hits++;
+    if (bundle->hasLabels()) { m_stats.labelHits++; }
+    return bundle;
+}
+
+void TileDiskCache::store(uint64_t _key, std::vector<char> _data) {
+    if (!m_valid || _data.empty()) { return; }
+
+    m_worker->enqueue([this, _key, data = std::move(_data)]() {
+
+        index();
+
+        std::string path = filePath(_key);
+        std::string tmpPath = path + ".tmp";
+
+        // Write to a temporary file so that readers never see partial entries
+        FILE* file = fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            LOGW("Cannot write tile cache entry: %s", tmpPath.c_str());
+            return;
+        }
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        written &= fclose(file) == 0;
+
+        if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            LOGW("Cannot write tile cache entry: %s", path.c_str());
+            std::remove(tmpPath.c_str());
+            return;
+        }
+
+        std::vector<uint64_t> evicted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            evicted = insert(_key, data.size());
+            m_stats.stores++;
+        }
+        for (auto key : evicted) {
+            std::remove(filePath(key).c_str());
+        }
+    });
+}
+
+void TileDiskCache::remove(uint64_t _key) {
+    if (!m_valid) { return; }
+
+    index();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(_key);
+        if (it == m_entries.end()) { return; }
+
+        m_stats.usage -= it->second.size;
+        m_lru.erase(it->second.position);
+        m_entries.erase(it);
+        m_stats.entries = m_entries.size();
+    }
+    removeFiles({ _key });
+}
+
+void TileDiskCache::clear() {
+    if (!m_valid) { return; }
+
+    // Entries are only known once the directory is read
+    m_worker->enqueue([this]() {
+        index();
+
+        std::vector<uint64_t> keys;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            keys.assign(m_lru.begin(), m_lru.end());
+            m_lru.clear();
+            m_entries.clear();
+            m_stats.usage = 0;
+            m_stats.entries = 0;
+        }
+        for (auto key : keys) {
+            std::remove(filePath(key).c_str());
+        }
+    });
+}
+
+void TileDiskCache::flush() {
+    if (!m_valid) { return; }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool done = false;
+
+    m_worker->enqueue([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        condition.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&]{ return done; });
+}
+
+TileDiskCache::Stats TileDiskCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+uint64_t TileDiskCache::hash(const void* _data, size_t _size, uint64_t _seed) {
+    auto* data = static_cast<const uint8_t*>(_data);
+
+    uint64_t hash = _seed;
+    for (size_t i = 0; i < _size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "tile/tileBundle.h"
+#include "util/asyncWorker.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Persistent cache of built tile geometry
+ *
+ * Entries are TileBundles, one file per entry in the cache directory, that
+ * are mapped when loaded. Entries are keyed by a hash of the data source,
+ * TileID, raw tile data and scene config, so that a tile that is loaded
+ * again with the same data and scene can skip parsing and styling. Prebuilt
+ * entries can be shipped by copying a cache directory.
+ *
+ * The cache directory is read and files are written on a background
+ * thread. The least recently used entries are removed when the cache
+ * exceeds its size.
+ */
+class TileDiskCache {
+
+public:
+
+    struct Stats {
+        uint64_t hits = 0;
+        // Hits of entries with labels: The labels are built again from the
+        // parsed tile data, so only the other hits skip parsing
+        uint64_t labelHits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        // Bytes used by all entries
+        size_t usage = 0;
+        size_t entries = 0;
+    };
+
+    TileDiskCache(std::string _path, size_t _maxBytes);
+
+    ~TileDiskCache();
+
+    // Whether the cache directory could be created. Not supported on
+    // platforms without POSIX directory functions.
+    bool isValid() const { return m_valid; }
+
+    // Map the entry @_key. Returns nullptr when there is no valid entry.
+    // Waits until the cache directory is read.
+    std::shared_ptr<TileBundle> load(uint64_t _key);
+
+    // Write the entry @_key, as encoded by TileBundle::encode(), on the
+    // background thread
+    void store(uint64_t _key, std::vector<char> _data);
+
+    // Remove an entry that turned out to be invalid
+    void remove(uint64_t _key);
+
+    // Remove all entries, on the background thread
+    void clear();
+
+    // Wait until all entries passed to store() are written
+    void flush();
+
+    Stats stats() const;
+
+    // FNV-1a hash of @_size bytes at @_data, continued from @_seed
+    static uint64_t hash(const void* _data, size_t _size, uint64_t _seed = 0xcbf29ce484222325);
+
+private:
+
+    struct Entry {
+        std::list<uint64_t>::iterator position;
+        size_t size;
+    };
+
+    std::string filePath(uint64_t _key) const;
+
+    // Add the entries of the cache directory to the index, once
+    void index();
+
+    // Add an entry to the index, with the lock held. Returns the keys of
+    // evicted entries.
+    std::vector<uint64_t> insert(uint64_t _key, size_t _size);
+
+    void removeFiles(std::vector<uint64_t> _keys);
+
+    const std::string m_path;
+    const size_t m_maxBytes;
+    bool m_valid = false;
+
+    // Keys in order of use, most recent first
+    std::list<uint64_t> m_lru;
+    std::unordered_map<uint64_t, Entry> m_entries;
+
+    Stats m_stats;
+
+    mutable std::mutex m_mutex;
+
+    std::once_flag m_indexed;
+
+    std::unique_ptr<AsyncWorker> m_worker;
+};
+
+}
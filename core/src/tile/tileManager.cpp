@@ -16,6 +16,17 @@
 
 namespace Tangram {
 
+// Number of prefetched tiles loading per source for a prefetch path,
+// when no larger budget is set through setPrefetch()
+const static size_t PREFETCH_PATH_BUDGET = 8;
+
+// Seconds ahead of the camera in which tiles of a path are requested,
+// so that loaded tiles are not evicted from the cache before use
+const static float PREFETCH_PATH_LOOKAHEAD = 2.f;
+
+// Maximum number of views sampled between two keyframes
+const static int MAX_PATH_STEPS = 64;
+
 TileManager::TileManager(std::shared_ptr<Platform> platform, TileTaskQueue& _tileWorker) :
     m_workers(_tileWorker) {
 
@@ -51,10 +62,13 @@ void TileManager::setTileSources(const std::vector<std::shared_ptr<TileSource>>&
         [&](auto& tileSet) {
             if (!tileSet.clientTileSource) {
                 LOGN("Remove source %s", tileSet.source->name().c_str());
+                m_tileCache->removeSource(tileSet.source->id());
                 return true;
             }
             // Clear cache
             tileSet.tiles.clear();
+            tileSet.prefetchTasks.clear();
+            tileSet.prefetched.clear();
             return false;
         });
 
@@ -71,6 +85,7 @@ void TileManager::setTileSources(const std::vector<std::shared_ptr<TileSource>>&
                          }) == m_tileSets.end()) {
             LOGN("add source %s", source->name().c_str());
             m_tileSets.push_back({ source, false });
+            applyCacheQuota(m_tileSets.back());
         } else {
             LOGW("Duplicate named datasource (not added): %s", source->name().c_str());
         }
@@ -88,6 +103,7 @@ std::shared_ptr<TileSource> TileManager::getClientTileSource(int32_t sourceID) {
 
 void TileManager::addClientTileSource(std::shared_ptr<TileSource> _tileSource) {
     m_tileSets.push_back({ _tileSource, true });
+    applyCacheQuota(m_tileSets.back());
 }
 
 bool TileManager::removeClientTileSource(TileSource& _tileSource) {
@@ -96,6 +112,8 @@ bool TileManager::removeClientTileSource(TileSource& _tileSource) {
         if (it->source.get() == &_tileSource) {
             // Remove the textures for this tile source
             it->source->clearRasters();
+            // Remove the cached tiles and counters of this tile source
+            m_tileCache->removeSource(it->source->id());
             // Remove the tile set associated with this tile source
             it = m_tileSets.erase(it);
             removed = true;
@@ -109,6 +127,8 @@ bool TileManager::removeClientTileSource(TileSource& _tileSource) {
 void TileManager::clearTileSets() {
     for (auto& tileSet : m_tileSets) {
         tileSet.tiles.clear();
+        tileSet.prefetchTasks.clear();
+        tileSet.prefetched.clear();
     }
 
     m_tileCache->clear();
@@ -118,6 +138,8 @@ void TileManager::clearTileSet(int32_t _sourceId) {
     for (auto& tileSet : m_tileSets) {
         if (tileSet.source->id() != _sourceId) { continue; }
         tileSet.tiles.clear();
+        tileSet.prefetchTasks.clear();
+        tileSet.prefetched.clear();
     }
 
     m_tileCache->clear();
@@ -142,11 +164,21 @@ void TileManager::updateTileSets(const View& _view) {
                 auto maxZoom = tileSet.source->maxZoom();
 
                 // Insert scaled and maxZoom mapped tileID in the visible set
-                tileSet.visibleTiles.insert(_tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom));
+                tileSet.visibleTiles.keys.push_back(_tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom));
             }
         };
 
         _view.getVisibleTiles(tileCb);
+
+        for (auto& tileSet : m_tileSets) {
+            tileSet.visibleTiles.sort();
+        }
+
+        updateCameraMotion(_view);
+
+        if (m_prefetchTime > 0) {
+            predictTiles(_view);
+        }
     }
 
     for (auto& tileSet : m_tileSets) {
@@ -158,6 +190,19 @@ void TileManager::updateTileSets(const View& _view) {
 
     loadTiles();
 
+    if (m_hasPrefetchPath) {
+        updatePrefetchPath();
+    }
+
+    // Request prefetched tiles after the visible tiles
+    for (auto& tileSet : m_tileSets) {
+        if (m_prefetchTime > 0 ||
+            !tileSet.prefetchTasks.empty() ||
+            !tileSet.pathTiles.empty()) {
+            updatePrefetch(tileSet, _view.state());
+        }
+    }
+
     // Make m_tiles an unique list of tiles for rendering sorted from
     // high to low zoom-levels.
     std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b) {
@@ -186,6 +231,9 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
     std::vector<TileID> removeTiles;
     auto& tiles = _tileSet.tiles;
 
+    m_addTiles.clear();
+    m_proxyUpdates.clear();
+
     // Check for ready tasks, move Tile to active TileSet and unset Proxies.
     for (auto& it : tiles) {
         auto& entry = it.second;
@@ -207,8 +255,6 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
     auto curTilesIt = tiles.begin();
     auto visTilesIt = visibleTiles.begin();
 
-    auto generation = _tileSet.source->generation();
-
     while (visTilesIt != visibleTiles.end() || curTilesIt != tiles.end()) {
 
         auto& visTileId = visTilesIt == visibleTiles.end()
@@ -228,13 +274,18 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             auto sourceGeneration = (entry.isReady()) ?
                 entry.tile->sourceGeneration() : entry.task->sourceGeneration();
 
+            // Generation of the last change of the tile's data
+            auto generation = _tileSet.source->generation(visTileId);
+
             if (entry.isReady()) {
                 m_tiles.push_back(entry.tile);
 
                 if (!entry.isInProgress() &&
-                    (sourceGeneration < generation)) {
-                    // Tile needs update - enqueue for loading
+                    (sourceGeneration < generation || entry.tile->isProvisional())) {
+                    // Tile needs update or its own data to replace the
+                    // data sliced from a parent - enqueue for loading
                     entry.task = _tileSet.source->createTask(visTileId);
+                    entry.task->setSliceable(false);
                     enqueueTask(_tileSet, visTileId, _view);
                 }
             } else if (entry.needsLoading()) {
@@ -254,7 +305,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
 
             if (newTiles && entry.isInProgress()) {
                 // check again for proxies
-                updateProxyTiles(_tileSet, visTileId, entry);
+                m_proxyUpdates.push_back(visTileId);
             }
 
             ++curTilesIt;
@@ -267,11 +318,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             //     NOT_A_TILE. (for the current implementation of > operator)
             assert(visTilesIt != visibleTiles.end());
 
-            if (!addTile(_tileSet, visTileId)) {
-                // Not in cache - enqueue for loading
-                enqueueTask(_tileSet, visTileId, _view);
-                m_tilesInProgress++;
-            }
+            m_addTiles.push_back(visTileId);
 
             ++visTilesIt;
 
@@ -296,6 +343,23 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
         }
     }
 
+    // Adding tiles after the merge loop: Inserting into the
+    // flat TileSet would invalidate its iterators
+    for (auto& tileId : m_addTiles) {
+        if (!addTile(_tileSet, tileId)) {
+            // Not in cache - enqueue for loading, unless the
+            // task was taken over from the prefetched tiles
+            if (tiles.find(tileId)->second.task->needsLoading()) {
+                enqueueTask(_tileSet, tileId, _view);
+            }
+            m_tilesInProgress++;
+        }
+    }
+
+    for (auto& tileId : m_proxyUpdates) {
+        updateProxyTiles(_tileSet, tileId);
+    }
+
     while (!removeTiles.empty()) {
         auto it = tiles.find(removeTiles.back());
         removeTiles.pop_back();
@@ -345,6 +409,9 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; } // prefer parent tiles
             task->setPriority(glm::length2(tileCenter - _view.center) * scaleDiv);
             task->setProxyState(entry.getProxyCounter() > 0);
+
+            // Reorder the task in the worker queue
+            m_workers.reprioritize(*task);
         }
 
         if (entry.isReady()) {
@@ -352,6 +419,42 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             entry.tile->setProxyState(entry.getProxyCounter() > 0);
         }
     }
+
+    if (_tileSet.prunedGeneration != _tileSet.sourceGeneration) {
+        pruneGenerations(_tileSet);
+    }
+}
+
+void TileManager::pruneGenerations(TileSet& _tileSet) {
+
+    auto& source = *_tileSet.source;
+    int64_t oldest = _tileSet.sourceGeneration;
+
+    // Outdated tiles would be reloaded when taken from the cache anyway
+    clearEvictedTiles(m_tileCache->removeTiles(source.id(), [&](const Tile& _tile) {
+        if (_tile.sourceGeneration() < source.generation(_tile.getID())) {
+            return true;
+        }
+        oldest = std::min(oldest, _tile.sourceGeneration());
+        return false;
+    }));
+
+    for (auto* tiles : { &_tileSet.tiles, &_tileSet.prefetchTasks }) {
+        for (auto& it : *tiles) {
+            auto& entry = it.second;
+            if (entry.tile) {
+                oldest = std::min(oldest, entry.tile->sourceGeneration());
+            }
+            if (entry.task) {
+                oldest = std::min(oldest, entry.task->sourceGeneration());
+            }
+        }
+    }
+
+    source.pruneChanges(oldest);
+
+    // Check again on the next update until all tiles are up to date
+    _tileSet.prunedGeneration = oldest;
 }
 
 void TileManager::enqueueTask(TileSet& _tileSet, const TileID& _tileID,
@@ -394,10 +497,14 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
 
     auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
 
+    bool prefetched = _tileSet.prefetched.erase(_tileID) > 0;
+
     if (tile) {
-        if (tile->sourceGeneration() == _tileSet.source->generation()) {
+        if (tile->sourceGeneration() >= _tileSet.source->generation(_tileID)) {
             m_tiles.push_back(tile);
 
+            if (prefetched) { m_prefetchStats.hits++; }
+
             // Update tile origin based on wrap (set in the new tileID)
             tile->updateTileOrigin(_tileID.wrap);
 
@@ -411,20 +518,33 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     }
 
     // Add TileEntry to TileSet
-    auto entry = _tileSet.tiles.emplace(_tileID, tile);
+    auto& entry = _tileSet.tiles.emplace(_tileID, tile).first->second;
+    entry.setVisible(true);
 
     if (!tile) {
-        // Add Proxy if corresponding proxy MapTile ready
-        updateProxyTiles(_tileSet, _tileID, entry.first->second);
+        // Continue with the prefetch task when the tile is still loading
+        auto prefetch = _tileSet.prefetchTasks.find(_tileID);
+        if (prefetch != _tileSet.prefetchTasks.end() &&
+            prefetch->second.isInProgress()) {
 
-        entry.first->second.task = _tileSet.source->createTask(_tileID);
+            entry.task = std::move(prefetch->second.task);
+            m_prefetchStats.hits++;
+        } else {
+            entry.task = _tileSet.source->createTask(_tileID);
+        }
+        if (prefetch != _tileSet.prefetchTasks.end()) {
+            _tileSet.prefetchTasks.erase(prefetch);
+        }
+
+        // Add Proxy if corresponding proxy MapTile ready
+        // NB: Invalidates 'entry'
+        updateProxyTiles(_tileSet, _tileID);
     }
-    entry.first->second.setVisible(true);
 
     return bool(tile);
 }
 
-void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIt) {
+void TileManager::removeTile(TileSet& _tileSet, fastmap<TileID, TileEntry>::iterator& _tileIt) {
 
     auto& id = _tileIt->first;
     auto& entry = _tileIt->second;
@@ -439,10 +559,7 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
 
     } else if (entry.isReady()) {
         // Add to cache
-        auto poppedTiles = m_tileCache->put(_tileSet.source->id(), entry.tile);
-        for (auto& tileID : poppedTiles) {
-            _tileSet.source->clearRaster(tileID);
-        }
+        clearEvictedTiles(m_tileCache->put(_tileSet.source->id(), entry.tile));
     }
 
     // Remove rasters from this TileSource
@@ -452,7 +569,7 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
     _tileIt = _tileSet.tiles.erase(_tileIt);
 }
 
-bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
+bool TileManager::updateProxyTile(TileSet& _tileSet, const TileID& _tileID,
                                   const TileID& _proxyTileId,
                                   const ProxyID _proxyId) {
 
@@ -460,13 +577,16 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     auto& tiles = _tileSet.tiles;
 
+    // Valid until a proxy is inserted below
+    auto& tile = tiles.find(_tileID)->second;
+
     // check if the proxy exists in the visible tile set
     {
         const auto& it = tiles.find(_proxyTileId);
         if (it != tiles.end()) {
             auto& entry = it->second;
 
-            if (!entry.isCanceled() && _tile.setProxy(_proxyId)) {
+            if (!entry.isCanceled() && tile.setProxy(_proxyId)) {
                 entry.incProxyCounter();
 
                 if (entry.isReady()) {
@@ -482,8 +602,11 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     // check if the proxy exists in the cache
     {
-        auto proxyTile = m_tileCache->get(_tileSet.source->id(), _proxyTileId);
-        if (proxyTile && _tile.setProxy(_proxyId)) {
+        // Probe first, so that a missing proxy does not count as cache miss
+        auto proxyTile = m_tileCache->contains(_tileSet.source->id(), _proxyTileId);
+        if (proxyTile && tile.setProxy(_proxyId)) {
+
+            m_tileCache->get(_tileSet.source->id(), _proxyTileId);
 
             auto result = tiles.emplace(_proxyTileId, proxyTile);
             auto& entry = result.first->second;
@@ -497,7 +620,7 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
     return false;
 }
 
-void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile) {
+void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID) {
     // TODO: this should be improved to use the nearest proxy tile available.
     // Currently it would use parent or grand*parent  as proxies even if the
     // child proxies would be more appropriate
@@ -508,20 +631,20 @@ void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, Til
     auto parentID = _tileID.getParent(zoomBias);
     auto minZoom = _tileSet.source->minDisplayZoom();
     if (minZoom <= parentID.z
-            && updateProxyTile(_tileSet, _tile, parentID, ProxyID::parent)) {
+            && updateProxyTile(_tileSet, _tileID, parentID, ProxyID::parent)) {
         return;
     }
     // Try grandparent
     auto grandparentID = parentID.getParent(zoomBias);
     if (minZoom <= grandparentID.z
-            && updateProxyTile(_tileSet, _tile, grandparentID, ProxyID::parent2)) {
+            && updateProxyTile(_tileSet, _tileID, grandparentID, ProxyID::parent2)) {
         return;
     }
     // Try children
     if (maxZoom > _tileID.z) {
         for (int i = 0; i < 4; i++) {
             auto childID = _tileID.getChild(i, maxZoom);
-            updateProxyTile(_tileSet, _tile, childID, static_cast<ProxyID>(1 << i));
+            updateProxyTile(_tileSet, _tileID, childID, static_cast<ProxyID>(1 << i));
         }
     }
 }
@@ -564,7 +687,323 @@ void TileManager::clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, Tile
 }
 
 void TileManager::setCacheSize(size_t _cacheSize) {
-    m_tileCache->limitCacheSize(_cacheSize);
+    clearEvictedTiles(m_tileCache->limitCacheSize(_cacheSize));
+}
+
+void TileManager::setCacheQuota(const std::string& _sourceName, size_t _quotaBytes) {
+    m_cacheQuotas[_sourceName] = _quotaBytes;
+
+    for (auto& tileSet : m_tileSets) {
+        if (tileSet.source->name() == _sourceName) {
+            applyCacheQuota(tileSet);
+        }
+    }
+}
+
+void TileManager::applyCacheQuota(TileSet& _tileSet) {
+    auto it = m_cacheQuotas.find(_tileSet.source->name());
+    if (it == m_cacheQuotas.end()) { return; }
+
+    clearEvictedTiles(m_tileCache->setSourceQuota(_tileSet.source->id(), it->second));
+}
+
+void TileManager::clearEvictedTiles(const std::vector<TileCacheKey>& _evicted) {
+    for (auto& key : _evicted) {
+        for (auto& tileSet : m_tileSets) {
+            if (tileSet.source->id() != key.first) { continue; }
+
+            // Rasters are still needed while the tile is in the TileSet
+            if (tileSet.tiles.count(key.second) == 0) {
+                tileSet.source->clearRaster(key.second);
+            }
+            tileSet.prefetched.erase(key.second);
+            break;
+        }
+    }
+}
+
+void TileManager::setPrefetch(float _seconds, size_t _budget) {
+    m_prefetchTime = std::max(_seconds, 0.f);
+    m_prefetchBudget = _budget;
+
+    if (m_prefetchTime == 0) {
+        // Pending tasks are canceled on next update
+        for (auto& tileSet : m_tileSets) {
+            tileSet.prefetchTiles.clear();
+        }
+    }
+}
+
+void TileManager::updateCameraMotion(const View& _view) {
+
+    auto now = std::chrono::steady_clock::now();
+    glm::dvec2 center(_view.getPosition().x, _view.getPosition().y);
+    float zoom = _view.getZoom();
+
+    auto& motion = m_cameraMotion;
+
+    if (motion.valid) {
+        float dt = std::chrono::duration<float>(now - motion.time).count();
+
+        if (dt > 0.5f) {
+            // The view was at rest in between
+            motion.velocity = glm::dvec2(0.0);
+            motion.zoomVelocity = 0;
+
+        } else if (dt > 0) {
+            // Smooth out jitter of frame times and touch input
+            const float alpha = 0.5f;
+            motion.velocity = glm::mix(motion.velocity, (center - motion.center) / double(dt),
+                                       double(alpha));
+            motion.zoomVelocity = glm::mix(motion.zoomVelocity, (zoom - motion.zoom) / dt, alpha);
+        }
+    }
+
+    motion.time = now;
+    motion.center = center;
+    motion.zoom = zoom;
+    motion.valid = true;
+}
+
+void TileManager::predictTiles(const View& _view) {
+
+    for (auto& tileSet : m_tileSets) {
+        tileSet.prefetchTiles.clear();
+    }
+
+    auto& motion = m_cameraMotion;
+    glm::dvec2 offset = motion.velocity * double(m_prefetchTime);
+    float zoomOffset = motion.zoomVelocity * m_prefetchTime;
+
+    // Not worth it when the view moves less than a fraction of a tile
+    double tileSize = 2 * MapProjection::HALF_CIRCUMFERENCE * exp2(-_view.getZoom());
+    if (glm::length(offset) < 0.1 * tileSize && std::abs(zoomOffset) < 0.1f) {
+        return;
+    }
+
+    View predicted(_view);
+    predicted.setPosition(motion.center.x + offset.x, motion.center.y + offset.y);
+    predicted.setZoom(motion.zoom + zoomOffset);
+    predicted.update(false);
+
+    float zoom = predicted.getZoom();
+
+    predicted.getVisibleTiles([&](TileID _tileID) {
+        for (auto& tileSet : m_tileSets) {
+            if (!tileSet.source->isActiveForZoom(zoom)) { continue; }
+
+            auto zoomBias = tileSet.source->zoomBias();
+            auto maxZoom = tileSet.source->maxZoom();
+            auto id = _tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom);
+
+            if (tileSet.visibleTiles.count(id) == 0) {
+                tileSet.prefetchTiles.keys.push_back(id);
+            }
+        }
+    });
+
+    for (auto& tileSet : m_tileSets) {
+        tileSet.prefetchTiles.sort();
+    }
+}
+
+void TileManager::updatePrefetch(TileSet& _tileSet, const ViewState& _view) {
+
+    auto& tasks = _tileSet.prefetchTasks;
+    auto sourceId = _tileSet.source->id();
+
+    for (auto it = tasks.begin(); it != tasks.end();) {
+        auto& id = it->first;
+        auto& entry = it->second;
+
+        if (entry.newData()) {
+            entry.task->complete();
+            auto tile = std::move(entry.task->tile());
+            entry.task.reset();
+            m_prefetchStats.loaded++;
+
+            if (tile->sourceGeneration() >= _tileSet.source->generation(id)) {
+                // Keep the tile in cache until it becomes visible
+                _tileSet.prefetched.insert(id);
+                clearEvictedTiles(m_tileCache->put(sourceId, tile));
+            }
+            _tileSet.source->clearRaster(id);
+            it = tasks.erase(it);
+
+        } else if (entry.isCanceled()) {
+            // No data for this tile
+            it = tasks.erase(it);
+
+        } else if (_tileSet.prefetchTiles.count(id) == 0 &&
+                   _tileSet.pathTiles.count(id) == 0) {
+            // Camera changed its course or passed the tile
+            entry.clearTask();
+            _tileSet.source->cancelLoadingTile(id);
+            _tileSet.source->clearRaster(id);
+            m_prefetchStats.canceled++;
+            it = tasks.erase(it);
+
+        } else {
+            ++it;
+        }
+    }
+
+    size_t budget = m_prefetchBudget;
+    if (!_tileSet.pathTiles.empty()) {
+        budget = std::max(budget, PREFETCH_PATH_BUDGET);
+    }
+
+    if (tasks.size() >= budget) { return; }
+
+    auto needsRequest = [&](const TileID& _id) {
+        return tasks.count(_id) == 0 &&
+            _tileSet.tiles.count(_id) == 0 &&
+            _tileSet.prefetched.count(_id) == 0 &&
+            !m_tileCache->contains(sourceId, _id);
+    };
+
+    std::vector<std::pair<double, TileID>> requests;
+
+    // Path tiles get negative priorities: They are requested before the tiles
+    // predicted from the camera motion, those with earlier deadlines first.
+    for (auto& it : _tileSet.pathTiles) {
+        if (it.second.begin > m_pathTime + PREFETCH_PATH_LOOKAHEAD) { continue; }
+        if (!needsRequest(it.first)) { continue; }
+
+        requests.emplace_back(-1.0 / (1.0 + it.second.begin), it.first);
+    }
+
+    for (auto& id : _tileSet.prefetchTiles) {
+        if (_tileSet.pathTiles.count(id) > 0 || !needsRequest(id)) { continue; }
+
+        auto tileCenter = _view.mapProjection->TileCenter(id);
+        requests.emplace_back(glm::length2(tileCenter - _view.center), id);
+    }
+
+    std::sort(requests.begin(), requests.end(),
+              [](auto& a, auto& b) { return a.first < b.first; });
+
+    for (auto& request : requests) {
+        if (tasks.size() >= budget) { break; }
+
+        auto& entry = tasks[request.second];
+        entry.task = _tileSet.source->createTask(request.second);
+
+        // Prefetched tiles are processed after all visible and proxy tiles
+        entry.task->setProxyState(true);
+        entry.task->setPriority(request.first);
+
+        _tileSet.source->loadTileData(entry.task, m_dataCallback);
+        m_prefetchStats.requested++;
+    }
+}
+
+void TileManager::setPrefetchPath(const View& _view, const std::vector<PathKeyframe>& _path) {
+
+    clearPrefetchPath();
+
+    if (_path.empty()) { return; }
+
+    View view(_view);
+
+    // Width of the view in projection units at zoom 0
+    double viewSize = std::max(_view.getWidth(), _view.getHeight()) /
+        _view.pixelsPerMeter() * exp2(_view.getZoom());
+
+    auto addTiles = [&](glm::dvec2 _position, float _zoom, float _time) {
+        view.setPosition(_position.x, _position.y);
+        view.setZoom(_zoom);
+        view.update(false);
+
+        float zoom = view.getZoom();
+
+        view.getVisibleTiles([&](TileID _tileID) {
+            for (auto& tileSet : m_tileSets) {
+                if (!tileSet.source->isActiveForZoom(zoom)) { continue; }
+
+                auto zoomBias = tileSet.source->zoomBias();
+                auto maxZoom = tileSet.source->maxZoom();
+                auto id = _tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom);
+
+                // Collected unordered, merged below
+                tileSet.pathTiles.map.emplace_back(id, PathDeadline{ _time, _time });
+            }
+        });
+    };
+
+    addTiles(_path[0].position, _path[0].zoom, _path[0].time);
+
+    for (size_t i = 1; i < _path.size(); i++) {
+        auto& a = _path[i-1];
+        auto& b = _path[i];
+
+        // Sample the segment so that consecutive views overlap by half
+        double size = viewSize * exp2(-std::max(a.zoom, b.zoom));
+        int steps = std::ceil(glm::length(b.position - a.position) / (0.5 * size)) +
+            std::ceil(std::abs(b.zoom - a.zoom) / 0.5f);
+        steps = glm::clamp(steps, 1, MAX_PATH_STEPS);
+
+        for (int step = 1; step <= steps; step++) {
+            float f = float(step) / steps;
+            addTiles(glm::mix(a.position, b.position, double(f)),
+                     glm::mix(a.zoom, b.zoom, f),
+                     glm::mix(a.time, b.time, f));
+        }
+    }
+
+    // Sort path tiles and merge the deadlines of tiles seen from multiple views
+    for (auto& tileSet : m_tileSets) {
+        auto& tiles = tileSet.pathTiles.map;
+        if (tiles.empty()) { continue; }
+
+        std::sort(tiles.begin(), tiles.end(),
+                  [](auto& a, auto& b) { return a.first < b.first; });
+
+        size_t last = 0;
+        for (size_t i = 1; i < tiles.size(); i++) {
+            if (tiles[i].first == tiles[last].first) {
+                tiles[last].second.begin = std::min(tiles[last].second.begin, tiles[i].second.begin);
+                tiles[last].second.end = std::max(tiles[last].second.end, tiles[i].second.end);
+            } else {
+                tiles[++last] = tiles[i];
+            }
+        }
+        tiles.erase(tiles.begin() + last + 1, tiles.end());
+    }
+
+    m_pathStart = std::chrono::steady_clock::now();
+    m_pathTime = 0;
+    m_hasPrefetchPath = true;
+}
+
+void TileManager::clearPrefetchPath() {
+    // Pending tasks are canceled on next update
+    for (auto& tileSet : m_tileSets) {
+        tileSet.pathTiles.clear();
+    }
+    m_hasPrefetchPath = false;
+}
+
+void TileManager::updatePrefetchPath() {
+
+    m_pathTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_pathStart).count();
+
+    bool done = true;
+
+    for (auto& tileSet : m_tileSets) {
+        auto& pathTiles = tileSet.pathTiles;
+
+        for (auto it = pathTiles.begin(); it != pathTiles.end();) {
+            if (it->second.end < m_pathTime) {
+                it = pathTiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        done &= pathTiles.empty();
+    }
+
+    if (done) { m_hasPrefetchPath = false; }
 }
 
 }
@@ -6,12 +6,14 @@
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 #include "tile/tileWorker.h"
+#include "util/fastmap.h"
 
-#include <map>
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <tuple>
-#include <set>
+#include <unordered_map>
 #include <vector>
 
 class Platform;
@@ -72,6 +74,54 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* Limit the memory that cached tiles of source @_sourceName may use,
+     * 0 for no quota. The quota is kept when the sources are replaced.
+     */
+    void setCacheQuota(const std::string& _sourceName, size_t _quotaBytes);
+
+    struct PrefetchStats {
+        // Tiles requested before they became visible
+        uint64_t requested = 0;
+        // Prefetched tiles that finished loading
+        uint64_t loaded = 0;
+        // Prefetched tiles that became visible
+        uint64_t hits = 0;
+        // Prefetch requests that were canceled
+        uint64_t canceled = 0;
+
+        float hitRate() const { return requested > 0 ? float(hits) / requested : 0.f; }
+    };
+
+    /* Load tiles ahead that are predicted to become visible within @_seconds,
+     * extrapolated from the current pan and zoom velocity of the view.
+     * @_budget: Maximum number of prefetched tiles loading per source.
+     * Prefetching is disabled when @_seconds is 0 (default).
+     */
+    void setPrefetch(float _seconds, size_t _budget);
+
+    const PrefetchStats& getPrefetchStats() const { return m_prefetchStats; }
+
+    struct PathKeyframe {
+        // Camera position in projection units
+        glm::dvec2 position;
+        float zoom;
+        // Seconds from now until the camera reaches this keyframe
+        float time;
+    };
+
+    /* Load the tiles visible along a camera path ahead of an animation.
+     * The path is sampled between keyframes so that consecutive views
+     * overlap. Tiles are requested in the order of their deadlines and
+     * dropped when the camera has passed them. @_view provides viewport
+     * and camera parameters. Replaces a previous path.
+     */
+    void setPrefetchPath(const View& _view, const std::vector<PathKeyframe>& _path);
+
+    /* Drop the prefetch path, e.g. when the animation was interrupted */
+    void clearPrefetchPath();
+
+    bool hasPrefetchPath() const { return m_hasPrefetchPath; }
+
 protected:
 
     enum class ProxyID : uint8_t {
@@ -89,6 +139,11 @@ protected:
         TileEntry(){}
         TileEntry(std::shared_ptr<Tile>& _tile) : tile(_tile) {}
 
+        // Entries are moved within the flat TileSet containers. Copies are
+        // not allowed: The destructor cancels the task.
+        TileEntry(TileEntry&& _other) = default;
+        TileEntry& operator=(TileEntry&& _other) = default;
+
         ~TileEntry() { clearTask(); }
 
         std::shared_ptr<Tile> tile;
@@ -191,16 +246,36 @@ protected:
         }
     };
 
+    struct PathDeadline {
+        // Seconds from the start of the path until the tile becomes
+        // visible and until it was passed
+        float begin;
+        float end;
+    };
+
     struct TileSet {
         TileSet(std::shared_ptr<TileSource> _source, bool _clientSource)
             : source(_source), clientTileSource(_clientSource) {}
 
         std::shared_ptr<TileSource> source;
 
-        std::set<TileID> visibleTiles;
-        std::map<TileID, TileEntry> tiles;
+        // Sorted flat containers: updateTileSet() walks visibleTiles
+        // and tiles in a merge loop on each frame
+        fastset<TileID> visibleTiles;
+        fastmap<TileID, TileEntry> tiles;
+
+        /* Tiles predicted to become visible */
+        fastset<TileID> prefetchTiles;
+        /* Loading prefetched tiles, moved to the TileCache when ready */
+        fastmap<TileID, TileEntry> prefetchTasks;
+        /* Prefetched tiles in the TileCache that were not visible yet */
+        fastset<TileID> prefetched;
+        /* Tiles along the prefetch path */
+        fastmap<TileID, PathDeadline> pathTiles;
 
         int64_t sourceGeneration = 0;
+        /* Generation up to which the source was told to prune its changes */
+        int64_t prunedGeneration = 0;
         bool clientTileSource;
     };
 
@@ -210,6 +285,19 @@ protected:
 
     void loadTiles();
 
+    /* Estimate pan and zoom velocity from the last view changes */
+    void updateCameraMotion(const View& _view);
+
+    /* Determine the prefetchTiles of each TileSet from the camera motion */
+    void predictTiles(const View& _view);
+
+    /* Drop path tiles that the camera has passed */
+    void updatePrefetchPath();
+
+    /* Load predicted tiles within budget, cancel tasks for tiles that are
+     * not predicted anymore and move loaded tiles to the cache */
+    void updatePrefetch(TileSet& _tileSet, const ViewState& _view);
+
     /*
      * Constructs a future (async) to load data of a new visible tile this is
      *      also responsible for loading proxy tiles for the newly visible tiles
@@ -220,14 +308,27 @@ protected:
     /*
      * Removes a tile from m_tileSet
      */
-    void removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIter);
+    void removeTile(TileSet& _tileSet, fastmap<TileID, TileEntry>::iterator& _tileIter);
+
+    /* Clears rasters and prefetch state of tiles evicted from the cache.
+     * Evicted tiles may belong to any TileSet. */
+    void clearEvictedTiles(const std::vector<std::pair<int32_t, TileID>>& _evicted);
+
+    /* Applies the cache quota configured for the source of @_tileSet */
+    void applyCacheQuota(TileSet& _tileSet);
+
+    /* Removes cached tiles of @_tileSet that are outdated and lets the
+     * source prune the changes that no remaining tile is older than */
+    void pruneGenerations(TileSet& _tileSet);
 
     /*
      * Checks and updates m_tileSet with proxy tiles for every new visible tile
-     *  @_tile: Tile, the new visible tile for which proxies needs to be added
+     *  @_tileID: the new visible tile for which proxies needs to be added
+     * Proxies from the cache are inserted into the TileSet: References to
+     * TileEntries are not valid afterwards, the tile is looked up by its id.
      */
-    bool updateProxyTile(TileSet& _tileSet, TileEntry& _tile, const TileID& _proxy, const ProxyID _proxyID);
-    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile);
+    bool updateProxyTile(TileSet& _tileSet, const TileID& _tileID, const TileID& _proxy, const ProxyID _proxyID);
+    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID);
 
     /*
      * Once a visible tile finishes loading and is added to m_tileSet, all
@@ -244,6 +345,9 @@ protected:
 
     std::unique_ptr<TileCache> m_tileCache;
 
+    /* Cache quotas by source name */
+    std::unordered_map<std::string, size_t> m_cacheQuotas;
+
     TileTaskQueue& m_workers;
 
     bool m_tileSetChanged = false;
@@ -256,6 +360,33 @@ protected:
     /* Temporary list of tiles that need to be loaded */
     std::vector<std::tuple<double, TileSet*, TileID>> m_loadTasks;
 
+    /* Temporary lists of tiles that are added to a TileSet or need to
+     * update their proxies after the merge loop of updateTileSet() */
+    std::vector<TileID> m_addTiles;
+    std::vector<TileID> m_proxyUpdates;
+
+    struct CameraMotion {
+        std::chrono::steady_clock::time_point time;
+        glm::dvec2 center;
+        float zoom = 0;
+        // Meters and zoom levels per second
+        glm::dvec2 velocity;
+        float zoomVelocity = 0;
+        bool valid = false;
+    };
+
+    CameraMotion m_cameraMotion;
+
+    float m_prefetchTime = 0;
+    size_t m_prefetchBudget = 0;
+
+    PrefetchStats m_prefetchStats;
+
+    std::chrono::steady_clock::time_point m_pathStart;
+    // Seconds since m_pathStart
+    float m_pathTime = 0;
+    bool m_hasPrefetchPath = false;
+
 };
 
 }
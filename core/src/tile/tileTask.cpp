@@ -4,10 +4,17 @@
 #include "scene/scene.h"
 #include "tile/tile.h"
 #include "tile/tileBuilder.h"
+#include "tile/tileDiskCache.h"
+#include "util/clip.h"
 #include "util/mapProjection.h"
+#include "util/zlibHelper.h"
+#include "log.h"
 
 namespace Tangram {
 
+// Margin around sliced tiles in tile units, as common for vector tiles
+const static float SLICE_BUFFER = 64.f / 4096.f;
+
 TileTask::TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask) :
     m_tileId(_tileId),
     m_subTaskId(_subTask),
@@ -15,15 +22,105 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _su
     m_sourceGeneration(_source->generation()),
     m_priority(0) {}
 
-void TileTask::process(TileBuilder& _tileBuilder) {
+void TileTask::setParentData(std::shared_ptr<TileData> _data, TileID _parentId) {
+    m_parentData = std::move(_data);
+    m_parentId = _parentId;
+}
+
+bool TileTask::restore(std::shared_ptr<TileDiskCache> _cache, const Scene& _scene, uint64_t _sceneHash) {
+
+    // Invalid data is dropped by parse()
+    if (!decodeData()) { return false; }
+
+    uint64_t key = diskCacheKey(_sceneHash);
+    if (key == 0) { return false; }
+
+    m_diskCache = std::move(_cache);
+    m_diskCacheKey = key;
+
+    auto entry = m_diskCache->load(key);
+    if (!entry) { return false; }
+
+    if (entry->hasLabels()) {
+        // Labels are built from the parsed data, the cached meshes added in build()
+        m_diskCacheEntry = std::move(entry);
+        return false;
+    }
+
+    auto tile = std::make_shared<Tile>(m_tileId, *_scene.mapProjection(), m_source.get());
+    tile->initGeometry(_scene.styles().size());
+
+    if (!entry->decode(key, *tile, _scene)) {
+        m_diskCache->remove(key);
+        return false;
+    }
+
+    m_tile = std::move(tile);
+    return true;
+}
+
+bool TileTask::parse(const MapProjection& _projection) {
 
-    auto tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+    if (m_parentData) {
+        auto parentData = std::move(m_parentData);
 
-    if (tileData) {
-        m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source);
+        if (m_parentId.z == m_tileId.z) {
+            // Overzoomed tile: Same data as the parent
+            m_tileData = std::move(parentData);
+        } else {
+            m_tileData = sliceTileData(*parentData, m_parentId, m_tileId, SLICE_BUFFER);
+        }
     } else {
+        m_tileData = m_source->parse(*this, _projection);
+
+        if (m_tileData) {
+            m_source->processTileData(*this, *m_tileData);
+            m_source->cacheTileData(*this, m_tileData);
+        }
+    }
+
+    if (!m_tileData) {
         cancel();
+        return false;
     }
+    return true;
+}
+
+void TileTask::build(TileBuilder& _tileBuilder) {
+
+    if (!m_tileData) { return; }
+
+    std::shared_ptr<Tile> tile;
+
+    if (m_diskCacheEntry) {
+        tile = _tileBuilder.buildLabels(m_tileId, *m_tileData, *m_source, &m_canceled);
+
+        if (tile && !m_diskCacheEntry->decode(m_diskCacheKey, *tile, _tileBuilder.scene())) {
+            m_diskCache->remove(m_diskCacheKey);
+            tile.reset();
+        }
+        m_diskCacheEntry.reset();
+    }
+
+    if (!tile && !isCanceled()) {
+        tile = _tileBuilder.build(m_tileId, *m_tileData, *m_source, &m_canceled);
+
+        // Encode before the tile is passed on: Uploading releases the compiled meshes
+        if (tile && m_diskCache) {
+            m_diskCache->store(m_diskCacheKey, TileBundle::encode(m_diskCacheKey, *tile,
+                                                                  _tileBuilder.scene()));
+        }
+    }
+
+    // Sliced from an ancestor: Shown until the tile's own data is loaded
+    if (tile && hasParentData() && m_parentId.z < m_tileId.z) {
+        tile->setProvisional(true);
+    }
+
+    m_tile = std::move(tile);
+
+    // Release the parsed data as soon as the tile is built
+    m_tileData.reset();
 }
 
 void TileTask::complete() {
@@ -35,4 +132,53 @@ void TileTask::complete() {
 
 }
 
+bool BinaryTileTask::decodeData() {
+
+    if (compressed && rawTileData) {
+        auto data = std::make_shared<std::vector<char>>();
+
+        if (zlib::inflate(rawTileData->data(), rawTileData->size(), *data) != 0) {
+            LOGE("Invalid compressed data for tile: %s", m_tileId.toString().c_str());
+            return false;
+        }
+        // Keeps the cached data compressed
+        rawTileData = std::move(data);
+        compressed = false;
+    }
+    return true;
+}
+
+bool BinaryTileTask::parse(const MapProjection& _projection) {
+
+    if (!decodeData()) {
+        cancel();
+        return false;
+    }
+
+    return TileTask::parse(_projection);
+}
+
+uint64_t BinaryTileTask::diskCacheKey(uint64_t _sceneHash) const {
+
+    if (hasParentData() || !rawTileData || rawTileData->empty() || m_source->isRaster()) {
+        return 0;
+    }
+
+    // Of the inflated data: Compressed data differs between cache hits and misses
+    if (compressed) { return 0; }
+
+    const auto& name = m_source->name();
+    int32_t id[] = { m_tileId.x, m_tileId.y, m_tileId.z, m_tileId.s };
+    // Tiles are built from the clipped and simplified data
+    float processing[] = { m_source->clipBuffer(), m_source->simplification() };
+
+    uint64_t key = TileDiskCache::hash(name.data(), name.size());
+    key = TileDiskCache::hash(id, sizeof(id), key);
+    key = TileDiskCache::hash(processing, sizeof(processing), key);
+    key = TileDiskCache::hash(rawTileData->data(), rawTileData->size(), key);
+    key = TileDiskCache::hash(&_sceneHash, sizeof(_sceneHash), key);
+
+    return key;
+}
+
 }
@@ -0,0 +1,124 @@
+#include "tile/tileTaskHeap.h"
+
+#include "data/tileSource.h"
+
+namespace Tangram {
+
+TileTaskHeap::Key TileTaskHeap::keyOf(const TileTask& _task) {
+    return { _task.isProxy(), float(_task.getPriority()), _task.source().id(),
+             _task.sourceGeneration() };
+}
+
+bool TileTaskHeap::contains(const TileTask& _task) const {
+    size_t index = _task.m_queueIndex;
+    return index < m_entries.size() && m_entries[index].task.get() == &_task;
+}
+
+void TileTaskHeap::place(Entry&& _entry, size_t _index) {
+    _entry.task->m_queueIndex = _index;
+    m_entries[_index] = std::move(_entry);
+}
+
+void TileTaskHeap::siftUp(size_t _index) {
+    Entry entry = std::move(m_entries[_index]);
+
+    while (_index > 0) {
+        size_t parent = (_index - 1) / 2;
+        if (!(entry.key < m_entries[parent].key)) { break; }
+
+        place(std::move(m_entries[parent]), _index);
+        _index = parent;
+    }
+    place(std::move(entry), _index);
+}
+
+void TileTaskHeap::siftDown(size_t _index) {
+    Entry entry = std::move(m_entries[_index]);
+    size_t size = m_entries.size();
+
+    while (true) {
+        size_t child = 2 * _index + 1;
+        if (child >= size) { break; }
+
+        if (child + 1 < size && m_entries[child + 1].key < m_entries[child].key) {
+            child++;
+        }
+        if (!(m_entries[child].key < entry.key)) { break; }
+
+        place(std::move(m_entries[child]), _index);
+        _index = child;
+    }
+    place(std::move(entry), _index);
+}
+
+void TileTaskHeap::push(std::shared_ptr<TileTask> _task, int _owner) {
+    _task->m_queueOwner = _owner;
+
+    Key key = keyOf(*_task);
+    m_entries.push_back({ key, std::move(_task) });
+
+    siftUp(m_entries.size() - 1);
+}
+
+std::shared_ptr<TileTask> TileTaskHeap::removeAt(size_t _index) {
+    auto task = std::move(m_entries[_index].task);
+    task->m_queueOwner = -1;
+
+    size_t last = m_entries.size() - 1;
+    if (_index != last) {
+        m_entries[_index] = std::move(m_entries[last]);
+        m_entries.pop_back();
+
+        // The moved entry may belong above or below _index
+        if (_index > 0 && m_entries[_index].key < m_entries[(_index - 1) / 2].key) {
+            siftUp(_index);
+        } else {
+            siftDown(_index);
+        }
+    } else {
+        m_entries.pop_back();
+    }
+    return task;
+}
+
+std::shared_ptr<TileTask> TileTaskHeap::pop() {
+    if (m_entries.empty()) { return nullptr; }
+
+    return removeAt(0);
+}
+
+bool TileTaskHeap::update(TileTask& _task) {
+    if (!contains(_task)) { return false; }
+
+    size_t index = _task.m_queueIndex;
+    Key key = keyOf(_task);
+    Key& current = m_entries[index].key;
+
+    if (key == current) { return true; }
+
+    bool decreased = key < current;
+    current = key;
+
+    if (decreased) {
+        siftUp(index);
+    } else {
+        siftDown(index);
+    }
+    return true;
+}
+
+bool TileTaskHeap::remove(TileTask& _task) {
+    if (!contains(_task)) { return false; }
+
+    removeAt(_task.m_queueIndex);
+    return true;
+}
+
+void TileTaskHeap::clear() {
+    for (auto& entry : m_entries) {
+        entry.task->m_queueOwner = -1;
+    }
+    m_entries.clear();
+}
+
+}
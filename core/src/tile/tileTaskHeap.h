@@ -0,0 +1,104 @@
+#pragma once
+
+#include "tile/tileTask.h"
+
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Indexed binary min-heap of TileTasks
+ *
+ * Tasks are ordered by (isProxy, priority). Generations are counted per source,
+ * so they only order tasks of the same source with equal priority, the older
+ * generation first. Ordering by generation ahead of priority only within a
+ * source is not a strict weak ordering once several sources are queued: With
+ * tasks a and b of one source, generations 1 and 2, priorities 10 and 1, and
+ * c of another source with priority 5, a < b by generation, b < c and c < a
+ * by priority. The heap would then pop in arbitrary order, so priority wins,
+ * which also builds the tile closest to the view center first after a data
+ * change. Each task stores its position in the heap so that a
+ * changed priority can be applied in place with update() in O(log n), instead
+ * of rescanning the whole queue on each pop.
+ * The key of a task is captured on push() and update(); changes to the task
+ * that are not followed by update() do not affect the heap order.
+ *
+ * Not thread-safe: Access must be synchronized by the owner.
+ */
+class TileTaskHeap {
+
+public:
+
+    struct Key {
+        bool proxy;
+        float priority;
+        int32_t sourceId;
+        int64_t sourceGeneration;
+
+        bool operator<(const Key& _rhs) const {
+            if (proxy != _rhs.proxy) { return !proxy; }
+            if (priority != _rhs.priority) { return priority < _rhs.priority; }
+            if (sourceId != _rhs.sourceId) { return sourceId < _rhs.sourceId; }
+            return sourceGeneration < _rhs.sourceGeneration;
+        }
+        bool operator==(const Key& _rhs) const {
+            return proxy == _rhs.proxy &&
+                priority == _rhs.priority &&
+                sourceId == _rhs.sourceId &&
+                sourceGeneration == _rhs.sourceGeneration;
+        }
+    };
+
+    static Key keyOf(const TileTask& _task);
+
+    /* Returns the id passed to push() for the heap that currently holds
+     * @_task or -1 when the task is not queued */
+    static int ownerOf(const TileTask& _task) { return _task.m_queueOwner; }
+
+    /* Marks @_task as owned by heap @_owner before it is pushed. Returns false
+     * when the task is already owned, i.e. queued, by any heap */
+    static bool claim(TileTask& _task, int _owner) {
+        int none = -1;
+        return _task.m_queueOwner.compare_exchange_strong(none, _owner);
+    }
+
+    /* Adds @_task, @_owner is an id by which the heap can be found
+     * through ownerOf(). The task must not be in another heap. */
+    void push(std::shared_ptr<TileTask> _task, int _owner);
+
+    /* Removes and returns the task with the lowest key */
+    std::shared_ptr<TileTask> pop();
+
+    /* Returns the key of the top task. Heap must not be empty. */
+    const Key& topKey() const { return m_entries.front().key; }
+
+    /* Reads the current key of @_task and restores the heap order.
+     * Returns false when @_task is not in this heap */
+    bool update(TileTask& _task);
+
+    /* Removes @_task, returns false when @_task is not in this heap */
+    bool remove(TileTask& _task);
+
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+private:
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<TileTask> task;
+    };
+
+    bool contains(const TileTask& _task) const;
+
+    void place(Entry&& _entry, size_t _index);
+    void siftUp(size_t _index);
+    void siftDown(size_t _index);
+    std::shared_ptr<TileTask> removeAt(size_t _index);
+
+    std::vector<Entry> m_entries;
+};
+
+}
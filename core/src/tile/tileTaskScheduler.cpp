@@ -0,0 +1,214 @@
+#include "tile/tileTaskScheduler.h"
+
+#include "data/tileSource.h"
+
+namespace Tangram {
+
+TileTaskScheduler::TileTaskScheduler(size_t _numLanes) {
+    if (_numLanes == 0) { _numLanes = 1; }
+
+    for (size_t i = 0; i < _numLanes; i++) {
+        m_lanes.push_back(std::make_unique<Lane>());
+    }
+}
+
+TileTaskScheduler::~TileTaskScheduler() {
+    stop();
+    clear();
+}
+
+bool TileTaskScheduler::push(std::shared_ptr<TileTask> _task) {
+    if (!m_running) { return false; }
+
+    size_t id = m_nextLane++ % m_lanes.size();
+
+    // A task is enqueued again while it waits for its raster sub-tasks:
+    // Keep the queued instance
+    if (!TileTaskHeap::claim(*_task, id)) { return true; }
+
+    auto& lane = *m_lanes[id];
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        // Count before the task becomes visible so that m_pending can not underflow
+        m_pending++;
+        lane.tasks.push(std::move(_task), id);
+        lane.size = lane.tasks.size();
+    }
+    {
+        // Synchronize with workers that are about to wait in pop()
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+    }
+    m_condition.notify_one();
+
+    return true;
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::takeBest(Lane& _lane) {
+
+    std::shared_ptr<TileTask> task;
+
+    while (!_lane.tasks.empty()) {
+        task = _lane.tasks.pop();
+        m_pending--;
+
+        if (!task->isCanceled()) { break; }
+        task.reset();
+    }
+
+    _lane.size = _lane.tasks.size();
+
+    return task;
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::steal(size_t _lane) {
+
+    // Find the lane holding the best task. Busy lanes are skipped rather
+    // than waited for.
+    size_t victim = _lane;
+    TileTaskHeap::Key best{};
+
+    for (size_t i = 1; i < m_lanes.size(); i++) {
+        size_t id = (_lane + i) % m_lanes.size();
+        auto& lane = *m_lanes[id];
+
+        if (lane.size == 0) { continue; }
+
+        std::unique_lock<std::mutex> lock(lane.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || lane.tasks.empty()) { continue; }
+
+        if (victim == _lane || lane.tasks.topKey() < best) {
+            victim = id;
+            best = lane.tasks.topKey();
+        }
+    }
+
+    if (victim == _lane) {
+        // All other lanes were busy or empty: Take any task that is left
+        for (size_t i = 1; i < m_lanes.size(); i++) {
+            auto& lane = *m_lanes[(_lane + i) % m_lanes.size()];
+            if (lane.size == 0) { continue; }
+
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            if (auto task = takeBest(lane)) { return task; }
+        }
+        return nullptr;
+    }
+
+    auto& lane = *m_lanes[victim];
+    std::lock_guard<std::mutex> lock(lane.mutex);
+
+    return takeBest(lane);
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::tryPop(size_t _lane) {
+
+    _lane %= m_lanes.size();
+
+    auto& lane = *m_lanes[_lane];
+
+    if (lane.size > 0) {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        if (auto task = takeBest(lane)) { return task; }
+    }
+
+    return steal(_lane);
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::pop(size_t _lane) {
+
+    while (m_running) {
+
+        if (auto task = tryPop(_lane)) { return task; }
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_condition.wait(lock, [this]{ return !m_running || m_pending > 0; });
+    }
+
+    return nullptr;
+}
+
+void TileTaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+}
+
+void TileTaskScheduler::reprioritize(TileTask& _task) {
+
+    // The task may be stolen by another lane meanwhile, retry in that case
+    for (int retry = 0; retry < 3; retry++) {
+        int owner = TileTaskHeap::ownerOf(_task);
+        if (owner < 0 || size_t(owner) >= m_lanes.size()) { return; }
+
+        auto& lane = *m_lanes[owner];
+        std::lock_guard<std::mutex> lock(lane.mutex);
+
+        if (lane.tasks.update(_task)) { return; }
+    }
+}
+
+void TileTaskScheduler::clear() {
+    for (auto& lane : m_lanes) {
+        std::lock_guard<std::mutex> lock(lane->mutex);
+        m_pending -= lane->tasks.size();
+        lane->tasks.clear();
+        lane->size = 0;
+    }
+}
+
+TileTaskStageQueue::TileTaskStageQueue(size_t _capacity)
+    : m_capacity(_capacity > 0 ? _capacity : 1) {}
+
+bool TileTaskStageQueue::push(std::shared_ptr<TileTask> _task) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]{ return !m_running || m_tasks.size() < m_capacity; });
+
+        if (!m_running) { return false; }
+
+        m_tasks.push_back(std::move(_task));
+        m_size = m_tasks.size();
+    }
+    m_notEmpty.notify_one();
+
+    return true;
+}
+
+std::shared_ptr<TileTask> TileTaskStageQueue::pop() {
+    std::shared_ptr<TileTask> task;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]{ return !m_running || !m_tasks.empty(); });
+
+        if (!m_running) { return nullptr; }
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        m_size = m_tasks.size();
+    }
+    m_notFull.notify_one();
+
+    return task;
+}
+
+void TileTaskStageQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+}
+
+void TileTaskStageQueue::clear() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.clear();
+        m_size = 0;
+    }
+    m_notFull.notify_all();
+}
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "tile/tileTask.h"
+#include "tile/tileTaskHeap.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+/* Work-stealing queue for TileTasks
+ *
+ * Every worker thread owns a lane with its own lock, so that workers do not
+ * contend on a single queue. Enqueued tasks are distributed over the lanes;
+ * a worker pops the highest priority task of its own lane and only when that
+ * is empty it steals from the lane that holds the best task of all others.
+ * Lanes are TileTaskHeaps: Priority changes are applied in place through
+ * reprioritize(). Canceled tasks are dropped lazily when they are popped.
+ */
+class TileTaskScheduler {
+
+public:
+
+    TileTaskScheduler(size_t _numLanes);
+
+    ~TileTaskScheduler();
+
+    /* Adds @_task to one of the lanes and wakes up a waiting worker. A task
+     * that is already queued is not added twice.
+     * Returns false when the scheduler was stopped. */
+    bool push(std::shared_ptr<TileTask> _task);
+
+    /* Blocks until a task is available for the worker owning @_lane.
+     * Returns nullptr when the scheduler was stopped. */
+    std::shared_ptr<TileTask> pop(size_t _lane);
+
+    /* Non-blocking variant of pop(): Returns nullptr when no task is queued */
+    std::shared_ptr<TileTask> tryPop(size_t _lane);
+
+    /* Stops the scheduler and wakes up all waiting workers */
+    void stop();
+
+    /* Restores the order of @_task after its priority or proxy state
+     * changed. Does nothing when the task is not queued. */
+    void reprioritize(TileTask& _task);
+
+    /* Removes all queued tasks */
+    void clear();
+
+    bool isRunning() const { return m_running; }
+
+    /* Number of queued tasks, including canceled tasks not yet dropped */
+    size_t size() const { return m_pending; }
+
+    size_t numLanes() const { return m_lanes.size(); }
+
+private:
+
+    struct Lane {
+        std::mutex mutex;
+        TileTaskHeap tasks;
+        std::atomic<size_t> size{0};
+    };
+
+    /* Removes the highest priority task from @_lane and drops canceled tasks
+     * on the way. Lane lock must be held. */
+    std::shared_ptr<TileTask> takeBest(Lane& _lane);
+
+    std::shared_ptr<TileTask> steal(size_t _lane);
+
+    std::vector<std::unique_ptr<Lane>> m_lanes;
+
+    std::atomic<size_t> m_nextLane{0};
+    std::atomic<size_t> m_pending{0};
+    std::atomic<bool> m_running{true};
+
+    // Only used to park idle workers
+    std::mutex m_waitMutex;
+    std::condition_variable m_condition;
+};
+
+/* Bounded FIFO queue handing TileTasks from one pipeline stage to the next
+ *
+ * push() blocks while the queue is full, so that a fast producing stage can
+ * not run ahead and pile up intermediate results of a slower consuming stage.
+ */
+class TileTaskStageQueue {
+
+public:
+
+    TileTaskStageQueue(size_t _capacity);
+
+    /* Blocks while the queue is full. Returns false when the queue was
+     * stopped, @_task is not added in that case. */
+    bool push(std::shared_ptr<TileTask> _task);
+
+    /* Blocks until a task is available.
+     * Returns nullptr when the queue was stopped. */
+    std::shared_ptr<TileTask> pop();
+
+    /* Stops the queue and wakes up all waiting producers and consumers */
+    void stop();
+
+    /* Removes all queued tasks */
+    void clear();
+
+    size_t size() const { return m_size; }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+
+    const size_t m_capacity;
+
+    std::deque<std::shared_ptr<TileTask>> m_tasks;
+    std::atomic<size_t> m_size{0};
+    bool m_running = true;
+
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+};
+
+}
@@ -4,23 +4,82 @@
 #include "log.h"
 #include "map.h"
 #include "platform.h"
+#include "scene/scene.h"
 #include "tile/tileBuilder.h"
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
+#include "util/mapProjection.h"
 
 #include <algorithm>
+#include <chrono>
 
 #define WORKER_NICENESS 10
 
+// Parsed tasks that may wait for each build worker
+#define PARSED_TASKS_PER_WORKER 2
+
+// Upper bound of parse workers sized by the number of CPU cores: More would
+// only wait for the build stage
+#define MAX_PARSE_WORKERS 4
+
 namespace Tangram {
 
-TileWorker::TileWorker(std::shared_ptr<Platform> _platform, int _numWorker) : m_platform(_platform) {
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsedUs(Clock::time_point _start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _start).count();
+}
+
+void TileWorker::StageCounters::add(uint64_t _time, bool _aborted) {
+
+    if (_aborted) {
+        // Estimate the remaining time from the average of completed tasks.
+        // Counters are updated concurrently, so only read each one once.
+        uint64_t numTasks = processed, numAborted = aborted;
+        uint64_t time = busyTime, timeAborted = abortedTime;
+
+        if (numTasks > numAborted && time > timeAborted) {
+            uint64_t average = (time - timeAborted) / (numTasks - numAborted);
+            if (average > _time) { savedTime += average - _time; }
+        }
+        aborted++;
+        abortedTime += _time;
+    }
+    busyTime += _time;
+    processed++;
+}
+
+void TileWorker::StageCounters::get(Stats::Stage& _stage) const {
+    _stage.processed = processed;
+    _stage.busyMs = busyTime / 1000.0;
+    _stage.blockedMs = blockedTime / 1000.0;
+    _stage.aborted = aborted;
+    _stage.savedMs = savedTime / 1000.0;
+}
+
+size_t TileWorker::defaultParseWorkers(size_t _numBuildWorker) {
+    // 0 when not known
+    size_t cores = std::thread::hardware_concurrency();
+
+    if (cores <= _numBuildWorker) { return 1; }
+
+    return std::min<size_t>(cores - _numBuildWorker, MAX_PARSE_WORKERS);
+}
+
+TileWorker::TileWorker(std::shared_ptr<Platform> _platform, int _numBuildWorker, int _numParseWorker)
+    : m_queue(_numParseWorker > 0 ? _numParseWorker : defaultParseWorkers(std::max(_numBuildWorker, 1))),
+      m_parsed(std::max(_numBuildWorker, 1) * PARSED_TASKS_PER_WORKER),
+      m_platform(_platform) {
     m_running = true;
 
-    for (int i = 0; i < _numWorker; i++) {
+    for (size_t i = 0; i < m_queue.numLanes(); i++) {
+        m_parseWorkers.emplace_back(&TileWorker::runParse, this, i);
+    }
+
+    for (int i = 0; i < std::max(_numBuildWorker, 1); i++) {
         auto worker = std::make_unique<Worker>();
-        worker->thread = std::thread(&TileWorker::run, this, worker.get());
-        m_workers.push_back(std::move(worker));
+        worker->thread = std::thread(&TileWorker::runBuild, this, worker.get());
+        m_buildWorkers.push_back(std::move(worker));
     }
 }
 
@@ -30,7 +89,73 @@ TileWorker::~TileWorker(){
     }
 }
 
-void TileWorker::run(Worker* instance) {
+void TileWorker::runParse(size_t _lane) {
+
+    setCurrentThreadPriority(WORKER_NICENESS);
+
+    while (true) {
+
+        std::shared_ptr<Scene> scene;
+        std::shared_ptr<TileDiskCache> diskCache;
+        uint64_t sceneHash;
+        {
+            std::unique_lock<std::mutex> lock(m_sceneMutex);
+
+            // Wait for the first Scene before taking any tasks
+            m_sceneCondition.wait(lock, [&, this]{ return !m_running || m_scene; });
+            scene = m_scene;
+            diskCache = m_diskCache;
+            sceneHash = m_sceneHash;
+        }
+
+        // Check if thread should stop
+        if (!m_running) {
+            break;
+        }
+
+        // Pop highest priority tile from this worker's lane or steal one
+        auto task = m_queue.pop(_lane);
+
+        if (!task) {
+            break;
+        }
+
+        if (task->isCanceled()) {
+            continue;
+        }
+
+        auto start = Clock::now();
+
+        // Tile debug geometry is not part of the cache keys
+        if (diskCache && !getDebugFlag(DebugFlags::tile_bounds) &&
+            !getDebugFlag(DebugFlags::tile_infos) &&
+            task->restore(diskCache, *scene, sceneHash)) {
+
+            m_parseCounters.add(elapsedUs(start), false);
+            m_platform->requestRender();
+            continue;
+        }
+
+        bool needsBuild = task->parse(*scene->mapProjection());
+
+        m_parseCounters.add(elapsedUs(start), task->isCanceled());
+
+        if (!needsBuild || task->isCanceled()) {
+            m_platform->requestRender();
+            continue;
+        }
+
+        start = Clock::now();
+
+        if (!m_parsed.push(std::move(task))) {
+            break;
+        }
+
+        m_parseCounters.blockedTime += elapsedUs(start);
+    }
+}
+
+void TileWorker::runBuild(Worker* instance) {
 
     setCurrentThreadPriority(WORKER_NICENESS);
 
@@ -38,95 +163,160 @@ void TileWorker::run(Worker* instance) {
 
     while (true) {
 
-        std::shared_ptr<TileTask> task;
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
+            std::unique_lock<std::mutex> lock(instance->mutex);
 
-            m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
+            // Wait for the first TileBuilder before taking any tasks
+            instance->condition.wait(lock, [&, this]{
+                    return !m_running || builder || instance->tileBuilder;
                 });
 
             if (instance->tileBuilder) {
                 builder = std::move(instance->tileBuilder);
                 LOG("Passed new TileBuilder to TileWorker");
             }
+        }
 
-            // Check if thread should stop
-            if (!m_running) {
-                break;
-            }
-
-            if (!builder) {
-                continue;
-            }
+        // Check if thread should stop
+        if (!m_running) {
+            break;
+        }
 
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
+        auto task = m_parsed.pop();
 
-            m_queue.erase(removes, m_queue.end());
+        if (!task) {
+            break;
+        }
 
-            if (m_queue.empty()) {
-                continue;
+        {
+            // Pick up a TileBuilder for a new scene that was set meanwhile
+            std::unique_lock<std::mutex> lock(instance->mutex);
+            if (instance->tileBuilder) {
+                builder = std::move(instance->tileBuilder);
+                LOG("Passed new TileBuilder to TileWorker");
             }
-
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->source().id() == b->source().id() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
-
-            task = std::move(*it);
-            m_queue.erase(it);
         }
 
         if (task->isCanceled()) {
             continue;
         }
 
-        task->process(*builder);
+        auto start = Clock::now();
+
+        task->build(*builder);
+
+        m_buildCounters.add(elapsedUs(start), task->isCanceled() && !task->tile());
 
         m_platform->requestRender();
     }
 }
 
 void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
-    for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+    size_t styleWorkers;
+    {
+        std::unique_lock<std::mutex> lock(m_sceneMutex);
+        styleWorkers = m_styleWorkers;
     }
+
+    // Tiles built for another config or pixel scale are not reused
+    std::string config = YAML::Dump(_scene->config());
+    float pixelScale = _scene->pixelScale();
+
+    uint64_t sceneHash = TileDiskCache::hash(config.data(), config.size());
+    sceneHash = TileDiskCache::hash(&pixelScale, sizeof(pixelScale), sceneHash);
+
+    for (auto& worker : m_buildWorkers) {
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->tileBuilder = std::make_unique<TileBuilder>(_scene, styleWorkers);
+        }
+        worker->condition.notify_one();
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_sceneMutex);
+        m_scene = _scene;
+        m_sceneHash = sceneHash;
+    }
+    m_sceneCondition.notify_all();
+}
+
+void TileWorker::setDiskCache(std::shared_ptr<TileDiskCache> _cache) {
+    std::unique_lock<std::mutex> lock(m_sceneMutex);
+    m_diskCache = std::move(_cache);
+}
+
+void TileWorker::setStyleWorkers(size_t _styleWorkers) {
+    std::shared_ptr<Scene> scene;
+    {
+        std::unique_lock<std::mutex> lock(m_sceneMutex);
+        if (m_styleWorkers == _styleWorkers) { return; }
+
+        m_styleWorkers = _styleWorkers;
+        scene = m_scene;
+    }
+
+    // Recreate the TileBuilders for the current scene
+    if (scene) { setScene(scene); }
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask> task) {
+    if (!m_running) {
+        return;
+    }
+    m_queue.push(std::move(task));
+}
+
+void TileWorker::reprioritize(TileTask& task) {
+    m_queue.reprioritize(task);
+}
+
+TileWorker::Stats TileWorker::stats() const {
+    Stats stats;
+
+    stats.parse.workers = m_parseWorkers.size();
+    stats.parse.queued = m_queue.size();
+    m_parseCounters.get(stats.parse);
+
+    stats.build.workers = m_buildWorkers.size();
+    stats.build.queued = m_parsed.size();
+    m_buildCounters.get(stats.build);
+
+    std::shared_ptr<TileDiskCache> diskCache;
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
-            return;
-        }
-        m_queue.push_back(std::move(task));
+        std::unique_lock<std::mutex> lock(m_sceneMutex);
+        diskCache = m_diskCache;
     }
-    m_condition.notify_one();
+    if (diskCache) { stats.diskCache = diskCache->stats(); }
+
+    return stats;
 }
 
 void TileWorker::stop() {
+    m_running = false;
+
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_running = false;
+        std::unique_lock<std::mutex> lock(m_sceneMutex);
     }
+    m_sceneCondition.notify_all();
 
-    m_condition.notify_all();
+    for (auto& worker : m_buildWorkers) {
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+        }
+        worker->condition.notify_all();
+    }
+    m_queue.stop();
+    m_parsed.stop();
 
-    for (auto& worker : m_workers) {
+    for (auto& thread : m_parseWorkers) {
+        thread.join();
+    }
+    for (auto& worker : m_buildWorkers) {
         worker->thread.join();
     }
 
     m_queue.clear();
+    m_parsed.clear();
 }
 
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "tile/tileDiskCache.h"
 #include "tile/tileTask.h"
+#include "tile/tileTaskScheduler.h"
 #include "util/jobQueue.h"
 
 #include <atomic>
@@ -17,39 +19,122 @@ class Platform;
 class Scene;
 class TileBuilder;
 
+/* Processes TileTasks in a two-stage pipeline
+ *
+ * Parse workers decode the raw data of a task (TileTask::parse), build workers
+ * style the parsed data, layout labels and compile the meshes
+ * (TileTask::build). Both stages run on their own threads, connected by a
+ * bounded queue, so that decoding of the next tile overlaps the styling of
+ * the current one while a slow build stage holds back the parse workers.
+ */
 class TileWorker : public TileTaskQueue {
 
 public:
 
-    TileWorker(std::shared_ptr<Platform> _platform, int _numWorker);
+    struct Stats {
+        struct Stage {
+            // Number of threads assigned to the stage
+            size_t workers = 0;
+            // Number of tasks waiting for the stage
+            size_t queued = 0;
+            // Number of tasks processed by the stage
+            uint64_t processed = 0;
+            // Accumulated processing time
+            double busyMs = 0;
+            // Accumulated time blocked on a full output queue (parse stage)
+            double blockedMs = 0;
+            // Number of tasks that stopped early as they were canceled
+            uint64_t aborted = 0;
+            // Estimated processing time saved by aborted tasks, based on
+            // the average time of completed tasks
+            double savedMs = 0;
+        };
+        Stage parse;
+        Stage build;
+        // Counters of the TileDiskCache, when one is set
+        TileDiskCache::Stats diskCache;
+    };
+
+    // A number of parse workers below 1 sizes the parse stage by the number of
+    // CPU cores, see defaultParseWorkers()
+    TileWorker(std::shared_ptr<Platform> _platform, int _numBuildWorker, int _numParseWorker = 0);
 
     ~TileWorker();
 
     virtual void enqueue(std::shared_ptr<TileTask> task) override;
 
+    virtual void reprioritize(TileTask& task) override;
+
     void stop();
 
     bool isRunning() const { return m_running; }
 
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    // Set the number of helper threads that each build worker uses to style
+    // the DataLayers of large tiles concurrently
+    void setStyleWorkers(size_t _styleWorkers);
+
+    // Restore tiles from @_cache and store built tiles in it, nullptr to
+    // disable the disk cache
+    void setDiskCache(std::shared_ptr<TileDiskCache> _cache);
+
+    Stats stats() const;
+
+    // Number of parse workers for the CPU cores that are not taken by
+    // @_numBuildWorker build workers, at least one
+    static size_t defaultParseWorkers(size_t _numBuildWorker);
+
 private:
 
     struct Worker {
         std::thread thread;
         std::unique_ptr<TileBuilder> tileBuilder;
+
+        // Guards handing over a new TileBuilder to the worker thread
+        std::mutex mutex;
+        std::condition_variable condition;
     };
 
-    void run(Worker* instance);
+    struct StageCounters {
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> busyTime{0};
+        std::atomic<uint64_t> blockedTime{0};
+        std::atomic<uint64_t> aborted{0};
+        std::atomic<uint64_t> abortedTime{0};
+        std::atomic<uint64_t> savedTime{0};
+
+        // Count a task that was processed in @_time us
+        void add(uint64_t _time, bool _aborted);
+
+        void get(Stats::Stage& _stage) const;
+    };
+
+    void runParse(size_t _lane);
+
+    void runBuild(Worker* instance);
+
+    std::atomic<bool> m_running;
 
-    bool m_running;
+    std::vector<std::thread> m_parseWorkers;
+    std::vector<std::unique_ptr<Worker>> m_buildWorkers;
 
-    std::vector<std::unique_ptr<Worker>> m_workers;
+    // Input of the parse stage
+    TileTaskScheduler m_queue;
+    // Parsed tasks waiting for the build stage
+    TileTaskStageQueue m_parsed;
 
-    std::condition_variable m_condition;
+    StageCounters m_parseCounters;
+    StageCounters m_buildCounters;
 
-    std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+    // Scene of the current TileBuilders, provides the MapProjection for parsing
+    std::shared_ptr<Scene> m_scene;
+    size_t m_styleWorkers = 0;
+    std::shared_ptr<TileDiskCache> m_diskCache;
+    // Hash of the scene config for keys of the disk cache
+    uint64_t m_sceneHash = 0;
+    mutable std::mutex m_sceneMutex;
+    std::condition_variable m_sceneCondition;
 
     std::shared_ptr<Platform> m_platform;
 };
@@ -0,0 +1,66 @@
+#include "util/arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Tangram {
+
+constexpr size_t Arena::DEFAULT_CHUNK_SIZE;
+constexpr size_t Arena::ALIGN;
+constexpr size_t Arena::HEADER_SIZE;
+
+Arena::Arena(size_t _chunkSize) : m_chunkSize(_chunkSize) {}
+
+Arena::~Arena() {
+    Chunk* chunk = m_chunks;
+    while (chunk) {
+        Chunk* next = chunk->next;
+        chunk->~Chunk();
+        std::free(chunk);
+        chunk = next;
+    }
+}
+
+Arena::Chunk* Arena::newChunk(size_t _capacity) {
+
+    void* memory = std::malloc(HEADER_SIZE + _capacity);
+    if (!memory) { throw std::bad_alloc(); }
+
+    Chunk* chunk = new (memory) Chunk();
+    chunk->capacity = _capacity;
+
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+
+    m_capacity.fetch_add(HEADER_SIZE + _capacity, std::memory_order_relaxed);
+    m_chunkCount.fetch_add(1, std::memory_order_relaxed);
+
+    return chunk;
+}
+
+void* Arena::allocateSlow(size_t _size) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Large allocations get a chunk of their own, keeping the current one
+    if (_size > m_chunkSize / 2) {
+        Chunk* chunk = newChunk(_size);
+        chunk->used.store(_size, std::memory_order_relaxed);
+        return chunk->data();
+    }
+
+    // Another thread may have started a new chunk in the meantime
+    Chunk* current = m_current.load(std::memory_order_relaxed);
+    if (current) {
+        size_t offset = current->used.fetch_add(_size, std::memory_order_relaxed);
+        if (offset + _size <= current->capacity) { return current->data() + offset; }
+    }
+
+    Chunk* chunk = newChunk(m_chunkSize);
+    chunk->used.store(_size, std::memory_order_relaxed);
+    m_current.store(chunk, std::memory_order_release);
+
+    return chunk->data();
+}
+
+}
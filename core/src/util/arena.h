@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Tangram {
+
+/* Monotonic allocator for data that is released all at once, like the
+ * TileData of a TileTask. Memory is taken from chunks of @_chunkSize bytes
+ * and only freed when the Arena is destroyed.
+ *
+ * allocate() is thread-safe: Lazily parsed geometry may be decoded by
+ * several threads styling the same TileData. The common case bumps an
+ * atomic offset into the current chunk. */
+class Arena {
+
+public:
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t _chunkSize = DEFAULT_CHUNK_SIZE);
+
+    ~Arena();
+
+    // No copies
+    Arena(const Arena& _other) = delete;
+    Arena& operator=(const Arena& _other) = delete;
+
+    /* Returns @_size bytes aligned to at most alignof(std::max_align_t) */
+    void* allocate(size_t _size, size_t _align) {
+        assert(_align <= ALIGN);
+        _size = (_size + ALIGN - 1) & ~(ALIGN - 1);
+
+        // A failed bump leaves the rest of the chunk unused, so large
+        // allocations skip it
+        Chunk* chunk = m_current.load(std::memory_order_acquire);
+        if (chunk && _size <= m_chunkSize / 2) {
+            size_t offset = chunk->used.fetch_add(_size, std::memory_order_relaxed);
+            if (offset + _size <= chunk->capacity) { return chunk->data() + offset; }
+        }
+        return allocateSlow(_size);
+    }
+
+    /* Bytes of all chunks */
+    size_t capacity() const { return m_capacity.load(std::memory_order_relaxed); }
+
+    /* Number of chunks, i.e. allocations made from the heap */
+    size_t chunkCount() const { return m_chunkCount.load(std::memory_order_relaxed); }
+
+private:
+
+    static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+    struct Chunk {
+        Chunk* next = nullptr;
+        size_t capacity = 0;
+        // May exceed capacity after failed allocations
+        std::atomic<size_t> used{0};
+
+        char* data() { return reinterpret_cast<char*>(this) + HEADER_SIZE; }
+    };
+
+    static constexpr size_t HEADER_SIZE = (sizeof(Chunk) + ALIGN - 1) & ~(ALIGN - 1);
+
+    void* allocateSlow(size_t _size);
+
+    Chunk* newChunk(size_t _capacity);
+
+    const size_t m_chunkSize;
+
+    std::atomic<Chunk*> m_current{nullptr};
+
+    // Guards m_chunks and replacing m_current
+    std::mutex m_mutex;
+    Chunk* m_chunks = nullptr;
+
+    std::atomic<size_t> m_capacity{0};
+    std::atomic<size_t> m_chunkCount{0};
+};
+
+/* STL allocator taking memory from an Arena, or from the heap when it has
+ * none. Copies of a container allocate from the heap, so they can outlive
+ * the Arena. Moves keep the Arena of the source. */
+template<typename T>
+class ArenaAllocator {
+
+public:
+
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() {}
+    ArenaAllocator(Arena* _arena) : m_arena(_arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) : m_arena(_other.arena()) {}
+
+    T* allocate(size_t _n) {
+        if (m_arena) {
+            return static_cast<T*>(m_arena->allocate(_n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(_n * sizeof(T)));
+    }
+
+    void deallocate(T* _p, size_t _n) {
+        if (!m_arena) { ::operator delete(_p); }
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const { return {}; }
+
+    Arena* arena() const { return m_arena; }
+
+private:
+
+    Arena* m_arena = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) {
+    return _a.arena() == _b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) {
+    return _a.arena() != _b.arena();
+}
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
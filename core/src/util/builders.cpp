@@ -30,7 +30,9 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+void Builders::buildPolygon(const PolygonRef& _polygon, float _height, PolygonBuilder& _ctx) {
+
+    if (_polygon.empty()) { return; }
 
     glm::vec2 min, max;
     if (_ctx.useTexCoords) {
@@ -48,10 +50,10 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     // Run earcut, triangles are stored in _ctx.earcut.indices
     _ctx.earcut(_polygon);
 
-    size_t sumPoints = 0;
-    for (auto& line : _polygon) {
-        sumPoints += line.size();
-    }
+    // The points of the polygon rings are stored one after another,
+    // as indexed by earcut
+    const Point* points = _polygon.front().begin();
+    size_t sumPoints = _polygon.pointCount();
 
     // Mark the points that are referenced by indices as used.
     size_t sumVertices = 0;
@@ -66,25 +68,15 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     uint16_t vertexDataOffset = _ctx.numVertices;
     _ctx.numVertices += sumVertices;
 
-    size_t ring = 0;
-    size_t offset = 0;
-
     // Go through all points of the polyon.
     for (size_t src = 0, dst = 0; src < sumPoints; src++) {
-        // The points of the polygon rings are indexed linearly.
-        // This maps the indices back to the original ring and point.
-        if (src - offset >= _polygon[ring].size()) {
-            offset += _polygon[ring].size();
-            ring += 1;
-        }
-
         // Add vertex only when the point is used.
         if (_ctx.used[src] == 0) { continue; }
 
         // Keep track of skipped points to update indices
         _ctx.used[src] = dst++;
 
-        auto& p = _polygon[ring][src - offset];
+        auto& p = points[src];
         glm::vec3 coord(p.x, p.y, _height);
 
         if (_ctx.useTexCoords) {
@@ -102,14 +94,14 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     }
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+void Builders::buildPolygonExtrusion(const PolygonRef& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
 
     auto vertexDataOffset = _ctx.numVertices;
 
     static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
     glm::vec3 normalVector;
 
-    for (auto& line : _polygon) {
+    for (auto line : _polygon) {
 
         size_t lineSize = line.size();
 
@@ -275,7 +267,7 @@ bool isOutsideTile(const glm::vec3& _a, const glm::vec3& _b) {
     return false;
 }
 
-void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _startIndex,
+void buildPolyLineSegment(const LineRef& _line, PolyLineBuilder& _ctx, size_t _startIndex,
                           size_t _endIndex, bool endCap = true) {
 
     float distance = 0; // Cumulative distance along the polyline.
@@ -396,7 +388,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
 
 }
 
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+void Builders::buildPolyLine(const LineRef& _line, PolyLineBuilder& _ctx) {
 
     size_t lineSize = _line.size();
 
@@ -0,0 +1,302 @@
+#include "util/clip.h"
+
+#include "data/propertyItem.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+
+namespace Tangram {
+
+// Liang-Barsky: Parameters of the part of segment _a -> _b inside of _box
+static bool clipSegment(const Point& _a, const Point& _b, const ClipBox& _box, float& _t0, float& _t1) {
+
+    float dx = _b.x - _a.x;
+    float dy = _b.y - _a.y;
+
+    const float p[4] = { -dx, dx, -dy, dy };
+    const float q[4] = { _a.x - _box.min.x, _box.max.x - _a.x,
+                         _a.y - _box.min.y, _box.max.y - _a.y };
+    _t0 = 0.f;
+    _t1 = 1.f;
+
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.f) {
+            // Parallel to this edge
+            if (q[i] < 0.f) { return false; }
+            continue;
+        }
+        float t = q[i] / p[i];
+        if (p[i] < 0.f) {
+            if (t > _t1) { return false; }
+            if (t > _t0) { _t0 = t; }
+        } else {
+            if (t < _t0) { return false; }
+            if (t < _t1) { _t1 = t; }
+        }
+    }
+    return true;
+}
+
+static bool containsAll(const LineRef& _line, const ClipBox& _box) {
+    for (auto& p : _line) {
+        if (!_box.contains(p)) { return false; }
+    }
+    return true;
+}
+
+void clipLine(const LineRef& _line, const ClipBox& _box, Feature& _out) {
+
+    if (_line.size() < 2) { return; }
+
+    if (containsAll(_line, _box)) {
+        _out.addLine(_line);
+        return;
+    }
+
+    // Points of the current line are added to _out from here on
+    size_t start = _out.points.size();
+    auto& current = _out.points;
+
+    auto flush = [&]() {
+        if (current.size() - start >= 2) {
+            _out.endLine();
+        } else {
+            current.resize(start);
+        }
+        start = current.size();
+    };
+
+    for (size_t i = 1; i < _line.size(); i++) {
+        const Point& a = _line[i-1];
+        const Point& b = _line[i];
+
+        float t0, t1;
+        if (!clipSegment(a, b, _box, t0, t1)) {
+            flush();
+            continue;
+        }
+
+        if (current.size() == start) {
+            current.push_back(t0 > 0.f ? glm::mix(a, b, t0) : a);
+        }
+
+        Point end = t1 < 1.f ? glm::mix(a, b, t1) : b;
+        if (end != current.back()) { current.push_back(end); }
+
+        // The line leaves the box
+        if (t1 < 1.f) { flush(); }
+    }
+
+    flush();
+}
+
+// Edges of the box: 0 left, 1 right, 2 bottom, 3 top
+static bool insideEdge(int _edge, const Point& _p, const ClipBox& _box) {
+    switch (_edge) {
+    case 0: return _p.x >= _box.min.x;
+    case 1: return _p.x <= _box.max.x;
+    case 2: return _p.y >= _box.min.y;
+    default: return _p.y <= _box.max.y;
+    }
+}
+
+static Point intersectEdge(int _edge, const Point& _a, const Point& _b, const ClipBox& _box) {
+    float t;
+    switch (_edge) {
+    case 0: t = (_box.min.x - _a.x) / (_b.x - _a.x); break;
+    case 1: t = (_box.max.x - _a.x) / (_b.x - _a.x); break;
+    case 2: t = (_box.min.y - _a.y) / (_b.y - _a.y); break;
+    default: t = (_box.max.y - _a.y) / (_b.y - _a.y); break;
+    }
+    return glm::mix(_a, _b, t);
+}
+
+void clipRing(const LineRef& _ring, const ClipBox& _box, Line& _out) {
+
+    _out.clear();
+
+    if (_ring.size() < 3) { return; }
+
+    if (containsAll(_ring, _box)) {
+        _out.assign(_ring.begin(), _ring.end());
+        return;
+    }
+
+    bool closed = _ring.front() == _ring.back();
+
+    Line input(_ring.begin(), closed ? _ring.end() - 1 : _ring.end());
+    Line output;
+
+    for (int edge = 0; edge < 4; edge++) {
+        output.clear();
+
+        size_t n = input.size();
+        for (size_t i = 0; i < n; i++) {
+            const Point& prev = input[(i + n - 1) % n];
+            const Point& cur = input[i];
+
+            bool prevInside = insideEdge(edge, prev, _box);
+
+            if (insideEdge(edge, cur, _box)) {
+                if (!prevInside) { output.push_back(intersectEdge(edge, prev, cur, _box)); }
+                output.push_back(cur);
+            } else if (prevInside) {
+                output.push_back(intersectEdge(edge, prev, cur, _box));
+            }
+        }
+
+        input.swap(output);
+        if (input.empty()) { return; }
+    }
+
+    if (input.size() < 3) { return; }
+
+    if (closed) { input.push_back(input.front()); }
+
+    _out = std::move(input);
+}
+
+bool clipPolygon(const PolygonRef& _polygon, const ClipBox& _box, Feature& _out) {
+
+    if (_polygon.empty()) { return false; }
+
+    Line ring;
+    for (size_t i = 0; i < _polygon.size(); i++) {
+        clipRing(_polygon[i], _box, ring);
+
+        if (ring.empty()) {
+            // Without outer ring there is nothing left
+            if (i == 0) { return false; }
+            continue;
+        }
+        _out.addLine(ring);
+    }
+    _out.endPolygon();
+    return true;
+}
+
+// Adds the parts of the decoded geometry of _feature inside _box to _out
+static void clipGeometry(const Feature& _feature, const ClipBox& _box, Feature& _out) {
+
+    _out.geometryType = _feature.geometryType;
+
+    switch (_feature.geometryType) {
+    case GeometryType::points:
+        for (auto& point : _feature.points) {
+            if (_box.contains(point)) { _out.points.push_back(point); }
+        }
+        break;
+    case GeometryType::lines:
+        for (auto line : _feature.lines()) {
+            clipLine(line, _box, _out);
+        }
+        break;
+    case GeometryType::polygons:
+        for (auto polygon : _feature.polygons()) {
+            clipPolygon(polygon, _box, _out);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+bool clipFeature(const Feature& _feature, const ClipBox& _box, Feature& _out) {
+
+    _feature.decodeGeometry();
+
+    clipGeometry(_feature, _box, _out);
+
+    if (_out.points.empty()) { return false; }
+
+    _out.props = _feature.props;
+    return true;
+}
+
+bool clipFeatureGeometry(Feature& _feature, const ClipBox& _box) {
+
+    if (_feature.points.empty()) { return false; }
+
+    if (containsAll(LineRef(_feature.points.data(), _feature.points.data() + _feature.points.size()), _box)) {
+        return true;
+    }
+
+    // From the same arena, so that the geometry is moved back without copying
+    Feature clipped(_feature.props.sourceId, _feature.points.get_allocator().arena());
+    clipGeometry(_feature, _box, clipped);
+
+    _feature.points = std::move(clipped.points);
+    _feature.lineEnds = std::move(clipped.lineEnds);
+    _feature.polygonEnds = std::move(clipped.polygonEnds);
+
+    return !_feature.points.empty();
+}
+
+void clipTileData(TileData& _data, float _buffer) {
+
+    ClipBox box{ glm::vec2(-_buffer), glm::vec2(1.f + _buffer) };
+
+    for (auto& layer : _data.layers) {
+        layer.processGeometry([box](Feature& _feature) { clipFeatureGeometry(_feature, box); });
+
+        // Drop features without geometry left. Those not decoded yet are kept
+        auto outside = [](const Feature& _feature) {
+            bool encoded = _feature.encoded.decoder &&
+                !_feature.encoded.decoded.load(std::memory_order_relaxed);
+            return !encoded && _feature.points.empty();
+        };
+        auto& features = layer.features;
+        features.erase(std::remove_if(features.begin(), features.end(), outside), features.end());
+    }
+}
+
+std::shared_ptr<TileData> sliceTileData(const TileData& _data, const TileID& _parent,
+                                        const TileID& _child, float _buffer) {
+
+    int32_t levels = _child.z - _parent.z;
+
+    if (levels < 0 || levels > 24 ||
+        (_child.x >> levels) != _parent.x ||
+        (_child.y >> levels) != _parent.y) {
+        return nullptr;
+    }
+
+    float scale = float(1 << levels);
+
+    // South-west corner of the child in parent tile coordinates.
+    // Tile rows count from north, tile coordinates from south.
+    float col = _child.x - (_parent.x << levels);
+    float row = _child.y - (_parent.y << levels);
+    glm::vec2 origin(col / scale, (scale - 1.f - row) / scale);
+
+    float buffer = _buffer / scale;
+    ClipBox box{ origin - buffer, origin + (1.f + _buffer) / scale };
+
+    auto transform = [&](Point& _p) {
+        _p.x = (_p.x - origin.x) * scale;
+        _p.y = (_p.y - origin.y) * scale;
+        _p.z *= scale;
+    };
+
+    auto data = std::make_shared<TileData>();
+    data->arena = std::make_shared<Arena>();
+    data->layers.reserve(_data.layers.size());
+
+    for (auto& layer : _data.layers) {
+        data->layers.emplace_back(layer.name);
+        auto& features = data->layers.back().features;
+
+        for (auto& feature : layer.features) {
+            Feature clipped(feature.props.sourceId, data->arena.get());
+            if (!clipFeature(feature, box, clipped)) { continue; }
+
+            for (auto& p : clipped.points) { transform(p); }
+            features.push_back(std::move(clipped));
+        }
+    }
+
+    return data;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "data/tileData.h"
+#include "tile/tileID.h"
+
+#include "glm/vec2.hpp"
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Axis-aligned box in tile coordinates */
+struct ClipBox {
+    glm::vec2 min;
+    glm::vec2 max;
+
+    bool contains(const Point& _p) const {
+        return _p.x >= min.x && _p.x <= max.x && _p.y >= min.y && _p.y <= max.y;
+    }
+};
+
+/* Appends the parts of @_line inside @_box to the lines of @_out. A line that
+ * leaves and enters the box again is split into several lines. */
+void clipLine(const LineRef& _line, const ClipBox& _box, Feature& _out);
+
+/* Clips the closed ring @_ring to @_box with the Sutherland-Hodgman algorithm.
+ * The result in @_out is closed again, or empty when no area is left. */
+void clipRing(const LineRef& _ring, const ClipBox& _box, Line& _out);
+
+/* Clips the outer ring and holes of @_polygon to @_box and appends the result
+ * to the polygons of @_out. Returns false when the outer ring is outside of the box. */
+bool clipPolygon(const PolygonRef& _polygon, const ClipBox& _box, Feature& _out);
+
+/* Copies the properties and the parts of the geometry of @_feature inside
+ * @_box to @_out. Returns false when no geometry is left. */
+bool clipFeature(const Feature& _feature, const ClipBox& _box, Feature& _out);
+
+/* Clips the decoded geometry of @_feature to @_box in place. Returns false
+ * when no geometry is left. */
+bool clipFeatureGeometry(Feature& _feature, const ClipBox& _box);
+
+/* Clips the geometry of the features of @_data to the tile plus @_buffer in
+ * tile units and removes features outside of it. Features with lazily parsed
+ * geometry are clipped when they are decoded. */
+void clipTileData(TileData& _data, float _buffer);
+
+/* Returns the data of tile @_child from the data of its ancestor @_parent:
+ * Geometry is clipped to the area of the child tile plus @_buffer and
+ * rescaled to the coordinates of the child tile. @_buffer is in units of
+ * the child tile. Returns nullptr when @_child is not in @_parent. */
+std::shared_ptr<TileData> sliceTileData(const TileData& _data, const TileID& _parent,
+                                        const TileID& _child, float _buffer);
+
+}
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace Tangram {
@@ -58,10 +59,40 @@ struct fastmap {
         return map.end();
     }
 
+    // Note: Inserting or erasing items invalidates references to other items
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        iterator it = std::lower_bound(
+            map.begin(), map.end(), key,
+            [&](const auto& item, const auto& key) {
+                return item.first < key;
+            });
+
+        if (it != map.end() && it->first == key) {
+            return { it, false };
+        }
+
+        it = map.emplace(it, std::piecewise_construct,
+                         std::forward_as_tuple(key),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+        return { it, true };
+    }
+
+    size_t count(const K& key) const {
+        return find(key) == map.end() ? 0 : 1;
+    }
+
     iterator erase(const_iterator position) {
         return map.erase(position);
     }
 
+    size_t erase(const K& key) {
+        auto it = find(key);
+        if (it == map.end()) { return 0; }
+        map.erase(it);
+        return 1;
+    }
+
     iterator begin() { return map.begin(); }
     iterator end() { return map.end(); }
 
@@ -69,10 +100,54 @@ struct fastmap {
     const_iterator end() const { return map.end(); }
 
     size_t size() const { return map.size(); }
+    bool empty() const { return map.empty(); }
 
     void clear() { map.clear(); }
 };
 
+// Sorted vector of unique keys
+template<typename K>
+struct fastset {
+    std::vector<K> keys;
+
+    using const_iterator = typename std::vector<K>::const_iterator;
+
+    bool insert(const K& key) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        if (it != keys.end() && *it == key) { return false; }
+
+        keys.insert(it, key);
+        return true;
+    }
+
+    size_t erase(const K& key) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        if (it == keys.end() || !(*it == key)) { return 0; }
+
+        keys.erase(it);
+        return 1;
+    }
+
+    size_t count(const K& key) const {
+        return std::binary_search(keys.begin(), keys.end(), key) ? 1 : 0;
+    }
+
+    // Restores the order after keys were appended to 'keys' directly,
+    // which is cheaper than insert() for many keys at once
+    void sort() {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    const_iterator begin() const { return keys.begin(); }
+    const_iterator end() const { return keys.end(); }
+
+    size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+
+    void clear() { keys.clear(); }
+};
+
 template<typename T>
 struct fastmap<std::string, T> {
 
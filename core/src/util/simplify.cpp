@@ -0,0 +1,139 @@
+#include "util/simplify.h"
+
+#include "data/propertyItem.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Tangram {
+
+namespace {
+
+// Squared distance of _p to the segment _a -> _b
+float sqSegmentDistance(const Point& _p, const Point& _a, const Point& _b) {
+
+    float x = _a.x;
+    float y = _a.y;
+    float dx = _b.x - x;
+    float dy = _b.y - y;
+
+    if (dx != 0.f || dy != 0.f) {
+        float t = ((_p.x - x) * dx + (_p.y - y) * dy) / (dx * dx + dy * dy);
+        if (t > 1.f) {
+            x = _b.x;
+            y = _b.y;
+        } else if (t > 0.f) {
+            x += dx * t;
+            y += dy * t;
+        }
+    }
+
+    dx = _p.x - x;
+    dy = _p.y - y;
+    return dx * dx + dy * dy;
+}
+
+// Douglas-Peucker without recursion, reusing its buffers for all lines of a tile
+struct Simplifier {
+
+    explicit Simplifier(float _tolerance) : sqTolerance(_tolerance * _tolerance) {}
+
+    float sqTolerance;
+
+    std::vector<uint8_t> keep;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    // Marks the points of the line that are kept and returns their number
+    size_t mark(const Point* _points, uint32_t _count) {
+
+        keep.assign(_count, 0);
+        keep[0] = keep[_count - 1] = 1;
+        size_t kept = 2;
+
+        stack.clear();
+        stack.emplace_back(0, _count - 1);
+
+        while (!stack.empty()) {
+            auto range = stack.back();
+            stack.pop_back();
+
+            float maxDistance = sqTolerance;
+            uint32_t farthest = 0;
+
+            for (uint32_t i = range.first + 1; i < range.second; i++) {
+                float distance = sqSegmentDistance(_points[i], _points[range.first], _points[range.second]);
+                if (distance > maxDistance) {
+                    maxDistance = distance;
+                    farthest = i;
+                }
+            }
+
+            if (farthest > 0) {
+                keep[farthest] = 1;
+                kept++;
+                stack.emplace_back(range.first, farthest);
+                stack.emplace_back(farthest, range.second);
+            }
+        }
+        return kept;
+    }
+
+    // Lines are compacted in place: Kept points only move towards the front
+    size_t simplify(Feature& _feature) {
+
+        if (_feature.geometryType != GeometryType::lines &&
+            _feature.geometryType != GeometryType::polygons) {
+            return 0;
+        }
+
+        // Closed rings need at least four points
+        uint32_t minPoints = _feature.geometryType == GeometryType::polygons ? 4 : 2;
+
+        auto& points = _feature.points;
+        uint32_t read = 0;
+        uint32_t write = 0;
+
+        for (auto& end : _feature.lineEnds) {
+            uint32_t count = end - read;
+
+            if (count > 2 && mark(&points[read], count) >= minPoints) {
+                for (uint32_t i = 0; i < count; i++) {
+                    if (keep[i]) { points[write++] = points[read + i]; }
+                }
+            } else {
+                std::copy(points.begin() + read, points.begin() + end, points.begin() + write);
+                write += count;
+            }
+            read = end;
+            end = write;
+        }
+
+        size_t removed = points.size() - write;
+        points.resize(write);
+        return removed;
+    }
+};
+
+}
+
+size_t simplifyFeature(Feature& _feature, float _tolerance) {
+
+    Simplifier simplifier(_tolerance);
+    return simplifier.simplify(_feature);
+}
+
+void simplifyTileData(TileData& _data, float _tolerance) {
+
+    if (_tolerance <= 0.f) { return; }
+
+    for (auto& layer : _data.layers) {
+        // The decoder of the layer keeps a copy for features decoded later
+        Simplifier simplifier(_tolerance);
+        layer.processGeometry([simplifier](Feature& _feature) mutable {
+            simplifier.simplify(_feature);
+        });
+    }
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "data/tileData.h"
+
+namespace Tangram {
+
+/* Removes the points of the lines and polygon rings of @_feature that are
+ * within @_tolerance of the simplified line, with the Douglas-Peucker
+ * algorithm. @_tolerance is in tile units. Lines keep their end points,
+ * rings that would collapse to less than four points are kept as they are.
+ * Returns the number of removed points. */
+size_t simplifyFeature(Feature& _feature, float _tolerance);
+
+/* Simplifies the features of @_data like simplifyFeature(). Features with
+ * lazily parsed geometry are simplified when they are decoded. */
+void simplifyTileData(TileData& _data, float _tolerance);
+
+}
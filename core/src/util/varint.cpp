@@ -0,0 +1,127 @@
+#include "util/varint.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VARINT_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VARINT_NEON
+#endif
+
+namespace Tangram {
+
+namespace Varint {
+
+// Decodes one varint of at most 5 bytes starting at @_pos.
+// Returns nullptr when it is unterminated or does not fit in 32 bits.
+static inline const uint8_t* decodeOne(const uint8_t* _pos, const uint8_t* _end, uint32_t& _value) {
+
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35 && _pos < _end; shift += 7) {
+        uint8_t byte = *_pos++;
+        if (shift == 28 && byte > 0x0f) { return nullptr; }
+
+        value |= uint32_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            _value = value;
+            return _pos;
+        }
+    }
+    return nullptr;
+}
+
+bool decodeScalar(const uint8_t* _begin, const uint8_t* _end, std::vector<uint32_t>& _out) {
+
+    _out.reserve(_out.size() + (_end - _begin));
+
+    const uint8_t* pos = _begin;
+    while (pos < _end) {
+        uint32_t value;
+        pos = decodeOne(pos, _end, value);
+        if (!pos) { return false; }
+        _out.push_back(value);
+    }
+    return true;
+}
+
+bool decode(const uint8_t* _begin, const uint8_t* _end, std::vector<uint32_t>& _out) {
+
+    // Each byte is at most one value
+    size_t offset = _out.size();
+    _out.resize(offset + (_end - _begin));
+    uint32_t* out = _out.data() + offset;
+
+    const uint8_t* pos = _begin;
+    while (pos < _end) {
+
+#if defined(VARINT_SSE2)
+        if (_end - pos >= 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            int continuation = _mm_movemask_epi8(bytes);
+
+            if (continuation == 0) {
+                // 16 single byte varints: zero-extend to 32 bits
+                __m128i zero = _mm_setzero_si128();
+                __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+                out += 16;
+                pos += 16;
+                continue;
+            }
+
+            // Copy the single byte varints before the first multi byte varint
+            while (!(continuation & 1)) {
+                *out++ = *pos++;
+                continuation >>= 1;
+            }
+        }
+#elif defined(VARINT_NEON)
+        if (_end - pos >= 16) {
+            uint8x16_t bytes = vld1q_u8(pos);
+
+            if (vmaxvq_u8(bytes) < 0x80) {
+                uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+                uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+                vst1q_u32(out + 0, vmovl_u16(vget_low_u16(lo)));
+                vst1q_u32(out + 4, vmovl_u16(vget_high_u16(lo)));
+                vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+                vst1q_u32(out + 12, vmovl_u16(vget_high_u16(hi)));
+                out += 16;
+                pos += 16;
+                continue;
+            }
+        }
+#else
+        if (_end - pos >= 8) {
+            uint64_t bytes;
+            std::memcpy(&bytes, pos, sizeof(bytes));
+
+            if ((bytes & 0x8080808080808080ull) == 0) {
+                for (int i = 0; i < 8; i++) { out[i] = pos[i]; }
+                out += 8;
+                pos += 8;
+                continue;
+            }
+        }
+#endif
+        pos = decodeOne(pos, _end, *out);
+        if (!pos) {
+            _out.resize(out - _out.data());
+            return false;
+        }
+        out++;
+    }
+
+    _out.resize(out - _out.data());
+    return true;
+}
+
+}
+
+}
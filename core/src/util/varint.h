@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+namespace Varint {
+
+/* Appends all varints in [@_begin, @_end) to @_out. Runs of single byte
+ * varints are decoded 16 at a time with SSE2 or NEON where available.
+ *
+ * Only values that fit in 32 bits are accepted, as used by packed fields of
+ * vector tiles. Returns false for longer or unterminated varints; @_out is
+ * left with the values decoded so far. */
+bool decode(const uint8_t* _begin, const uint8_t* _end, std::vector<uint32_t>& _out);
+
+/* Scalar reference of decode(), one varint at a time */
+bool decodeScalar(const uint8_t* _begin, const uint8_t* _end, std::vector<uint32_t>& _out);
+
+inline int32_t zigzag(uint32_t _value) {
+    return static_cast<int32_t>((_value >> 1) ^ -(_value & 1));
+}
+
+}
+
+}
@@ -2,6 +2,9 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <cstdint>
+
 #include <assert.h>
 
 #define CHUNK 16384
@@ -52,5 +55,53 @@ int inflate(const char* _data, size_t _size, std::vector<char>& dst) {
     return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
 }
 
+int deflate(const char* _data, size_t _size, std::vector<char>& dst, int _level) {
+
+    int ret;
+    unsigned char out[CHUNK];
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(z_stream));
+
+    ret = deflateInit2(&strm, _level, Z_DEFLATED, 16+MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) { return ret; }
+
+    strm.avail_in = _size;
+    strm.next_in = (Bytef*)_data;
+
+    do {
+        strm.avail_out = CHUNK;
+        strm.next_out = out;
+
+        ret = deflate(&strm, Z_FINISH);
+
+         /* state not clobbered */
+        assert(ret != Z_STREAM_ERROR);
+
+        size_t have = CHUNK - strm.avail_out;
+        dst.insert(dst.end(), out, out+have);
+
+    } while (ret == Z_OK);
+
+    deflateEnd(&strm);
+
+    return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
+}
+
+bool isGzip(const char* _data, size_t _size) {
+    return _size >= 2 && uint8_t(_data[0]) == 0x1f && uint8_t(_data[1]) == 0x8b;
+}
+
+size_t inflatedSizeHint(const char* _data, size_t _size) {
+    // Header, empty deflate block and trailer
+    if (_size < 20) { return 0; }
+
+    auto trailer = reinterpret_cast<const uint8_t*>(_data + _size - 4);
+    size_t size = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | uint32_t(trailer[3]) << 24;
+
+    // Deflate compresses by 1032:1 at most
+    return std::min(size, _size * 1032);
+}
+
 }
 }
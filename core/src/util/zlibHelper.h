@@ -8,5 +8,17 @@ namespace zlib {
 
 int inflate(const char* _data, size_t _size, std::vector<char>& dst);
 
+// Compresses @_data to gzip format, appended to @dst. @_level trades speed (1)
+// against size (9). Returns Z_OK on success.
+int deflate(const char* _data, size_t _size, std::vector<char>& dst, int _level = 1);
+
+// Whether @_data starts like gzip compressed data
+bool isGzip(const char* _data, size_t _size);
+
+// Estimates the inflated size of gzip @_data from its trailer. This is only
+// a hint: The trailer holds the size of the last member modulo 4 GiB, so
+// it is clamped to what deflate can achieve. Returns 0 for too short data.
+size_t inflatedSizeHint(const char* _data, size_t _size);
+
 }
 }
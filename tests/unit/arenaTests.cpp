@@ -0,0 +1,85 @@
+#include "catch.hpp"
+
+#include "util/arena.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE( "Arena allocations are aligned and taken from chunks", "[Arena]" ) {
+
+    Arena arena(1024);
+    REQUIRE(arena.chunkCount() == 0);
+
+    // Addresses as integers, Catch would print char pointers as strings
+    auto a = reinterpret_cast<uintptr_t>(arena.allocate(3, 1));
+    auto b = reinterpret_cast<uintptr_t>(arena.allocate(8, 8));
+
+    REQUIRE(arena.chunkCount() == 1);
+    REQUIRE((a % alignof(std::max_align_t)) == 0);
+    REQUIRE((b % alignof(std::max_align_t)) == 0);
+    REQUIRE(b > a);
+
+    // Large allocations get their own chunk
+    arena.allocate(4096, 8);
+    REQUIRE(arena.chunkCount() == 2);
+
+    // and the current chunk is still used
+    auto c = reinterpret_cast<uintptr_t>(arena.allocate(8, 8));
+    REQUIRE(c > b);
+    REQUIRE(c < a + 1024);
+    REQUIRE(arena.chunkCount() == 2);
+    REQUIRE(arena.capacity() >= 1024 + 4096);
+}
+
+TEST_CASE( "Containers allocate from the Arena and copy to the heap", "[Arena]" ) {
+
+    Arena arena;
+
+    ArenaVector<int> values{ArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 1000; i++) { values.push_back(i); }
+    REQUIRE(arena.chunkCount() == 1);
+
+    ArenaVector<int> copy(values);
+    REQUIRE(!copy.get_allocator().arena());
+    REQUIRE(copy == values);
+
+    ArenaVector<int> moved(std::move(values));
+    REQUIRE(moved.get_allocator().arena() == &arena);
+    REQUIRE(moved == copy);
+
+    // Move assignment takes over the Arena
+    copy = std::move(moved);
+    REQUIRE(copy.get_allocator().arena() == &arena);
+}
+
+TEST_CASE( "Arena allocations from several threads do not overlap", "[Arena]" ) {
+
+    Arena arena(4096);
+
+    const int numThreads = 4;
+    const int numAllocations = 1000;
+    std::vector<std::vector<uint32_t*>> results(numThreads);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < numAllocations; i++) {
+                auto* p = static_cast<uint32_t*>(arena.allocate(4 * sizeof(uint32_t), alignof(uint32_t)));
+                for (int j = 0; j < 4; j++) { p[j] = t * numAllocations + i; }
+                results[t].push_back(p);
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (int t = 0; t < numThreads; t++) {
+        for (int i = 0; i < numAllocations; i++) {
+            for (int j = 0; j < 4; j++) {
+                REQUIRE(results[t][i][j] == uint32_t(t * numAllocations + i));
+            }
+        }
+    }
+}
@@ -0,0 +1,314 @@
+#include "catch.hpp"
+
+#include "data/clientGeoJsonSource.h"
+#include "data/properties.h"
+#include "data/tileData.h"
+#include "mockPlatform.h"
+#include "tile/tileID.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+static TileID tileAt(LngLat _point, int _z) {
+    double n = 1 << _z;
+    double lat = _point.latitude * M_PI / 180.0;
+    return TileID(int((_point.longitude + 180.0) / 360.0 * n),
+                  int((1.0 - std::log(std::tan(lat) + 1.0 / std::cos(lat)) / M_PI) / 2.0 * n), _z);
+}
+
+TEST_CASE( "Updates of ClientGeoJsonSource change only the generation of affected tiles", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    LngLat berlin(13.4, 52.5);
+    LngLat paris(2.35, 48.85);
+    Properties props;
+
+    source.upsertPoint(7, props, berlin);
+    int64_t added = source.generation();
+
+    REQUIRE(source.generation(tileAt(berlin, 14)) == added);
+    REQUIRE(source.generation(tileAt(berlin, 0)) == added);
+    REQUIRE(source.generation(tileAt(paris, 14)) < added);
+
+    // Moving the feature changes the tiles of the old and the new position
+    source.upsertPoint(7, props, paris);
+    int64_t moved = source.generation();
+
+    REQUIRE(source.generation(tileAt(berlin, 14)) == moved);
+    REQUIRE(source.generation(tileAt(paris, 14)) == moved);
+
+    // New features get IDs that were not used yet
+    uint64_t id = source.addPoint(props, berlin);
+    REQUIRE(id == 8);
+    REQUIRE(source.generation(tileAt(paris, 14)) == moved);
+
+    REQUIRE(source.removeFeature(7));
+    REQUIRE(!source.removeFeature(7));
+    REQUIRE(source.generation(tileAt(paris, 14)) == source.generation());
+
+    // Clearing the source changes all tiles
+    source.clearData();
+    REQUIRE(source.generation(TileID(0, 0, 14)) == source.generation());
+}
+
+TEST_CASE( "ClientGeoJsonSource prunes changes that no tile is older than", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    LngLat berlin(13.4, 52.5);
+    LngLat paris(2.35, 48.85);
+    Properties props;
+
+    source.upsertPoint(7, props, berlin);
+    int64_t added = source.generation();
+
+    source.upsertPoint(8, props, paris);
+    int64_t moved = source.generation();
+
+    // Tiles of generation 'added' or later don't need the first change
+    source.pruneChanges(added);
+    REQUIRE(source.generation(tileAt(berlin, 14)) < added);
+    REQUIRE(source.generation(tileAt(paris, 14)) == moved);
+
+    source.pruneChanges(moved);
+    REQUIRE(source.generation(tileAt(paris, 14)) < added);
+
+    // Later changes are still recorded
+    source.removeFeature(7);
+    REQUIRE(source.generation(tileAt(berlin, 14)) == source.generation());
+    REQUIRE(source.generation(tileAt(paris, 14)) < added);
+}
+
+TEST_CASE( "Upserted GeoJSON features with an ID replace the feature with that ID", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    LngLat berlin(13.4, 52.5);
+    LngLat paris(2.35, 48.85);
+
+    source.upsertData(R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "id": 0, "geometry": { "type": "Point", "coordinates": [13.4, 52.5] } } ] })");
+    int64_t added = source.generation();
+
+    // The feature is moved, not added
+    source.upsertData(R"({ "type": "Feature", "id": 0, "geometry": { "type": "Point", "coordinates": [2.35, 48.85] } })");
+    int64_t moved = source.generation();
+    REQUIRE(source.generation(tileAt(berlin, 14)) == moved);
+
+    // GeoJSON IDs do not refer to features added otherwise
+    uint64_t id = source.addPoint(Properties(), berlin);
+    REQUIRE(id != 0);
+    source.upsertData(R"({ "type": "Feature", "id": )" + std::to_string(id) +
+                      R"(, "geometry": { "type": "Point", "coordinates": [-74.0, 40.7] } })");
+    REQUIRE(source.generation(tileAt(berlin, 14)) < source.generation());
+    REQUIRE(source.removeFeature(id));
+
+    // With empty geometry the feature is removed
+    source.upsertData(R"({ "type": "Feature", "id": 0, "geometry": { "type": "Point", "coordinates": [] } })");
+    REQUIRE(source.generation(tileAt(paris, 14)) == source.generation());
+    REQUIRE(source.generation(tileAt(paris, 14)) > added);
+
+    // Invalid data does not change the source
+    int64_t generation = source.generation();
+    source.upsertData(R"({ "type": "Feature", )");
+    REQUIRE(source.generation() == generation);
+}
+
+TEST_CASE( "Added GeoJSON features with the same ID are all kept", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    LngLat berlin(13.4, 52.5);
+
+    source.addData(R"({ "type": "Feature", "id": 3, "geometry": { "type": "Point", "coordinates": [13.4, 52.5] } })");
+    int64_t added = source.generation();
+
+    source.addData(R"({ "type": "Feature", "id": 3, "geometry": { "type": "Point", "coordinates": [2.35, 48.85] } })");
+    REQUIRE(source.generation(tileAt(berlin, 14)) == added);
+
+    REQUIRE(source.removeFeature(0));
+    REQUIRE(source.removeFeature(1));
+    REQUIRE(!source.removeFeature(3));
+}
+
+TEST_CASE( "Add GeoJSON to ClientGeoJsonSource on a background thread", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    source.upsertData(R"({ "type": "Feature", "id": 1, "geometry": { "type": "Point", "coordinates": [13.4, 52.5] } })");
+
+    std::promise<std::pair<bool, int64_t>> added;
+    source.upsertDataAsync(R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "id": 1, "geometry": { "type": "Point", "coordinates": [2.35, 48.85] } },
+        { "type": "Feature", "geometry": { "type": "LineString", "coordinates": [[0, 0], [1, 1]] } } ] })",
+        [&](bool _success, int64_t _generation) { added.set_value({ _success, _generation }); });
+
+    auto result = added.get_future().get();
+    REQUIRE(result.first);
+    REQUIRE(result.second == source.generation());
+    REQUIRE(source.generation(tileAt(LngLat(13.4, 52.5), 14)) == result.second);
+
+    // The first feature was moved and the line got a new ID
+    REQUIRE(source.removeFeature(0));
+    REQUIRE(source.removeFeature(1));
+    REQUIRE(!source.removeFeature(2));
+
+    std::promise<bool> failed;
+    source.addDataAsync("{", [&](bool _success, int64_t _generation) { failed.set_value(_success); });
+    REQUIRE(!failed.get_future().get());
+}
+
+TEST_CASE( "Add GeoJSON on a background thread while features are updated", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    std::string json = R"({ "type": "FeatureCollection", "features": [)";
+    for (int i = 0; i < 5000; i++) {
+        if (i > 0) { json += ","; }
+        json += R"({ "type": "Feature", "id": )" + std::to_string(1000 + i) +
+            R"(, "geometry": { "type": "Point", "coordinates": [)" +
+            std::to_string(-170.0 + i * 0.068) + ", 52.5] } }";
+    }
+    json += "] }";
+
+    std::promise<bool> added;
+    auto done = added.get_future();
+    source.upsertDataAsync(json, [&](bool _success, int64_t _generation) { added.set_value(_success); });
+
+    // Updates of the same grid cells while the batch is indexed
+    uint64_t updates = 0;
+    while (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        source.upsertPoint(updates % 100, Properties(), LngLat(13.0 + (updates % 100) * 0.01, 52.5));
+        updates++;
+    }
+    REQUIRE(done.get());
+
+    for (uint64_t id = 0; id < std::min<uint64_t>(updates, 100); id++) {
+        REQUIRE(source.removeFeature(id));
+    }
+    // The GeoJSON features got IDs that were not used by the updates
+    size_t removed = 0;
+    for (uint64_t id = 100; id < 5100 + 100; id++) {
+        if (source.removeFeature(id)) { removed++; }
+    }
+    REQUIRE(removed == 5000);
+}
+
+struct ParsedClientGeoJsonSource : ClientGeoJsonSource {
+    using ClientGeoJsonSource::ClientGeoJsonSource;
+    using ClientGeoJsonSource::parse;
+};
+
+TEST_CASE( "Parse tiles of ClientGeoJsonSource while features are updated", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    auto source = std::make_shared<ParsedClientGeoJsonSource>(platform, "test", "");
+    MercatorProjection projection;
+
+    LngLat berlin(13.4, 52.5);
+    for (uint64_t id = 0; id < 100; id++) {
+        source->upsertPoint(id, Properties(), LngLat(berlin.longitude + id * 0.0001, berlin.latitude));
+    }
+
+    // Indexes are built by the parsing threads while the features change
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    std::vector<size_t> parsed(4, 0);
+    for (size_t t = 0; t < parsed.size(); t++) {
+        threads.emplace_back([&, t]() {
+            auto task = source->createTask(tileAt(berlin, 10 + t), -1);
+            while (!done) {
+                auto data = source->parse(*task, projection);
+                if (data && !data->layers.front().features.empty()) { parsed[t]++; }
+            }
+        });
+    }
+
+    for (uint64_t i = 0; i < 2000; i++) {
+        source->upsertPoint(i % 100, Properties(), LngLat(berlin.longitude + (i % 7) * 0.0001, berlin.latitude));
+    }
+    done = true;
+    for (auto& thread : threads) { thread.join(); }
+
+    auto task = source->createTask(tileAt(berlin, 14), -1);
+    auto data = source->parse(*task, projection);
+    REQUIRE(data);
+    REQUIRE(data->layers.front().features.size() == 100);
+    for (size_t count : parsed) { REQUIRE(count > 0); }
+}
+
+TEST_CASE( "Add features to ClientGeoJsonSource from columns", "[ClientGeoJsonSource]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    ClientGeoJsonSource source(platform, "test", "");
+
+    source.addPoint(Properties(), LngLat(0, 0));
+
+    // A polygon with a hole, an empty feature and a multipolygon
+    double coordinates[] = {
+        13.0, 52.0,  14.0, 52.0,  14.0, 53.0,  13.0, 52.0,
+        13.2, 52.2,  13.4, 52.2,  13.4, 52.4,  13.2, 52.2,
+        2.0, 48.0,  3.0, 48.0,  3.0, 49.0,  2.0, 48.0,
+        -74.0, 40.0,  -73.0, 40.0,  -73.0, 41.0,  -74.0, 40.0,
+    };
+    uint32_t lineEnds[] = { 4, 8, 12, 16 };
+    uint32_t polygonEnds[] = { 2, 3, 4 };
+    uint32_t featureEnds[] = { 1, 1, 3 };
+    double heights[] = { 10, 20, NAN };
+    const char* kinds[] = { "building", nullptr, "park" };
+
+    ClientGeoJsonSource::FeatureColumns columns;
+    columns.type = ClientGeoJsonSource::FeatureColumns::Type::polygons;
+    columns.featureCount = 3;
+    columns.coordinates = coordinates;
+    columns.lineEnds = lineEnds;
+    columns.polygonEnds = polygonEnds;
+    columns.featureEnds = featureEnds;
+    columns.numbers.push_back({ "height", heights });
+    columns.strings.push_back({ "kind", kinds });
+
+    uint64_t first = source.addFeatures(columns);
+    int64_t added = source.generation();
+    REQUIRE(first == 1);
+
+    REQUIRE(source.generation(tileAt(LngLat(13.5, 52.5), 14)) == added);
+    REQUIRE(source.generation(tileAt(LngLat(2.5, 48.5), 10)) == added);
+    REQUIRE(source.generation(tileAt(LngLat(-73.5, 40.5), 10)) == added);
+    REQUIRE(source.generation(tileAt(LngLat(100, 0), 10)) < added);
+
+    // The empty feature is not added, but its ID is used
+    REQUIRE(source.removeFeature(1));
+    REQUIRE(!source.removeFeature(2));
+    REQUIRE(source.addPoint(Properties(), LngLat(0, 0)) == 4);
+
+    // Replace the multipolygon by a point
+    double point[] = { 100.0, 0.0 };
+    uint32_t pointEnds[] = { 1 };
+    uint64_t ids[] = { 3 };
+
+    ClientGeoJsonSource::FeatureColumns points;
+    points.featureCount = 1;
+    points.coordinates = point;
+    points.featureEnds = pointEnds;
+
+    source.upsertFeatures(ids, points);
+    REQUIRE(source.generation(tileAt(LngLat(100, 0), 10)) == source.generation());
+    REQUIRE(source.generation(tileAt(LngLat(-73.5, 40.5), 10)) == source.generation());
+    REQUIRE(source.removeFeature(3));
+}
@@ -0,0 +1,161 @@
+#include "catch.hpp"
+
+#include "data/propertyItem.h"
+#include "util/clip.h"
+
+using namespace Tangram;
+
+static const ClipBox s_unitBox{ {0.f, 0.f}, {1.f, 1.f} };
+
+TEST_CASE( "Clip a line that leaves and enters the box", "[Clip]" ) {
+
+    Line line = { {-0.5f, 0.5f, 0.f}, {0.5f, 0.5f, 0.f}, {0.5f, 1.5f, 0.f},
+                  {0.75f, 1.5f, 0.f}, {0.75f, 0.25f, 0.f} };
+
+    Feature feature;
+    clipLine(line, s_unitBox, feature);
+
+    auto out = feature.lines();
+    REQUIRE(out.size() == 2);
+
+    REQUIRE(out[0].size() == 3);
+    REQUIRE(out[0][0] == Point(0.f, 0.5f, 0.f));
+    REQUIRE(out[0][1] == Point(0.5f, 0.5f, 0.f));
+    REQUIRE(out[0][2] == Point(0.5f, 1.f, 0.f));
+
+    REQUIRE(out[1].size() == 2);
+    REQUIRE(out[1][0] == Point(0.75f, 1.f, 0.f));
+    REQUIRE(out[1][1] == Point(0.75f, 0.25f, 0.f));
+
+    // Outside
+    feature.clearGeometry();
+    clipLine(Line{ {2.f, 0.f, 0.f}, {2.f, 1.f, 0.f} }, s_unitBox, feature);
+    REQUIRE(feature.lines().empty());
+    REQUIRE(feature.points.empty());
+}
+
+TEST_CASE( "Clip a closed ring", "[Clip]" ) {
+
+    Line ring = { {-1.f, -1.f, 0.f}, {0.5f, -1.f, 0.f}, {0.5f, 0.5f, 0.f},
+                  {-1.f, 0.5f, 0.f}, {-1.f, -1.f, 0.f} };
+
+    Line out;
+    clipRing(ring, s_unitBox, out);
+
+    REQUIRE(out.size() == 5);
+    REQUIRE(out.front() == out.back());
+    for (auto& p : out) {
+        REQUIRE(s_unitBox.contains(p));
+    }
+
+    // Polygon with the outer ring outside of the box
+    Feature polygon;
+    polygon.addPolygon(Polygon{ { {2.f, 2.f, 0.f}, {3.f, 2.f, 0.f}, {3.f, 3.f, 0.f}, {2.f, 2.f, 0.f} } });
+    Feature clipped;
+    REQUIRE(!clipPolygon(polygon.polygons()[0], s_unitBox, clipped));
+    REQUIRE(clipped.polygons().empty());
+    REQUIRE(clipped.points.empty());
+
+    // Polygon with a hole
+    polygon.clearGeometry();
+    polygon.addPolygon(Polygon{ ring, { {0.1f, 0.1f, 0.f}, {0.1f, 0.2f, 0.f}, {0.2f, 0.2f, 0.f}, {0.1f, 0.1f, 0.f} } });
+    REQUIRE(clipPolygon(polygon.polygons()[0], s_unitBox, clipped));
+    REQUIRE(clipped.polygons().size() == 1);
+    REQUIRE(clipped.polygons()[0].size() == 2);
+    REQUIRE(clipped.polygons()[0][0].size() == 5);
+    REQUIRE(clipped.polygons()[0][1].size() == 4);
+    REQUIRE(clipped.polygons()[0].pointCount() == 9);
+}
+
+TEST_CASE( "Slice TileData of a parent into a child tile", "[Clip]" ) {
+
+    TileData data;
+    data.layers.emplace_back("layer");
+
+    Feature line;
+    line.geometryType = GeometryType::lines;
+    line.addLine(Line{ {0.f, 0.25f, 0.f}, {1.f, 0.25f, 0.f} });
+    line.props.set("name", "south");
+    data.layers[0].features.push_back(line);
+
+    Feature point;
+    point.geometryType = GeometryType::points;
+    point.points.push_back({ 0.75f, 0.75f, 0.f });
+    data.layers[0].features.push_back(point);
+
+    // South-west child: Row 1 from north
+    TileID parent(10, 20, 5);
+    TileID child(20, 41, 6);
+
+    auto sliced = sliceTileData(data, parent, child, 0.f);
+    REQUIRE(sliced);
+    REQUIRE(sliced->layers.size() == 1);
+
+    auto& features = sliced->layers[0].features;
+    REQUIRE(features.size() == 1);
+    REQUIRE(features[0].props.getString("name") == "south");
+    REQUIRE(features[0].lines().size() == 1);
+    REQUIRE(features[0].lines()[0][0] == Point(0.f, 0.5f, 0.f));
+    REQUIRE(features[0].lines()[0][1] == Point(1.f, 0.5f, 0.f));
+
+    // North-east child
+    sliced = sliceTileData(data, parent, TileID(21, 40, 6), 0.f);
+    REQUIRE(sliced->layers[0].features.size() == 1);
+    REQUIRE(sliced->layers[0].features[0].points[0] == Point(0.5f, 0.5f, 0.f));
+
+    // Not a child
+    REQUIRE(!sliceTileData(data, parent, TileID(0, 0, 6), 0.f));
+}
+
+// Adds a line from (-1, 0.5) to (2, 0.5)
+struct LineDecoder : public GeometryDecoder {
+    void decode(const char* _data, size_t _size, Feature& _feature) const override {
+        _feature.addLine(Line{ {-1.f, 0.5f, 0.f}, {2.f, 0.5f, 0.f} });
+    }
+};
+
+TEST_CASE( "Clip TileData to the tile and a buffer", "[Clip]" ) {
+
+    auto arena = std::make_shared<Arena>();
+
+    TileData data;
+    data.arena = arena;
+    data.layers.emplace_back("layer");
+    data.layers.emplace_back("lazy");
+    auto& features = data.layers[0].features;
+    features.reserve(3);
+
+    features.emplace_back(0, arena.get());
+    features.back().geometryType = GeometryType::lines;
+    features.back().addLine(Line{ {-1.f, 0.25f, 0.f}, {2.f, 0.25f, 0.f} });
+
+    features.emplace_back(0, arena.get());
+    features.back().geometryType = GeometryType::polygons;
+    features.back().addPolygon(Polygon{ { {2.f, 2.f, 0.f}, {3.f, 2.f, 0.f}, {3.f, 3.f, 0.f}, {2.f, 2.f, 0.f} } });
+
+    features.emplace_back(0, arena.get());
+    features.back().geometryType = GeometryType::points;
+    features.back().points.push_back({ 1.05f, 0.5f, 0.f });
+
+    data.layers[1].decoder = std::make_shared<LineDecoder>();
+    Feature lazy;
+    lazy.geometryType = GeometryType::lines;
+    lazy.encoded.decoder = data.layers[1].decoder.get();
+    data.layers[1].features.push_back(lazy);
+
+    clipTileData(data, 0.1f);
+
+    REQUIRE(features.size() == 2);
+    REQUIRE(features[0].lines().size() == 1);
+    REQUIRE(features[0].lines()[0][0].x == Approx(-0.1f));
+    REQUIRE(features[0].lines()[0][1].x == Approx(1.1f));
+    REQUIRE(features[0].points.get_allocator().arena() == arena.get());
+    REQUIRE(features[1].points.size() == 1);
+
+    // Clipped when decoded
+    auto& decoded = data.layers[1].features[0];
+    REQUIRE(decoded.points.empty());
+    decoded.decodeGeometry();
+    REQUIRE(decoded.lines().size() == 1);
+    REQUIRE(decoded.lines()[0][1].x == Approx(1.1f));
+}
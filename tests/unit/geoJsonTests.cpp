@@ -0,0 +1,182 @@
+#include "catch.hpp"
+
+#include "data/formats/geoJson.h"
+#include "data/propertyItem.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+using FeatureData = GeoJson::FeatureData;
+
+struct ReadResult {
+    std::vector<std::string> layers;
+    std::vector<FeatureData> features;
+    bool ok = false;
+};
+
+static ReadResult read(const char* _json) {
+    ReadResult result;
+    const char* error;
+    size_t offset;
+    result.ok = GeoJson::read(_json, std::strlen(_json),
+                              [&](const std::string& _name) { result.layers.push_back(_name); },
+                              [&](FeatureData& _feature) {
+                                  result.features.push_back(_feature);
+                                  return true;
+                              },
+                              &error, &offset);
+    return result;
+}
+
+static Point identity(glm::dvec2 _lonLat) { return { _lonLat.x, _lonLat.y, 0 }; }
+
+TEST_CASE( "Read the features of a FeatureCollection", "[GeoJson]" ) {
+
+    auto result = read(R"({
+        "type": "FeatureCollection",
+        "features": [
+            { "type": "Feature",
+              "geometry": { "type": "Point", "coordinates": [1, 2, 3] },
+              "properties": { "name": "a", "rank": 4, "open": true, "tags": { "x": 1 }, "none": null } },
+            { "type": "Feature",
+              "properties": { "name": "b" },
+              "geometry": { "coordinates": [[0, 0], [1, 1], [2, 0]], "type": "LineString" } },
+            { "type": "Feature",
+              "geometry": null,
+              "properties": {} }
+        ]
+    })");
+
+    REQUIRE(result.ok);
+    REQUIRE(result.layers == std::vector<std::string>{ "" });
+    REQUIRE(result.features.size() == 2);
+
+    auto& point = result.features[0];
+    REQUIRE(point.type == FeatureData::Type::point);
+    REQUIRE(point.coordinates.size() == 1);
+    REQUIRE(point.coordinates[0] == glm::dvec2(1, 2));
+
+    Properties props = GeoJson::getProperties(std::move(point.properties), 0);
+    REQUIRE(props.getString("name") == "a");
+    REQUIRE(props.getNumber("rank") == 4);
+    REQUIRE(props.getNumber("open") == 1);
+    REQUIRE(!props.contains("tags"));
+    REQUIRE(!props.contains("none"));
+
+    // Coordinates before the geometry type
+    auto& line = result.features[1];
+    REQUIRE(line.type == FeatureData::Type::lineString);
+    REQUIRE(line.coordinates.size() == 3);
+    REQUIRE(line.lineEnds == std::vector<uint32_t>{ 3 });
+}
+
+TEST_CASE( "Read named FeatureCollections as layers", "[GeoJson]" ) {
+
+    auto result = read(R"({
+        "water": { "type": "FeatureCollection", "features": [
+            { "type": "Feature", "geometry": { "type": "Point", "coordinates": [0, 0] } } ] },
+        "roads": { "type": "FeatureCollection", "features": [
+            { "type": "Feature", "geometry": { "type": "Point", "coordinates": [1, 1] } },
+            { "type": "Feature", "geometry": { "type": "Point", "coordinates": [2, 2] } } ] }
+    })");
+
+    REQUIRE(result.ok);
+    REQUIRE(result.layers == (std::vector<std::string>{ "water", "roads" }));
+    REQUIRE(result.features.size() == 3);
+}
+
+TEST_CASE( "Read polygons into flat geometry", "[GeoJson]" ) {
+
+    auto result = read(R"({
+        "type": "MultiPolygon",
+        "coordinates": [
+            [ [[0, 0], [4, 0], [4, 4], [0, 4], [0, 0]],
+              [[1, 1], [1, 2], [2, 2], [1, 1]] ],
+            [ [[5, 5], [6, 5], [6, 6], [5, 5]] ]
+        ]
+    })");
+
+    REQUIRE(result.ok);
+    REQUIRE(result.layers == std::vector<std::string>{ "" });
+    REQUIRE(result.features.size() == 1);
+
+    auto& data = result.features[0];
+    REQUIRE(data.type == FeatureData::Type::multiPolygon);
+    REQUIRE(data.lineEnds == (std::vector<uint32_t>{ 5, 9, 13 }));
+    REQUIRE(data.polygonEnds == (std::vector<uint32_t>{ 2, 3 }));
+
+    Feature feature;
+    GeoJson::setGeometry(data, identity, feature);
+
+    REQUIRE(feature.geometryType == GeometryType::polygons);
+    auto polygons = feature.polygons();
+    REQUIRE(polygons.size() == 2);
+    REQUIRE(polygons[0].size() == 2);
+    REQUIRE(polygons[0][1].size() == 4);
+    REQUIRE(polygons[1][0].front() == Point(5, 5, 0));
+}
+
+TEST_CASE( "Read a single Feature with the type after its geometry", "[GeoJson]" ) {
+
+    auto result = read(R"({
+        "geometry": { "type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]] },
+        "properties": { "kind": "park" },
+        "type": "Feature"
+    })");
+
+    REQUIRE(result.ok);
+    REQUIRE(result.features.size() == 1);
+    REQUIRE(result.features[0].type == FeatureData::Type::polygon);
+    REQUIRE(result.features[0].polygonEnds == std::vector<uint32_t>{ 1 });
+    REQUIRE(result.features[0].properties.size() == 1);
+}
+
+TEST_CASE( "Read geometry with empty arrays before the first position", "[GeoJson]" ) {
+
+    auto result = read(R"({
+        "type": "FeatureCollection",
+        "features": [
+            { "type": "Feature",
+              "geometry": { "type": "MultiLineString", "bbox": [],
+                            "coordinates": [[], [[0, 0], [1, 1]], [[2, 2], [3, 3], [4, 4]]] } },
+            { "type": "Feature",
+              "geometry": { "type": "MultiPolygon",
+                            "coordinates": [[], [[[0, 0], [1, 0], [1, 1], [0, 0]]]] } }
+        ]
+    })");
+
+    REQUIRE(result.ok);
+    REQUIRE(result.features.size() == 2);
+
+    auto& lines = result.features[0];
+    REQUIRE(lines.coordinates.size() == 5);
+    REQUIRE(lines.coordinates[2] == glm::dvec2(2, 2));
+    REQUIRE(lines.lineEnds == (std::vector<uint32_t>{ 2, 5 }));
+
+    auto& polygons = result.features[1];
+    REQUIRE(polygons.coordinates.size() == 4);
+    REQUIRE(polygons.lineEnds == std::vector<uint32_t>{ 4 });
+    REQUIRE(polygons.polygonEnds == std::vector<uint32_t>{ 1 });
+}
+
+TEST_CASE( "Stop reading on invalid JSON or when requested", "[GeoJson]" ) {
+
+    const char* error;
+    size_t offset;
+    const char* json = R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "geometry": { "type": "Point", "coordinates": [0, 0] } },
+        { "type": "Feature", "geometry": { "type": "Point", "coordinates": [1, 1] } } ] })";
+
+    int count = 0;
+    bool ok = GeoJson::read(json, std::strlen(json), [](const std::string&) {},
+                            [&](FeatureData&) { return ++count < 1; },
+                            &error, &offset);
+    REQUIRE(!ok);
+    REQUIRE(count == 1);
+
+    auto result = read(R"({ "type": "FeatureCollection", "features": [ { )");
+    REQUIRE(!result.ok);
+}
@@ -0,0 +1,154 @@
+#include "catch.hpp"
+
+#include "data/memoryCacheDataSource.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+#include "util/zlibHelper.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Tangram;
+
+// Provides a copy of @payload for any tile
+struct TestDataSource : TileSource::DataSource {
+    std::vector<char> payload;
+    int loads = 0;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loads++;
+        static_cast<BinaryTileTask&>(*_task).rawTileData = std::make_shared<std::vector<char>>(payload);
+        _cb.func(_task);
+        return true;
+    }
+};
+
+// Records the data it is asked to parse
+struct TestTileSource : TileSource {
+    using TileSource::TileSource;
+
+    mutable std::vector<char> parsed;
+
+    std::shared_ptr<TileData> parse(const TileTask& _task, const MapProjection& _projection) const override {
+        parsed = *static_cast<const BinaryTileTask&>(_task).rawTileData;
+        return std::make_shared<TileData>();
+    }
+};
+
+struct CompressedCacheContext {
+    TestDataSource* dataSource;
+    std::shared_ptr<TestTileSource> source;
+
+    CompressedCacheContext(std::vector<char> _payload) {
+        auto cache = std::make_unique<MemoryCacheDataSource>();
+        cache->setCacheSize(1024 * 1024);
+        cache->setCompression(true);
+
+        auto next = std::make_unique<TestDataSource>();
+        next->payload = std::move(_payload);
+        dataSource = next.get();
+        cache->setNext(std::move(next));
+
+        source = std::make_shared<TestTileSource>("test", std::move(cache));
+    }
+
+    std::shared_ptr<BinaryTileTask> load(TileID _tileID) {
+        auto task = source->createTask(_tileID);
+        source->loadTileData(task, {[](std::shared_ptr<TileTask>) {}});
+        return std::static_pointer_cast<BinaryTileTask>(task);
+    }
+};
+
+std::vector<char> makePayload() {
+    std::vector<char> payload;
+    for (int i = 0; i < 10000; i++) { payload.push_back(char(i % 16)); }
+    return payload;
+}
+
+TEST_CASE( "Compress and inflate tile data with zlib", "[zlib]" ) {
+
+    auto payload = makePayload();
+
+    std::vector<char> compressed;
+    REQUIRE(zlib::deflate(payload.data(), payload.size(), compressed) == 0);
+    REQUIRE(zlib::isGzip(compressed.data(), compressed.size()));
+    REQUIRE(compressed.size() < payload.size());
+    REQUIRE_FALSE(zlib::isGzip(payload.data(), payload.size()));
+
+    std::vector<char> inflated;
+    REQUIRE(zlib::inflate(compressed.data(), compressed.size(), inflated) == 0);
+    REQUIRE(inflated == payload);
+
+    REQUIRE(zlib::inflatedSizeHint(compressed.data(), compressed.size()) == payload.size());
+    REQUIRE(zlib::inflatedSizeHint(compressed.data(), 10) == 0);
+
+    // The trailer is only a hint: Sizes deflate cannot achieve are clamped
+    std::vector<char> invalid(compressed.begin(), compressed.end());
+    invalid.back() = char(0xff);
+    REQUIRE(zlib::inflatedSizeHint(invalid.data(), invalid.size()) == invalid.size() * 1032);
+}
+
+TEST_CASE( "Keep tile data compressed in the memory cache", "[MemoryCacheDataSource]" ) {
+
+    auto payload = makePayload();
+    CompressedCacheContext ctx(payload);
+
+    auto miss = ctx.load(TileID(0, 0, 1));
+    auto hit = ctx.load(TileID(0, 0, 1));
+    REQUIRE(ctx.dataSource->loads == 1);
+
+    // The loading task keeps the data as delivered, a hit gets the cached
+    // data which is inflated when parsed
+    REQUIRE_FALSE(miss->compressed);
+    REQUIRE(*miss->rawTileData == payload);
+    REQUIRE(hit->compressed);
+    size_t cachedSize = hit->rawTileData->size();
+    REQUIRE(cachedSize < payload.size());
+
+    MercatorProjection projection;
+    REQUIRE(hit->parse(projection));
+    REQUIRE(ctx.source->parsed == payload);
+    REQUIRE_FALSE(hit->compressed);
+    // Same data for the disk cache key
+    REQUIRE(*hit->rawTileData == *miss->rawTileData);
+
+    auto stats = ctx.source->rawCacheStats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.hitRate() == 0.5f);
+    REQUIRE(stats.entries == 1);
+    REQUIRE(stats.usage == cachedSize);
+    REQUIRE(stats.inflatedUsage == payload.size());
+    REQUIRE(stats.entriesPerMB() > 1024 * 1024 / payload.size());
+
+    REQUIRE(ctx.source->releaseRawData() == stats.usage);
+    REQUIRE(ctx.source->rawCacheStats().inflatedUsage == 0);
+}
+
+TEST_CASE( "Keep tile data as delivered when it is compressed", "[MemoryCacheDataSource]" ) {
+
+    auto payload = makePayload();
+    std::vector<char> compressed;
+    zlib::deflate(payload.data(), payload.size(), compressed, 9);
+
+    CompressedCacheContext ctx(compressed);
+
+    ctx.load(TileID(0, 0, 1));
+    auto hit = ctx.load(TileID(0, 0, 1));
+
+    REQUIRE(hit->compressed);
+    REQUIRE(*hit->rawTileData == compressed);
+    REQUIRE(ctx.source->rawCacheStats().inflatedUsage == payload.size());
+
+    MercatorProjection projection;
+    REQUIRE(hit->parse(projection));
+    REQUIRE(ctx.source->parsed == payload);
+
+    // Invalid data is not parsed
+    auto invalid = ctx.load(TileID(0, 0, 1));
+    invalid->rawTileData = std::make_shared<std::vector<char>>(compressed.begin(), compressed.begin() + 20);
+    REQUIRE_FALSE(invalid->parse(projection));
+    REQUIRE(invalid->isCanceled());
+}
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include "data/memoryCacheDataSource.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Tangram;
+
+// Provides 100 bytes of data for any tile
+struct TestDataSource : TileSource::DataSource {
+    int loads = 0;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loads++;
+        static_cast<BinaryTileTask&>(*_task).rawTileData = std::make_shared<std::vector<char>>(100);
+        _cb.func(_task);
+        return true;
+    }
+};
+
+struct MemoryReleaseContext {
+    TestDataSource* dataSource;
+    std::shared_ptr<TileSource> source;
+
+    MemoryReleaseContext() {
+        auto cache = std::make_unique<MemoryCacheDataSource>();
+        cache->setCacheSize(1024);
+
+        auto next = std::make_unique<TestDataSource>();
+        dataSource = next.get();
+        cache->setNext(std::move(next));
+
+        source = std::make_shared<TileSource>("test", std::move(cache));
+    }
+
+    void load(TileID _tileID) {
+        source->loadTileData(source->createTask(_tileID), {[](std::shared_ptr<TileTask>) {}});
+    }
+};
+
+TEST_CASE( "Release raw tile data without invalidating tiles", "[TileSource][MemoryWarning]" ) {
+
+    MemoryReleaseContext ctx;
+
+    ctx.load(TileID(0, 0, 1));
+    ctx.load(TileID(1, 0, 1));
+    REQUIRE(ctx.dataSource->loads == 2);
+
+    // Loaded from the cache
+    ctx.load(TileID(0, 0, 1));
+    REQUIRE(ctx.dataSource->loads == 2);
+
+    int64_t generation = ctx.source->generation();
+
+    REQUIRE(ctx.source->releaseRawData() == 200);
+    REQUIRE(ctx.source->releaseRawData() == 0);
+    REQUIRE(ctx.source->generation() == generation);
+
+    ctx.load(TileID(0, 0, 1));
+    REQUIRE(ctx.dataSource->loads == 3);
+}
+
+TEST_CASE( "Release parsed tile data that is not in use", "[TileSource][MemoryWarning]" ) {
+
+    MemoryReleaseContext ctx;
+    ctx.source->setTileDataSlicing(4);
+
+    auto makeData = []() {
+        auto data = std::make_shared<TileData>();
+        data->layers.emplace_back("layer");
+        data->layers.back().features.emplace_back();
+        data->layers.back().features.back().points.resize(10);
+        return data;
+    };
+
+    auto task = ctx.source->createTask(TileID(0, 0, 1));
+    auto data = makeData();
+    ctx.source->cacheTileData(*task, data);
+    ctx.source->cacheTileData(*ctx.source->createTask(TileID(1, 0, 1)), makeData());
+
+    // Only the data that is not referenced elsewhere is released
+    REQUIRE(ctx.source->releaseTileData() == sizeof(Feature) + 10 * sizeof(Point));
+
+    REQUIRE(ctx.source->releaseTileData() == 0);
+    REQUIRE(ctx.source->releaseRasters() == 0);
+}
@@ -27,6 +27,7 @@ struct TestMesh : public Mesh<Vertex> {
 
     int numVertices() const { return m_nVertices; }
     int numIndices() const { return m_nIndices; }
+    const GLushort* indices() const { return m_glIndexData; }
 };
 
 std::shared_ptr<TestMesh> newMesh(unsigned int size) {
@@ -170,3 +171,35 @@ TEST_CASE( "Check overflow", "[Core][TypedMesh]" ) {
 
     checkBounds(mesh);
 }
+
+TEST_CASE( "Appended MeshData compiles like sequentially built MeshData", "[Core][TypedMesh]" ) {
+    MeshData<Vertex> sequential, first, second;
+
+    // Three quads, each with indices relative to its own vertices
+    for (int i = 0; i < 3; i++) {
+        auto& part = (i == 0) ? first : second;
+        for (auto* data : { &sequential, &part }) {
+            for (int v = 0; v < 4; v++) { data->vertices.push_back({float(i), float(v), 0, 0}); }
+            for (uint16_t index : { 0, 1, 2, 0, 2, 3 }) { data->indices.push_back(index); }
+            data->offsets.emplace_back(6, 4);
+        }
+    }
+
+    first.append(second);
+
+    REQUIRE(second.vertices.empty());
+    REQUIRE(second.offsets.empty());
+
+    auto expected = std::make_shared<TestMesh>(layout, GL_TRIANGLES);
+    expected->compile(sequential);
+
+    auto merged = std::make_shared<TestMesh>(layout, GL_TRIANGLES);
+    merged->compile(first);
+
+    REQUIRE(merged->numVertices() == expected->numVertices());
+    REQUIRE(merged->numIndices() == expected->numIndices());
+
+    for (int i = 0; i < expected->numIndices(); i++) {
+        REQUIRE(merged->indices()[i] == expected->indices()[i]);
+    }
+}
@@ -0,0 +1,305 @@
+#include "catch.hpp"
+
+#include "data/formats/mvt.h"
+#include "data/propertyItem.h"
+#include "util/geom.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+// Minimal protobuf writer for vector tiles
+struct PbfWriter {
+    std::vector<char> data;
+
+    void varint(uint64_t _value) {
+        while (_value >= 0x80) {
+            data.push_back(char((_value & 0x7f) | 0x80));
+            _value >>= 7;
+        }
+        data.push_back(char(_value));
+    }
+    void key(uint32_t _tag, uint32_t _type) { varint((_tag << 3) | _type); }
+
+    void bytes(uint32_t _tag, const std::vector<char>& _bytes) {
+        key(_tag, 2);
+        varint(_bytes.size());
+        data.insert(data.end(), _bytes.begin(), _bytes.end());
+    }
+    void string(uint32_t _tag, const std::string& _string) {
+        bytes(_tag, std::vector<char>(_string.begin(), _string.end()));
+    }
+    void packed(uint32_t _tag, const std::vector<uint32_t>& _values) {
+        PbfWriter packed;
+        for (auto value : _values) { packed.varint(value); }
+        bytes(_tag, packed.data);
+    }
+};
+
+static uint32_t command(uint32_t _cmd, uint32_t _count) { return _cmd | (_count << 3); }
+static uint32_t zigzag(int32_t _value) { return (uint32_t(_value) << 1) ^ uint32_t(_value >> 31); }
+
+static std::vector<char> feature(uint32_t _type, std::vector<uint32_t> _geometry, uint32_t _value) {
+    PbfWriter feature;
+    feature.packed(2, { 0, _value });
+    feature.key(3, 0);
+    feature.varint(_type);
+    feature.packed(4, _geometry);
+    return feature.data;
+}
+
+// Layer with a point, a line and two polygons with holes
+static std::vector<char> makeLayer() {
+
+    // Clockwise square in tile coordinates with a counter-clockwise hole
+    std::vector<uint32_t> polygon = {
+        command(1, 1), zigzag(0), zigzag(0),
+        command(2, 3), zigzag(0), zigzag(100), zigzag(100), zigzag(0), zigzag(0), zigzag(-100),
+        command(7, 1),
+        command(1, 1), zigzag(-90), zigzag(-90),
+        command(2, 3), zigzag(80), zigzag(0), zigzag(0), zigzag(80), zigzag(-80), zigzag(0),
+        command(7, 1)
+    };
+
+    PbfWriter layer;
+    layer.string(1, "test");
+    layer.bytes(2, feature(1, { command(1, 1), zigzag(10), zigzag(20) }, 0));
+    layer.bytes(2, feature(2, { command(1, 1), zigzag(0), zigzag(0),
+                                command(2, 2), zigzag(10), zigzag(0), zigzag(0), zigzag(10) }, 1));
+    layer.bytes(2, feature(3, polygon, 2));
+    layer.bytes(2, feature(3, polygon, 0));
+    layer.string(3, "kind");
+
+    for (auto value : { "point", "line", "polygon" }) {
+        PbfWriter valueMsg;
+        valueMsg.string(1, value);
+        layer.bytes(4, valueMsg.data);
+    }
+    layer.key(5, 0);
+    layer.varint(4096);
+
+    return layer.data;
+}
+
+static Layer parseLayer(std::shared_ptr<std::vector<char>> _data, bool _lazy, Arena* _arena = nullptr) {
+    Mvt::ParserContext ctx(0);
+    ctx.arena = _arena;
+    ctx.lazyGeometry = _lazy;
+    ctx.rawData = _data;
+
+    return Mvt::getLayer(ctx, protobuf::message(_data->data(), _data->size()));
+}
+
+TEST_CASE( "Lazily decoded MVT geometry is the same as eagerly decoded geometry", "[Mvt]" ) {
+
+    auto data = std::make_shared<std::vector<char>>(makeLayer());
+
+    Layer eager = parseLayer(data, false);
+    Layer lazy = parseLayer(data, true);
+
+    REQUIRE(eager.features.size() == 4);
+    REQUIRE(lazy.features.size() == 4);
+    REQUIRE(!eager.decoder);
+    REQUIRE(lazy.decoder);
+
+    // Properties are parsed right away, with interned keys
+    REQUIRE(lazy.features[1].props.getString("kind") == "line");
+    REQUIRE(lazy.features[1].props.items()[0].key == PropertyKey("kind"));
+
+    // Only the first polygon is decoded to find the exterior winding
+    REQUIRE(lazy.features[0].points.empty());
+    REQUIRE(lazy.features[1].lines().empty());
+    REQUIRE(lazy.features[2].polygons().size() == 1);
+    REQUIRE(lazy.features[3].polygons().empty());
+
+    for (size_t i = 0; i < 4; i++) {
+        const auto& a = eager.features[i];
+        const auto& b = lazy.features[i];
+
+        b.decodeGeometry();
+        // Decoded once
+        b.decodeGeometry();
+
+        REQUIRE(a.geometryType == b.geometryType);
+        REQUIRE(a.points == b.points);
+        REQUIRE(a.lineEnds == b.lineEnds);
+        REQUIRE(a.polygonEnds == b.polygonEnds);
+        REQUIRE(a.props.getString("kind") == b.props.getString("kind"));
+    }
+
+    REQUIRE(eager.features[3].polygons().size() == 1);
+    REQUIRE(eager.features[3].polygons()[0].size() == 2);
+
+    // Rings of the polygon are stored one after another
+    auto polygon = eager.features[3].polygons()[0];
+    REQUIRE(polygon.pointCount() == 10);
+    REQUIRE(polygon[1].begin() == polygon[0].end());
+    REQUIRE(polygon[0].front() == polygon[0].back());
+
+    REQUIRE(eager.features[1].lines().size() == 1);
+    REQUIRE(eager.features[1].lines()[0].size() == 3);
+
+    // The layer keeps the tile data alive
+    std::weak_ptr<std::vector<char>> weak = data;
+    Layer copy = parseLayer(data, true);
+    data.reset();
+    lazy.decoder.reset();
+    REQUIRE(!weak.expired());
+
+    copy.features[0].decodeGeometry();
+    REQUIRE(copy.features[0].points == eager.features[0].points);
+}
+
+TEST_CASE( "MVT geometry allocated from an Arena is the same as from the heap", "[Mvt]" ) {
+
+    auto data = std::make_shared<std::vector<char>>(makeLayer());
+
+    Arena arena;
+    Layer heap = parseLayer(data, false);
+    Layer eager = parseLayer(data, false, &arena);
+    Layer lazy = parseLayer(data, true, &arena);
+
+    for (size_t i = 0; i < 4; i++) {
+        const auto& a = heap.features[i];
+        lazy.features[i].decodeGeometry();
+
+        for (const auto* b : { &eager.features[i], &lazy.features[i] }) {
+            REQUIRE(b->points.get_allocator().arena() == &arena);
+            REQUIRE(a.points == b->points);
+            REQUIRE(a.lineEnds == b->lineEnds);
+            REQUIRE(a.polygonEnds == b->polygonEnds);
+        }
+    }
+    REQUIRE(arena.chunkCount() > 0);
+
+    // Geometry is reserved from the command counts, without regrowing
+    for (size_t i = 1; i < 4; i++) {
+        const auto& feature = eager.features[i];
+        REQUIRE(feature.points.capacity() == feature.points.size());
+        REQUIRE(feature.lineEnds.capacity() == feature.lineEnds.size());
+    }
+
+    // Copies do not refer to the arena
+    Feature copy = eager.features[3];
+    REQUIRE(!copy.points.get_allocator().arena());
+    REQUIRE(copy.points == eager.features[3].points);
+}
+
+TEST_CASE( "MVT polygon rings are reversed and compacted in place", "[Mvt]" ) {
+
+    Line outer = { {0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 0.f} };
+    Line empty = { {.5f, .5f, 0.f}, {.6f, .6f, 0.f}, {.5f, .5f, 0.f} };
+    Line hole = { {.2f, .2f, 0.f}, {.2f, .4f, 0.f}, {.4f, .4f, 0.f}, {.2f, .2f, 0.f} };
+
+    // The first ring determines the exterior winding
+    REQUIRE(signedArea(outer.begin(), outer.end()) < 0);
+    REQUIRE(signedArea(hole.begin(), hole.end()) > 0);
+
+    Mvt::Geometry geometry;
+    for (auto* ring : { &outer, &empty, &hole }) {
+        geometry.coordinates.insert(geometry.coordinates.end(), ring->begin(), ring->end());
+        geometry.sizes.push_back(ring->size());
+    }
+
+    Mvt::ParserContext ctx(0);
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+    Mvt::setGeometry(ctx, std::move(geometry), feature);
+
+    REQUIRE(ctx.winding == -1);
+
+    std::reverse(outer.begin(), outer.end());
+    std::reverse(hole.begin(), hole.end());
+
+    auto polygons = feature.polygons();
+    REQUIRE(polygons.size() == 1);
+    REQUIRE(polygons[0].size() == 2);
+    REQUIRE(std::equal(outer.begin(), outer.end(), polygons[0][0].begin()));
+    REQUIRE(std::equal(hole.begin(), hole.end(), polygons[0][1].begin()));
+    REQUIRE(feature.points.size() == outer.size() + hole.size());
+}
+
+static void requireSameGeometry(const std::vector<uint32_t>& _commands) {
+    PbfWriter writer;
+    for (auto value : _commands) { writer.varint(value); }
+
+    Mvt::ParserContext ctx(0);
+    ctx.tileExtent = 4096;
+    protobuf::message msg(writer.data.data(), writer.data.size());
+
+    auto bulk = Mvt::getGeometry(ctx, msg);
+    auto scalar = Mvt::getGeometryScalar(ctx, msg);
+
+    REQUIRE(bulk.coordinates == scalar.coordinates);
+    REQUIRE(bulk.sizes == scalar.sizes);
+}
+
+TEST_CASE( "Bulk decoded MVT geometry is the same as the reference decoder", "[Mvt]" ) {
+
+    std::mt19937 random(0);
+    auto delta = [&]() {
+        // Mostly small steps, sometimes repeated points and large jumps
+        switch (random() % 8) {
+        case 0: return zigzag(0);
+        case 1: return zigzag(int32_t(random() % 8192) - 4096);
+        default: return zigzag(int32_t(random() % 64) - 32);
+        }
+    };
+
+    for (int i = 0; i < 50; i++) {
+        std::vector<uint32_t> commands;
+
+        for (int part = 0, parts = 1 + random() % 4; part < parts; part++) {
+            uint32_t points = 1 + random() % 3;
+            commands.push_back(command(1, points));
+            for (uint32_t p = 0; p < 2 * points; p++) { commands.push_back(delta()); }
+
+            uint32_t steps = random() % 40;
+            if (steps > 0) {
+                commands.push_back(command(2, steps));
+                for (uint32_t p = 0; p < 2 * steps; p++) { commands.push_back(delta()); }
+            }
+            if (random() % 2) { commands.push_back(command(7, 1)); }
+        }
+        requireSameGeometry(commands);
+    }
+
+    // Multipoint
+    requireSameGeometry({ command(1, 3), zigzag(1), zigzag(2), zigzag(0), zigzag(0), zigzag(-5), zigzag(3) });
+
+    // Truncated lineTo
+    requireSameGeometry({ command(1, 1), zigzag(1), zigzag(2), command(2, 2), zigzag(1), zigzag(1) });
+}
+
+TEST_CASE( "Lazily decoded MVT geometry that is malformed is left empty", "[Mvt]" ) {
+
+    // Line geometry ending in an unterminated varint
+    PbfWriter geometry;
+    for (auto value : { command(1, 1), zigzag(0), zigzag(0), command(2, 2), zigzag(10) }) {
+        geometry.varint(value);
+    }
+    geometry.data.push_back(char(0x80));
+
+    PbfWriter feature;
+    feature.key(3, 0);
+    feature.varint(2);
+    feature.bytes(4, geometry.data);
+
+    PbfWriter layer;
+    layer.string(1, "test");
+    layer.bytes(2, feature.data);
+    layer.key(5, 0);
+    layer.varint(4096);
+
+    auto data = std::make_shared<std::vector<char>>(layer.data);
+    Layer lazy = parseLayer(data, true);
+    REQUIRE(lazy.features.size() == 1);
+
+    REQUIRE_NOTHROW(lazy.features[0].decodeGeometry());
+    REQUIRE(lazy.features[0].points.empty());
+    REQUIRE(lazy.features[0].lines().empty());
+}
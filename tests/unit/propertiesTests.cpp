@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+#include "data/propertyKey.h"
+
+#include <string>
+
+using namespace Tangram;
+
+TEST_CASE( "PropertyKeys with the same name are the same key", "[Properties]" ) {
+
+    PropertyKey a("kind");
+    PropertyKey b(std::string("ki") + "nd");
+    PropertyKey c("name");
+
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(&a.str() == &b.str());
+    REQUIRE(a == std::string("kind"));
+    REQUIRE(PropertyKey().empty());
+
+    size_t count = PropertyKey::internedCount();
+    PropertyKey d("kind");
+    REQUIRE(PropertyKey::internedCount() == count);
+}
+
+TEST_CASE( "PropertyKeyCache returns the interned keys", "[Properties]" ) {
+
+    PropertyKeyCache cache;
+    PropertyKey key = cache.get("kind");
+
+    REQUIRE(key == PropertyKey("kind"));
+    REQUIRE(cache.get("kind") == key);
+    REQUIRE(cache.get("name") != key);
+}
+
+TEST_CASE( "Properties are found by name and by interned key", "[Properties]" ) {
+
+    Properties props;
+    props.set("name", "road");
+    props.set("height", 10);
+    props.set("name", "street");
+
+    REQUIRE(props.items().size() == 2);
+    REQUIRE(props.getString("name") == "street");
+    REQUIRE(props.get(PropertyKey("name")).get<std::string>() == "street");
+    REQUIRE(props.get(PropertyKey("height")).get<double>() == 10);
+    REQUIRE(props.contains(PropertyKey("height")));
+    REQUIRE(!props.contains(PropertyKey("width")));
+    REQUIRE(!props.contains("width"));
+
+    // Items are sorted by key length, then by name
+    REQUIRE(props.items()[0].key == std::string("name"));
+    REQUIRE(props.toJson() == "{ \"name\": \"street\",\"height\": \"10\" }");
+}
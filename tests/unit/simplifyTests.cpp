@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include "data/propertyItem.h"
+#include "util/simplify.h"
+
+#include <memory>
+
+using namespace Tangram;
+
+TEST_CASE( "Simplify lines and keep their end points", "[Simplify]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::lines;
+    feature.addLine(Line{ {0.f, 0.f, 0.f}, {0.25f, 0.001f, 0.f}, {0.5f, 0.f, 0.f},
+                          {0.75f, -0.001f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f} });
+    feature.addLine(Line{ {0.f, 1.f, 0.f}, {1.f, 1.f, 0.f} });
+
+    REQUIRE(simplifyFeature(feature, 0.01f) == 3);
+
+    auto lines = feature.lines();
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0].size() == 3);
+    REQUIRE(lines[0][0] == Point(0.f, 0.f, 0.f));
+    REQUIRE(lines[0][1] == Point(1.f, 0.f, 0.f));
+    REQUIRE(lines[0][2] == Point(1.f, 1.f, 0.f));
+
+    // Moved to the end of the first line
+    REQUIRE(lines[1].size() == 2);
+    REQUIRE(lines[1][0] == Point(0.f, 1.f, 0.f));
+
+    // Points are not simplified
+    Feature points;
+    points.geometryType = GeometryType::points;
+    points.points.assign(3, Point(0.f, 0.f, 0.f));
+    REQUIRE(simplifyFeature(points, 1.f) == 0);
+    REQUIRE(points.points.size() == 3);
+}
+
+TEST_CASE( "Simplify polygon rings without collapsing them", "[Simplify]" ) {
+
+    Feature feature;
+    feature.geometryType = GeometryType::polygons;
+    feature.addPolygon(Polygon{
+        { {0.f, 0.f, 0.f}, {0.5f, 0.001f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f},
+          {0.f, 1.f, 0.f}, {0.f, 0.f, 0.f} },
+        // Hole smaller than the tolerance
+        { {0.5f, 0.5f, 0.f}, {0.501f, 0.5f, 0.f}, {0.501f, 0.501f, 0.f}, {0.5f, 0.5f, 0.f} } });
+
+    REQUIRE(simplifyFeature(feature, 0.01f) == 1);
+
+    auto polygons = feature.polygons();
+    REQUIRE(polygons.size() == 1);
+    REQUIRE(polygons[0].size() == 2);
+    REQUIRE(polygons[0][0].size() == 5);
+    REQUIRE(polygons[0][0].front() == polygons[0][0].back());
+    REQUIRE(polygons[0][1].size() == 4);
+}
+
+// Adds a line from @_size points at y = 0, each shifted by 0.001
+struct TestDecoder : public GeometryDecoder {
+    void decode(const char* _data, size_t _size, Feature& _feature) const override {
+        for (size_t i = 0; i < _size; i++) {
+            _feature.points.push_back({ float(i), (i % 2) * 0.001f, 0.f });
+        }
+        _feature.endLine();
+    }
+};
+
+TEST_CASE( "Simplify lazily parsed features when they are decoded", "[Simplify]" ) {
+
+    TileData data;
+    data.layers.emplace_back("layer");
+    auto& layer = data.layers.back();
+    layer.decoder = std::make_shared<TestDecoder>();
+
+    Feature feature;
+    feature.geometryType = GeometryType::lines;
+    feature.encoded.decoder = layer.decoder.get();
+    feature.encoded.size = 5;
+    layer.features.push_back(feature);
+
+    simplifyTileData(data, 0.01f);
+
+    auto& lazy = data.layers[0].features[0];
+    REQUIRE(lazy.points.empty());
+
+    lazy.decodeGeometry();
+    REQUIRE(lazy.lines().size() == 1);
+    REQUIRE(lazy.points.size() == 2);
+    REQUIRE(lazy.points.back() == Point(4.f, 0.f, 0.f));
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "scene/sceneLoader.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+
+#include <atomic>
+#include <memory>
+
+using namespace Tangram;
+
+static const char* s_sceneYaml = R"END(
+sources:
+    test:
+        type: GeoJSON
+layers:
+    buildings:
+        data: { source: test }
+        draw:
+            polygons:
+                color: red
+                order: 1
+)END";
+
+// @_count squares in a row
+static TileData makeTileData(int _count) {
+    TileData data;
+    data.layers.emplace_back("buildings");
+
+    for (int i = 0; i < _count; i++) {
+        Feature feature;
+        feature.geometryType = GeometryType::polygons;
+
+        float x = float(i) / _count;
+        Line ring = { {x, 0, 0}, {x + 0.5f / _count, 0, 0}, {x + 0.5f / _count, 0.5f, 0}, {x, 0, 0} };
+        feature.addPolygon(Polygon{ ring });
+
+        data.layers.back().features.push_back(std::move(feature));
+    }
+    return data;
+}
+
+TEST_CASE( "TileBuilder drops the styled features of a tile canceled while styling", "[TileBuilder]" ) {
+
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    auto scene = std::make_shared<Scene>(platform, s_sceneYaml, "");
+    REQUIRE(SceneLoader::loadScene(platform, scene));
+
+    auto& source = **scene->tileSources().begin();
+    TileBuilder builder(scene);
+
+    // Styling stops at the first check of the flag, after some features were added
+    std::atomic<bool> canceled{true};
+    auto large = makeTileData(1000);
+    REQUIRE(builder.build(TileID(0, 0, 10), large, source, &canceled) == nullptr);
+
+    // The next tile gets the same meshes as from a builder that was never canceled
+    std::atomic<bool> running{false};
+    auto small = makeTileData(1);
+    auto tile = builder.build(TileID(1, 0, 10), small, source, &running);
+    REQUIRE(tile);
+
+    TileBuilder fresh(scene);
+    auto expected = fresh.build(TileID(1, 0, 10), small, source, &running);
+    REQUIRE(expected);
+
+    REQUIRE(expected->getMemoryUsage() > 0);
+    REQUIRE(tile->getMemoryUsage() == expected->getMemoryUsage());
+}
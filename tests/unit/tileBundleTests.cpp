@@ -0,0 +1,152 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "gl/mesh.h"
+#include "scene/scene.h"
+#include "selection/featureSelection.h"
+#include "style/polygonStyle.h"
+#include "tile/tile.h"
+#include "tile/tileBundle.h"
+#include "util/mapProjection.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace Tangram;
+
+// Layout of PolygonStyle without texture coordinates
+struct PolygonVertex {
+    int16_t position[4];
+    int8_t normal[4];
+    uint32_t color;
+    uint32_t selection;
+};
+
+struct BundleContext {
+    Scene scene;
+    MercatorProjection projection;
+    Style* polygons;
+
+    BundleContext() {
+        scene.featureSelection() = std::make_unique<FeatureSelection>();
+
+        auto style = std::make_unique<PolygonStyle>("polygons");
+        style->setID(0);
+        style->constructVertexLayout();
+        polygons = style.get();
+        scene.styles().push_back(std::move(style));
+    }
+
+    std::unique_ptr<Tile> makeTile() {
+        auto tile = std::make_unique<Tile>(TileID(1, 2, 3), projection);
+        tile->initGeometry(1);
+
+        MeshData<PolygonVertex> meshData({ 0, 1, 2 }, {
+                { {0, 0, 0, 0}, {0, 0, 127, 0}, 0xff0000ff, 7 },
+                { {1, 0, 0, 0}, {0, 0, 127, 0}, 0xff0000ff, 7 },
+                { {0, 1, 0, 0}, {0, 0, 127, 0}, 0xff0000ff, 0 } });
+
+        auto mesh = std::make_unique<Mesh<PolygonVertex>>(polygons->vertexLayout(), GL_TRIANGLES);
+        mesh->compile(meshData);
+        tile->setMesh(*polygons, std::move(mesh));
+
+        auto props = std::make_shared<Properties>();
+        props->set("name", "feature");
+        props->set("height", 10);
+
+        fastmap<uint32_t, std::shared_ptr<Properties>> selectionFeatures;
+        selectionFeatures[7] = props;
+        tile->setSelectionFeatures(selectionFeatures);
+
+        return tile;
+    }
+};
+
+TEST_CASE( "Encode and decode the meshes and selection features of a Tile", "[TileBundle]" ) {
+
+    BundleContext ctx;
+    REQUIRE(ctx.polygons->vertexLayout()->getStride() == sizeof(PolygonVertex));
+
+    auto tile = ctx.makeTile();
+
+    auto data = TileBundle::encode(42, *tile, ctx.scene);
+    REQUIRE(!data.empty());
+
+    auto bundle = TileBundle::fromData(data);
+    REQUIRE(bundle->isValid(42));
+    REQUIRE(!bundle->hasLabels());
+
+    Tile restored(TileID(1, 2, 3), ctx.projection);
+    REQUIRE(!bundle->decode(43, restored, ctx.scene));
+    REQUIRE(bundle->decode(42, restored, ctx.scene));
+
+    auto* meshBase = restored.getMesh(*ctx.polygons)->meshBase();
+    REQUIRE(meshBase);
+    REQUIRE(meshBase->vertexCount() == 3);
+    REQUIRE(meshBase->indexCount() == 3);
+    REQUIRE(meshBase->vertexOffsets() == tile->getMesh(*ctx.polygons)->meshBase()->vertexOffsets());
+    REQUIRE(restored.getMemoryUsage() == tile->getMemoryUsage());
+
+    // Selection colors are replaced by colors of the running scene
+    auto& features = restored.getSelectionFeatures();
+    REQUIRE(features.size() == 1);
+
+    uint32_t color = features.begin()->first;
+    REQUIRE(color != 0);
+    REQUIRE(features.begin()->second->getString("name") == "feature");
+    REQUIRE(features.begin()->second->getNumber("height") == 10);
+
+    auto* vertices = reinterpret_cast<const PolygonVertex*>(meshBase->vertexData());
+    REQUIRE(vertices[0].selection == color);
+    REQUIRE(vertices[1].selection == color);
+    REQUIRE(vertices[2].selection == 0);
+    REQUIRE(vertices[1].position[0] == 1);
+
+    // A truncated bundle is rejected
+    data.resize(data.size() / 2);
+    Tile truncated(TileID(1, 2, 3), ctx.projection);
+    REQUIRE(!TileBundle::fromData(data)->decode(42, truncated, ctx.scene));
+    REQUIRE(!truncated.getMesh(*ctx.polygons));
+}
+
+TEST_CASE( "Meshes of a mapped TileBundle use the mapped memory", "[TileBundle]" ) {
+
+    BundleContext ctx;
+    auto data = TileBundle::encode(42, *ctx.makeTile(), ctx.scene);
+
+    char path[] = "/tmp/tileBundleXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+
+    FILE* file = fdopen(fd, "wb");
+    REQUIRE(fwrite(data.data(), 1, data.size(), file) == data.size());
+    fclose(file);
+
+    auto bundle = TileBundle::map(path);
+    std::remove(path);
+
+    REQUIRE(bundle);
+    REQUIRE(bundle->size() == data.size());
+
+    Tile tile(TileID(1, 2, 3), ctx.projection);
+    REQUIRE(bundle->decode(42, tile, ctx.scene));
+
+    auto* meshBase = tile.getMesh(*ctx.polygons)->meshBase();
+    size_t vertexAlignment = reinterpret_cast<uintptr_t>(meshBase->vertexData()) % TileBundle::ALIGNMENT;
+    size_t indexAlignment = reinterpret_cast<uintptr_t>(meshBase->indexData()) % TileBundle::ALIGNMENT;
+    REQUIRE(vertexAlignment == 0);
+    REQUIRE(indexAlignment == 0);
+
+    // The mesh keeps the bundle mapped
+    std::weak_ptr<TileBundle> weak = bundle;
+    bundle.reset();
+    REQUIRE(!weak.expired());
+
+    auto* vertices = reinterpret_cast<const PolygonVertex*>(meshBase->vertexData());
+    REQUIRE(vertices[1].position[0] == 1);
+    REQUIRE(meshBase->indexData()[2] == 2);
+
+    tile.setMesh(*ctx.polygons, nullptr);
+    REQUIRE(weak.expired());
+}
@@ -0,0 +1,198 @@
+#include "catch.hpp"
+
+#include "style/polygonStyle.h"
+#include "tile/tile.h"
+#include "tile/tileCache.h"
+#include "util/mapProjection.h"
+
+#include <memory>
+
+using namespace Tangram;
+
+struct SizedMesh : StyledMesh {
+    size_t size;
+    SizedMesh(size_t _size) : size(_size) {}
+
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) override { return true; }
+    size_t bufferSize() const override { return size; }
+};
+
+static MercatorProjection s_projection;
+static PolygonStyle s_style("polygons");
+
+static std::shared_ptr<Tile> makeTile(int _x, size_t _size) {
+    auto tile = std::make_shared<Tile>(TileID(_x, 0, 10), s_projection, nullptr);
+    tile->setMesh(s_style, std::make_unique<SizedMesh>(_size));
+    return tile;
+}
+
+TEST_CASE( "TileCache accounts memory usage and counts hits and misses", "[TileCache]" ) {
+
+    TileCache cache(1000);
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(cache.put(1, makeTile(i, 100)).empty());
+    }
+
+    REQUIRE(cache.getMemoryUsage() == 300);
+    REQUIRE(cache.stats().tiles == 3);
+
+    // Probing does not change the counters
+    REQUIRE(cache.contains(1, TileID(0, 0, 10)));
+    REQUIRE(!cache.contains(1, TileID(5, 0, 10)));
+    REQUIRE(cache.stats().hits == 0);
+    REQUIRE(cache.stats().misses == 0);
+
+    REQUIRE(cache.get(1, TileID(0, 0, 10)));
+    REQUIRE(!cache.get(1, TileID(0, 0, 10)));
+    REQUIRE(!cache.get(2, TileID(1, 0, 10)));
+
+    REQUIRE(cache.getMemoryUsage() == 200);
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(cache.stats().misses == 2);
+
+    // Putting a cached tile again replaces it
+    cache.put(1, makeTile(1, 150));
+    REQUIRE(cache.getMemoryUsage() == 250);
+    REQUIRE(cache.stats().tiles == 2);
+
+    auto sources = cache.sourceStats();
+    REQUIRE(sources.size() == 2);
+    for (auto& source : sources) {
+        if (source.first == 1) {
+            REQUIRE(source.second.hits == 1);
+            REQUIRE(source.second.misses == 1);
+            REQUIRE(source.second.memoryUsage == 250);
+        } else {
+            REQUIRE(source.first == 2);
+            REQUIRE(source.second.misses == 1);
+            REQUIRE(source.second.tiles == 0);
+        }
+    }
+
+    cache.clear();
+    REQUIRE(cache.getMemoryUsage() == 0);
+    REQUIRE(cache.stats().tiles == 0);
+    REQUIRE(cache.stats().hits == 1);
+}
+
+TEST_CASE( "TileCache keeps reused tiles while scanning", "[TileCache]" ) {
+
+    TileCache cache(1000);
+
+    // Tiles that were taken from the cache and put back are reused
+    for (int i = 0; i < 4; i++) {
+        cache.put(1, makeTile(i, 100));
+    }
+    for (int i = 0; i < 4; i++) {
+        cache.put(1, cache.get(1, TileID(i, 0, 10)));
+    }
+
+    // Pan over many tiles that are passed by once
+    size_t evictions = 0;
+    for (int i = 100; i < 150; i++) {
+        for (auto& key : cache.put(1, makeTile(i, 100))) {
+            REQUIRE(key.second.x >= 100);
+            evictions++;
+        }
+        REQUIRE(cache.getMemoryUsage() <= 1000);
+    }
+
+    REQUIRE(evictions > 0);
+    REQUIRE(cache.stats().evictions == evictions);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(cache.contains(1, TileID(i, 0, 10)));
+    }
+    REQUIRE(cache.contains(1, TileID(149, 0, 10)));
+    REQUIRE(!cache.contains(1, TileID(100, 0, 10)));
+
+    // Shrinking the cache evicts the reused tiles at last
+    auto evicted = cache.limitCacheSize(200);
+    REQUIRE(!evicted.empty());
+    REQUIRE(cache.getMemoryUsage() <= 200);
+    REQUIRE(cache.contains(1, TileID(3, 0, 10)));
+}
+
+TEST_CASE( "TileCache evicts tiles of a source over its quota", "[TileCache]" ) {
+
+    TileCache cache(1000);
+
+    cache.put(2, makeTile(0, 100));
+    cache.put(2, makeTile(1, 100));
+
+    REQUIRE(cache.setSourceQuota(1, 300).empty());
+
+    for (int i = 0; i < 5; i++) {
+        for (auto& key : cache.put(1, makeTile(i, 100))) {
+            REQUIRE(key.first == 1);
+        }
+    }
+
+    REQUIRE(cache.getMemoryUsage() == 500);
+    REQUIRE(cache.contains(2, TileID(0, 0, 10)));
+    REQUIRE(cache.contains(2, TileID(1, 0, 10)));
+    REQUIRE(cache.contains(1, TileID(4, 0, 10)));
+    REQUIRE(!cache.contains(1, TileID(0, 0, 10)));
+
+    // Lowering the quota evicts immediately
+    auto evicted = cache.setSourceQuota(1, 100);
+    REQUIRE(evicted.size() == 2);
+    REQUIRE(cache.getMemoryUsage() == 300);
+
+    // No quota
+    cache.setSourceQuota(1, 0);
+    cache.put(1, makeTile(10, 100));
+    cache.put(1, makeTile(11, 100));
+    REQUIRE(cache.getMemoryUsage() == 500);
+}
+
+TEST_CASE( "TileCache removes the selected tiles of a source", "[TileCache]" ) {
+
+    TileCache cache(1000);
+
+    for (int i = 0; i < 4; i++) {
+        cache.put(1, makeTile(i, 100));
+    }
+    cache.put(2, makeTile(0, 100));
+
+    auto removed = cache.removeTiles(1, [](const Tile& _tile) { return _tile.getID().x % 2 == 0; });
+    REQUIRE(removed.size() == 2);
+    REQUIRE(cache.getMemoryUsage() == 300);
+    REQUIRE(cache.stats().evictions == 0);
+    REQUIRE(!cache.contains(1, TileID(0, 0, 10)));
+    REQUIRE(cache.contains(1, TileID(1, 0, 10)));
+    REQUIRE(cache.contains(2, TileID(0, 0, 10)));
+
+    REQUIRE(cache.removeTiles(3, [](const Tile&) { return true; }).empty());
+}
+
+TEST_CASE( "TileCache forgets the tiles, counters and quota of a removed source", "[TileCache]" ) {
+
+    TileCache cache(1000);
+
+    cache.setSourceQuota(1, 200);
+    for (int i = 0; i < 2; i++) {
+        cache.put(1, makeTile(i, 100));
+    }
+    cache.put(2, makeTile(0, 100));
+    cache.get(1, TileID(0, 0, 10));
+
+    cache.removeSource(1);
+    REQUIRE(cache.getMemoryUsage() == 100);
+    REQUIRE(cache.stats().tiles == 1);
+    REQUIRE(!cache.contains(1, TileID(1, 0, 10)));
+
+    auto sources = cache.sourceStats();
+    REQUIRE(sources.size() == 1);
+    REQUIRE(sources[0].first == 2);
+
+    // A source with the same id starts without quota
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(cache.put(1, makeTile(i, 100)).empty());
+    }
+    REQUIRE(cache.getMemoryUsage() == 500);
+
+    cache.removeSource(3);
+    REQUIRE(cache.sourceStats().size() == 2);
+}
@@ -0,0 +1,112 @@
+#include "catch.hpp"
+
+#include "data/tileSource.h"
+#include "scene/scene.h"
+#include "tile/tile.h"
+#include "tile/tileDiskCache.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+using namespace Tangram;
+
+static std::string makeCacheDir() {
+    char path[] = "/tmp/tileDiskCacheXXXXXX";
+    REQUIRE(mkdtemp(path));
+    return path;
+}
+
+// Bundle @_key of an empty tile
+static std::vector<char> makeEntry(uint64_t _key) {
+    static Scene s_scene;
+    static MercatorProjection s_projection;
+
+    Tile tile(TileID(0, 0, 0), s_projection);
+    return TileBundle::encode(_key, tile, s_scene);
+}
+
+TEST_CASE( "TileDiskCache stores entries and finds them again", "[TileDiskCache]" ) {
+
+    std::string path = makeCacheDir();
+    size_t entrySize = makeEntry(1).size();
+
+    {
+        TileDiskCache cache(path, entrySize * 5 / 2);
+        REQUIRE(cache.isValid());
+
+        REQUIRE(!cache.load(1));
+
+        cache.store(1, makeEntry(1));
+        cache.store(2, makeEntry(2));
+        cache.flush();
+
+        auto entry = cache.load(1);
+        REQUIRE(entry);
+        REQUIRE(entry->isValid(1));
+        REQUIRE(entry->size() == entrySize);
+
+        // Entry 2 is the least recently used
+        cache.store(3, makeEntry(3));
+        cache.flush();
+
+        REQUIRE(!cache.load(2));
+
+        auto stats = cache.stats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.labelHits == 0);
+        REQUIRE(stats.misses == 2);
+        REQUIRE(stats.stores == 3);
+        REQUIRE(stats.entries == 2);
+        REQUIRE(stats.usage == entrySize * 2);
+    }
+
+    {
+        // load() waits until the directory is read
+        TileDiskCache cache(path, entrySize * 5 / 2);
+        REQUIRE(cache.load(3));
+    }
+
+    // Entries persist, the directory is read in the background
+    TileDiskCache cache(path, entrySize * 5 / 2);
+    cache.flush();
+    REQUIRE(cache.stats().entries == 2);
+    REQUIRE(cache.load(3));
+
+    // An entry stored under another key is not valid
+    cache.store(4, makeEntry(5));
+    cache.flush();
+    REQUIRE(!cache.load(4));
+
+    cache.clear();
+    cache.flush();
+    REQUIRE(!cache.load(1));
+    REQUIRE(cache.stats().usage == 0);
+}
+
+struct KeyedTileTask : BinaryTileTask {
+    using BinaryTileTask::BinaryTileTask;
+    using BinaryTileTask::diskCacheKey;
+};
+
+TEST_CASE( "Disk cache keys of tiles depend on the clipping and simplification of their source", "[TileDiskCache]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileID id(1, 2, 3);
+    KeyedTileTask task(id, source, -1);
+    task.rawTileData = std::make_shared<std::vector<char>>(16, 'x');
+
+    uint64_t key = task.diskCacheKey(0);
+    REQUIRE(key != 0);
+    REQUIRE(task.diskCacheKey(0) == key);
+    REQUIRE(task.diskCacheKey(1) != key);
+
+    source->setSimplification(1.f);
+    uint64_t simplified = task.diskCacheKey(0);
+    REQUIRE(simplified != key);
+
+    source->setClipBuffer(8.f);
+    REQUIRE(task.diskCacheKey(0) != simplified);
+}
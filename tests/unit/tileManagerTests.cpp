@@ -2,6 +2,7 @@
 
 #include "data/tileSource.h"
 #include "mockPlatform.h"
+#include "tile/tileCache.h"
 #include "tile/tileManager.h"
 #include "tile/tileWorker.h"
 #include "util/mapProjection.h"
@@ -119,7 +120,7 @@ public:
 
         TileSet& tileSet = m_tileSets[0];
 
-        tileSet.visibleTiles = _visibleTiles;
+        tileSet.visibleTiles.keys.assign(_visibleTiles.begin(), _visibleTiles.end());
 
         TileManager::updateTileSet(tileSet, _view);
 
@@ -134,6 +135,14 @@ public:
         m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
 
     }
+
+    void updatePrefetch(const ViewState& _view, std::set<TileID> _prefetchTiles) {
+        TileSet& tileSet = m_tileSets[0];
+
+        tileSet.prefetchTiles.keys.assign(_prefetchTiles.begin(), _prefetchTiles.end());
+
+        TileManager::updatePrefetch(tileSet, _view);
+    }
 };
 
 TEST_CASE( "Use proxy Tile - Dont remove proxy if it is now visible", "[TileManager][updateTileSets]" ) {
@@ -218,6 +227,39 @@ TEST_CASE( "Load visible Tile", "[TileManager][updateTileSets]" ) {
 }
 
 
+TEST_CASE( "Replace provisional Tile by the Tile built from its own data", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    std::set<TileID> visibleTiles = {TileID{0,0,0}};
+    tileManager.updateTiles(viewState, visibleTiles);
+
+    // Built from data sliced from a parent
+    auto task = worker.tasks.front();
+    worker.processTask();
+    task->tile()->setProvisional(true);
+
+    tileManager.updateTiles(viewState, visibleTiles);
+
+    // Provisional tile is shown while the tile is loaded again
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->isProvisional());
+    REQUIRE(source->tileTaskCount == 2);
+    REQUIRE(worker.tasks.size() == 1);
+    REQUIRE(!worker.tasks.front()->isSliceable());
+
+    worker.processTask();
+    tileManager.updateTiles(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(!tileManager.getVisibleTiles()[0]->isProvisional());
+    REQUIRE(source->tileTaskCount == 2);
+}
+
 TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     TestTileWorker worker;
     TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
@@ -302,3 +344,102 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
 
 }
+
+TEST_CASE( "Prefetch predicted Tiles", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+    tileManager.setPrefetch(1.f, 2);
+
+    // Ordered by distance to the view center
+    std::set<TileID> prefetchTiles = {TileID{1,1,2}, TileID{0,1,2}, TileID{3,3,2}};
+
+    tileManager.updatePrefetch(viewState, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 2);
+    REQUIRE(worker.tasks.size() == 2);
+    REQUIRE(worker.tasks[0]->isProxy());
+
+    // Loaded tiles go to the cache and free the budget
+    worker.processTask();
+    worker.processTask();
+    tileManager.updatePrefetch(viewState, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 3);
+    REQUIRE(tileManager.getPrefetchStats().loaded == 2);
+    REQUIRE(tileManager.getTileCache()->contains(source->id(), TileID{1,1,2}));
+
+    // Prefetched tile is taken from the cache
+    tileManager.updateTiles(viewState, {TileID{1,1,2}});
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(source->tileTaskCount == 3);
+    REQUIRE(tileManager.getPrefetchStats().hits == 1);
+
+    // Tile is not predicted anymore
+    tileManager.updatePrefetch(viewState, {});
+
+    REQUIRE(tileManager.getPrefetchStats().canceled == 1);
+    REQUIRE(tileManager.getPrefetchStats().requested == 3);
+    REQUIRE(tileManager.getPrefetchStats().hitRate() == Approx(1.f / 3));
+}
+
+TEST_CASE( "Visible Tile takes over loading prefetch task", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+    tileManager.setPrefetch(1.f, 4);
+
+    tileManager.updatePrefetch(viewState, {TileID{0,0,0}});
+    REQUIRE(source->tileTaskCount == 1);
+
+    // Not loaded again
+    tileManager.updateTiles(viewState, {TileID{0,0,0}});
+    REQUIRE(source->tileTaskCount == 1);
+    REQUIRE(tileManager.getPrefetchStats().hits == 1);
+
+    worker.processTask();
+    tileManager.updateTiles(viewState, {TileID{0,0,0}});
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
+}
+
+TEST_CASE( "Prefetch Tiles along a camera path", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    View view(256, 256);
+    view.setZoom(4);
+    view.update();
+
+    double distance = MapProjection::HALF_CIRCUMFERENCE * 0.5;
+    tileManager.setPrefetchPath(view, {{ {0, 0}, 4, 0 }, { {distance, 0}, 4, 10 }});
+
+    REQUIRE(tileManager.hasPrefetchPath());
+
+    // Only tiles needed soon are requested, within the budget
+    tileManager.updatePrefetch(viewState, {});
+
+    int requested = source->tileTaskCount;
+    REQUIRE(requested > 0);
+    REQUIRE(requested <= 8);
+    REQUIRE(worker.tasks.front()->getPriority() < 0);
+
+    // Animation was interrupted
+    tileManager.clearPrefetchPath();
+    tileManager.updatePrefetch(viewState, {});
+
+    REQUIRE(!tileManager.hasPrefetchPath());
+    REQUIRE(tileManager.getPrefetchStats().canceled == uint64_t(requested));
+}
@@ -0,0 +1,260 @@
+#include "catch.hpp"
+
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+#include "tile/tileTaskHeap.h"
+#include "tile/tileTaskScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+static std::shared_ptr<TileTask> makeTask(std::shared_ptr<TileSource> _source, int _x, float _priority) {
+    TileID id(_x, 0, 10);
+    auto task = std::make_shared<TileTask>(id, _source, -1);
+    task->setPriority(_priority);
+    return task;
+}
+
+TEST_CASE( "Pop TileTasks in priority order", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(1);
+
+    scheduler.push(makeTask(source, 0, 3));
+    scheduler.push(makeTask(source, 1, 1));
+    scheduler.push(makeTask(source, 2, 2));
+
+    REQUIRE(scheduler.size() == 3);
+
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 1);
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 2);
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 0);
+    REQUIRE(scheduler.tryPop(0) == nullptr);
+    REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE( "Proxy TileTasks are popped after visible TileTasks", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(1);
+
+    auto proxy = makeTask(source, 0, 0);
+    proxy->setProxyState(true);
+    scheduler.push(proxy);
+    scheduler.push(makeTask(source, 1, 10));
+
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 1);
+    REQUIRE(scheduler.tryPop(0) == proxy);
+}
+
+TEST_CASE( "Generations of different sources do not affect the order", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    auto updated = std::make_shared<TileSource>("updated", nullptr);
+    TileTaskScheduler scheduler(1);
+
+    auto old = makeTask(updated, 0, 1);
+    updated->clearData();
+    REQUIRE(updated->generation() > source->generation());
+
+    scheduler.push(makeTask(source, 1, 2));
+    scheduler.push(makeTask(updated, 2, 1));
+    // Same priority: The older generation of the same source first
+    scheduler.push(old);
+
+    REQUIRE(scheduler.tryPop(0) == old);
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 2);
+    REQUIRE(scheduler.tryPop(0)->tileId().x == 1);
+}
+
+TEST_CASE( "Priority orders TileTasks of a source ahead of their generation", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    auto other = std::make_shared<TileSource>("other", nullptr);
+    TileTaskScheduler scheduler(1);
+
+    auto old = makeTask(source, 0, 10);
+    source->clearData();
+
+    // By generation 'old' would come before 'current', by priority 'current'
+    // comes before 'between' and 'between' before 'old'
+    auto current = makeTask(source, 1, 1);
+    auto between = makeTask(other, 2, 5);
+    scheduler.push(old);
+    scheduler.push(between);
+    scheduler.push(current);
+
+    REQUIRE(scheduler.tryPop(0) == current);
+    REQUIRE(scheduler.tryPop(0) == between);
+    REQUIRE(scheduler.tryPop(0) == old);
+}
+
+TEST_CASE( "Canceled TileTasks are dropped", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(2);
+
+    for (int i = 0; i < 10; i++) {
+        auto task = makeTask(source, i, i);
+        if (i % 2 == 0) { task->cancel(); }
+        scheduler.push(task);
+    }
+
+    int popped = 0;
+    while (auto task = scheduler.tryPop(0)) {
+        REQUIRE(!task->isCanceled());
+        popped++;
+    }
+
+    REQUIRE(popped == 5);
+    REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE( "Workers steal TileTasks from other lanes", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(4);
+
+    for (int i = 0; i < 8; i++) {
+        scheduler.push(makeTask(source, i, i));
+    }
+
+    // All tasks can be taken from a single lane
+    int popped = 0;
+    while (scheduler.tryPop(3)) { popped++; }
+
+    REQUIRE(popped == 8);
+}
+
+TEST_CASE( "Concurrent workers process all TileTasks", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(4);
+
+    std::atomic<int> processed(0);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < 4; i++) {
+        workers.emplace_back([&, i]() {
+            while (scheduler.pop(i)) { processed++; }
+        });
+    }
+
+    const int numTasks = 10000;
+    for (int i = 0; i < numTasks; i++) {
+        scheduler.push(makeTask(source, i, i % 100));
+    }
+
+    while (processed < numTasks) { std::this_thread::yield(); }
+
+    scheduler.stop();
+    for (auto& worker : workers) { worker.join(); }
+
+    REQUIRE(processed == numTasks);
+    REQUIRE(scheduler.size() == 0);
+    REQUIRE(!scheduler.push(makeTask(source, 0, 0)));
+}
+
+TEST_CASE( "TileTaskHeap applies priority changes in place", "[TileTaskScheduler][TileTaskHeap]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskHeap heap;
+
+    std::vector<std::shared_ptr<TileTask>> tasks;
+    for (int i = 0; i < 32; i++) {
+        tasks.push_back(makeTask(source, i, i));
+        heap.push(tasks.back(), 0);
+    }
+
+    REQUIRE(TileTaskHeap::ownerOf(*tasks[0]) == 0);
+
+    // Decrease key: move the last task to the front
+    tasks[31]->setPriority(-1);
+    REQUIRE(heap.update(*tasks[31]));
+
+    // Increase key: move the first task to the back
+    tasks[0]->setPriority(100);
+    REQUIRE(heap.update(*tasks[0]));
+
+    REQUIRE(heap.remove(*tasks[10]));
+    REQUIRE(!heap.remove(*tasks[10]));
+    REQUIRE(TileTaskHeap::ownerOf(*tasks[10]) == -1);
+
+    REQUIRE(heap.pop() == tasks[31]);
+
+    float last = -1;
+    size_t popped = 1;
+    while (!heap.empty()) {
+        auto task = heap.pop();
+        REQUIRE(task->getPriority() >= last);
+        REQUIRE(TileTaskHeap::ownerOf(*task) == -1);
+        last = task->getPriority();
+        popped++;
+    }
+
+    REQUIRE(popped == 31);
+    REQUIRE(last == 100);
+}
+
+TEST_CASE( "Reprioritize queued TileTasks", "[TileTaskScheduler]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskScheduler scheduler(2);
+
+    std::vector<std::shared_ptr<TileTask>> tasks;
+    for (int i = 0; i < 8; i++) {
+        tasks.push_back(makeTask(source, i, i));
+        scheduler.push(tasks.back());
+    }
+
+    // Queuing a task twice keeps a single entry
+    scheduler.push(tasks[0]);
+    REQUIRE(scheduler.size() == 8);
+
+    tasks[7]->setPriority(-1);
+    scheduler.reprioritize(*tasks[7]);
+
+    // Lanes are filled round-robin: Task 7 is in lane 1
+    REQUIRE(scheduler.tryPop(1) == tasks[7]);
+    REQUIRE(scheduler.tryPop(0) == tasks[0]);
+
+    // Not queued anymore
+    scheduler.reprioritize(*tasks[7]);
+    REQUIRE(scheduler.size() == 6);
+}
+
+TEST_CASE( "TileTaskStageQueue blocks producers while full", "[TileTaskScheduler][TileTaskStageQueue]" ) {
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    TileTaskStageQueue queue(2);
+
+    REQUIRE(queue.push(makeTask(source, 0, 0)));
+    REQUIRE(queue.push(makeTask(source, 1, 0)));
+    REQUIRE(queue.size() == 2);
+
+    std::atomic<bool> pushed(false);
+    std::thread producer([&]() {
+        queue.push(makeTask(source, 2, 0));
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(!pushed);
+
+    // Tasks are passed on in FIFO order
+    REQUIRE(queue.pop()->tileId().x == 0);
+
+    producer.join();
+    REQUIRE(pushed);
+
+    REQUIRE(queue.pop()->tileId().x == 1);
+    REQUIRE(queue.pop()->tileId().x == 2);
+
+    queue.stop();
+    REQUIRE(queue.pop() == nullptr);
+    REQUIRE(!queue.push(makeTask(source, 3, 0)));
+}
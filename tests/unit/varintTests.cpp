@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "pbf/pbf.hpp"
+#include "util/varint.h"
+
+#include <random>
+#include <vector>
+
+using namespace Tangram;
+
+static void putVarint(std::vector<uint8_t>& _data, uint64_t _value) {
+    while (_value >= 0x80) {
+        _data.push_back(uint8_t((_value & 0x7f) | 0x80));
+        _value >>= 7;
+    }
+    _data.push_back(uint8_t(_value));
+}
+
+// Mostly single byte values with some longer ones, like MVT geometry
+static std::vector<uint32_t> randomValues(size_t _count, uint32_t _seed) {
+    std::mt19937 random(_seed);
+    std::vector<uint32_t> values;
+
+    for (size_t i = 0; i < _count; i++) {
+        switch (random() % 8) {
+        case 0: values.push_back(random()); break;
+        case 1: values.push_back(random() % 0x4000); break;
+        default: values.push_back(random() % 0x80);
+        }
+    }
+    values.push_back(0xffffffff);
+    values.push_back(0x80);
+    values.push_back(0x7f);
+    return values;
+}
+
+TEST_CASE( "Bulk varint decoding is the same as decoding one varint at a time", "[Varint]" ) {
+
+    for (uint32_t seed = 0; seed < 20; seed++) {
+        auto values = randomValues(seed * 37, seed);
+
+        std::vector<uint8_t> data;
+        for (auto value : values) { putVarint(data, value); }
+
+        std::vector<uint32_t> bulk;
+        std::vector<uint32_t> scalar;
+        REQUIRE(Varint::decode(data.data(), data.data() + data.size(), bulk));
+        REQUIRE(Varint::decodeScalar(data.data(), data.data() + data.size(), scalar));
+
+        REQUIRE(bulk == values);
+        REQUIRE(scalar == values);
+
+        // Same as the protobuf reader
+        protobuf::message msg(reinterpret_cast<const char*>(data.data()), data.size());
+        for (auto value : values) {
+            int64_t expected = msg.svarint();
+            REQUIRE(int64_t(Varint::zigzag(value)) == expected);
+        }
+    }
+}
+
+TEST_CASE( "Bulk varint decoding rejects values longer than 32 bits", "[Varint]" ) {
+
+    std::vector<uint8_t> data(20, 1);
+    putVarint(data, 0x100000000ull);
+
+    std::vector<uint32_t> out;
+    REQUIRE(!Varint::decode(data.data(), data.data() + data.size(), out));
+    REQUIRE(out.size() == 20);
+
+    // Unterminated
+    data.assign(20, 1);
+    data.push_back(0x80);
+
+    out.clear();
+    REQUIRE(!Varint::decode(data.data(), data.data() + data.size(), out));
+    REQUIRE(!Varint::decodeScalar(data.data(), data.data() + data.size(), out));
+}